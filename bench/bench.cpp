@@ -0,0 +1,109 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+namespace bench {
+
+Runner::Runner(double min_time, const std::vector<std::string>& filters)
+    : min_time(min_time), filters(filters)
+{}
+
+bool Runner::enabled(const std::string& group, const std::string& name) const {
+    if (filters.empty()) {
+        return true;
+    }
+    const std::string full_name = group + "/" + name;
+    for (const std::string& filter : filters) {
+        // Either way round, so that a filter naming one benchmark also enables the setup shared by its group
+        if (full_name.find(filter) != std::string::npos || filter.find(full_name) != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Runner::run(const std::string& group, const std::string& name, std::size_t size, std::size_t items, const std::function<void()>& function) {
+    if (!enabled(group, name)) {
+        return;
+    }
+
+    // One untimed call to warm caches and lazily built tables
+    function();
+
+    std::vector<double> times;
+    double total = 0;
+    while (total < min_time*1e9 || times.size() < 3) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        auto end = std::chrono::steady_clock::now();
+        times.emplace_back(std::chrono::duration<double, std::nano>(end - start).count());
+        total += times.back();
+    }
+
+    Result result;
+    result.group = group;
+    result.name = name;
+    result.size = size;
+    result.items = items;
+    result.iterations = times.size();
+    result.mean_ns = total / times.size();
+    std::sort(times.begin(), times.end());
+    result.median_ns = times[times.size() / 2];
+    result.min_ns = times.front();
+    results.emplace_back(result);
+
+    std::cerr << group << "/" << name;
+    if (size) {
+        std::cerr << " [" << size << "]";
+    }
+    std::cerr << ": " << std::fixed << std::setprecision(3) << result.median_ns / 1e6 << " ms" << std::endl;
+}
+
+void Runner::run(const std::string& group, const std::string& name, std::size_t size, const std::function<void()>& function) {
+    run(group, name, size, 1, function);
+}
+
+void Runner::print(std::ostream& out) const {
+    out << "{\n  \"benchmarks\": [";
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const Result& result = results[i];
+        out << (i ? ",\n" : "\n") << std::fixed << std::setprecision(1)
+            << "    {\"group\": \"" << result.group << "\", \"name\": \"" << result.name << "\""
+            << ", \"size\": " << result.size
+            << ", \"items\": " << result.items
+            << ", \"iterations\": " << result.iterations
+            << ", \"mean_ns\": " << result.mean_ns
+            << ", \"median_ns\": " << result.median_ns
+            << ", \"min_ns\": " << result.min_ns
+            << ", \"items_per_second\": " << result.items * 1e9 / result.median_ns << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+}
+
+// Usage: spark_bench [--min-time=SECONDS] [FILTER...]
+// Progress goes to standard error and the JSON report to standard output
+int main(int argc, char* argv[]) {
+    double min_time = 1.0;
+    std::vector<std::string> filters;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--min-time=", 11) == 0) {
+            min_time = atof(argv[i] + 11);
+        } else {
+            filters.emplace_back(argv[i]);
+        }
+    }
+
+    bench::Runner runner(min_time, filters);
+    bench::primitives(runner);
+    bench::proofs(runner);
+    bench::transactions(runner);
+    runner.print(std::cout);
+    return 0;
+}
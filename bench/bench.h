@@ -0,0 +1,51 @@
+#ifndef FIRO_SPARK_BENCH_H
+#define FIRO_SPARK_BENCH_H
+
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+// Times benchmarks and collects the results, which are printed as JSON so that runs can be compared across releases.
+// A benchmark is named "group/name"; when filters are given, only names containing one of them run.
+class Runner {
+public:
+    Runner(double min_time, const std::vector<std::string>& filters);
+
+    // Whether "group/name" was selected; check this before expensive setup
+    bool enabled(const std::string& group, const std::string& name) const;
+
+    // Calls `function` until at least the minimum time has passed, and records the time per call.
+    // `size` is the benchmark's main parameter (0 if none), and each call processes `items` items
+    void run(const std::string& group, const std::string& name, std::size_t size, std::size_t items, const std::function<void()>& function);
+    void run(const std::string& group, const std::string& name, std::size_t size, const std::function<void()>& function);
+
+    void print(std::ostream& out) const;
+
+private:
+    struct Result {
+        std::string group;
+        std::string name;
+        std::size_t size;
+        std::size_t items;
+        std::size_t iterations;
+        double mean_ns;
+        double median_ns;
+        double min_ns;
+    };
+
+    double min_time;
+    std::vector<std::string> filters;
+    std::vector<Result> results;
+};
+
+void primitives(Runner& runner);
+void proofs(Runner& runner);
+void transactions(Runner& runner);
+
+}
+
+#endif
@@ -0,0 +1,114 @@
+#include "bench.h"
+#include "../src/aead.h"
+#include "../src/params.h"
+#include "../src/util.h"
+#include "../secp256k1/include/MultiExponent.h"
+
+namespace bench {
+
+using namespace spark;
+
+static void group(Runner& runner) {
+    GroupElement point;
+    point.randomize();
+    Scalar scalar;
+    scalar.randomize();
+    runner.run("primitives", "group_mul", 0, [&] {
+        point = point*scalar;
+    });
+
+    const Params* params = Params::get_default();
+    runner.run("primitives", "fixed_base_mul", 0, [&] {
+        point = params->get_F_table().multiply(scalar);
+    });
+
+    runner.run("primitives", "group_add", 0, [&] {
+        point += params->get_G();
+    });
+
+    unsigned char encoding[GroupElement::serialize_size];
+    point.serialize(encoding);
+    runner.run("primitives", "group_deserialize", 0, [&] {
+        point.deserialize(encoding);
+    });
+}
+
+static void multiexponent(Runner& runner) {
+    const std::size_t max_size = 65536;
+    if (!runner.enabled("primitives", "multiexp")) {
+        return;
+    }
+
+    std::vector<GroupElement> points(max_size);
+    std::vector<Scalar> scalars(max_size);
+    for (std::size_t i = 0; i < max_size; i++) {
+        points[i].randomize();
+        scalars[i].randomize();
+    }
+
+    for (std::size_t size = 2; size <= max_size; size *= 2) {
+        MultiExponent multiexp(
+            std::vector<GroupElement>(points.begin(), points.begin() + size),
+            std::vector<Scalar>(scalars.begin(), scalars.begin() + size)
+        );
+        runner.run("primitives", "multiexp", size, size, [&] {
+            multiexp.get_multiple();
+        });
+    }
+}
+
+static void hashing(Runner& runner) {
+    Scalar k;
+    k.randomize();
+    const std::vector<unsigned char> serial_context(32, 1);
+    runner.run("primitives", "hash_ser", 0, [&] {
+        SparkUtils::hash_ser(k, serial_context);
+    });
+
+    runner.run("primitives", "hash_generator", 0, [&] {
+        SparkUtils::hash_generator(LABEL_GENERATOR_F);
+    });
+
+    GroupElement K_der;
+    K_der.randomize();
+    runner.run("primitives", "kdf_aead", 0, [&] {
+        SparkUtils::kdf_aead(K_der);
+    });
+
+    // A payload the size of a mint coin's private data
+    const std::size_t size = 8 + 16 + 32 + 32 + 32;
+    std::vector<unsigned char> payload(size, 7);
+    std::vector<unsigned char> plaintext(size);
+    AEADEngine engine("Associated data");
+    AEADEncryptedData data;
+    runner.run("primitives", "aead_encrypt", size, [&] {
+        engine.encrypt(K_der, payload.data(), payload.size(), data);
+    });
+    runner.run("primitives", "aead_decrypt", size, [&] {
+        if (!engine.decrypt(K_der, data, plaintext.data())) {
+            throw std::runtime_error("AEAD decryption failed");
+        }
+    });
+}
+
+static void randomness(Runner& runner) {
+    Scalar scalar;
+    runner.run("primitives", "scalar_randomize", 0, [&] {
+        scalar.randomize();
+    });
+
+    // As many masks as a Grootle proof with the default parameters draws
+    std::vector<Scalar> masks(8*5);
+    runner.run("primitives", "scalar_randomize_bulk", masks.size(), masks.size(), [&] {
+        RandomGenerator::get().randomize(masks);
+    });
+}
+
+void primitives(Runner& runner) {
+    group(runner);
+    randomness(runner);
+    multiexponent(runner);
+    hashing(runner);
+}
+
+}
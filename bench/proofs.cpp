@@ -0,0 +1,169 @@
+#include "bench.h"
+#include "../src/bpplus.h"
+#include "../src/chaum.h"
+#include "../src/grootle.h"
+#include "../src/params.h"
+#include "../src/schnorr.h"
+
+namespace bench {
+
+using namespace spark;
+
+// Proofs at the deployed parameters, using their generators
+static void grootle(Runner& runner) {
+    if (!runner.enabled("proofs", "grootle")) {
+        return;
+    }
+
+    const Params* params = Params::get_default();
+    const std::size_t n = params->get_n_grootle();
+    const std::size_t m = params->get_m_grootle();
+    std::size_t N = 1;
+    for (std::size_t j = 0; j < m; j++) {
+        N *= n;
+    }
+
+    // A full cover set, with a commitment to zero for each proof in the largest batch
+    const std::size_t max_batch = 16;
+    std::vector<GroupElement> S(N), V(N);
+    for (std::size_t i = 0; i < N; i++) {
+        S[i].randomize();
+        V[i].randomize();
+    }
+    std::vector<GroupElement> S1, V1;
+    std::vector<Scalar> s, v;
+    std::vector<std::vector<unsigned char>> roots;
+    std::vector<std::size_t> sizes(max_batch, N);
+    for (std::size_t i = 0; i < max_batch; i++) {
+        s.emplace_back();
+        s.back().randomize();
+        v.emplace_back();
+        v.back().randomize();
+        S1.emplace_back(S[i]);
+        V1.emplace_back(V[i]);
+        S[i] += params->get_H()*s.back();
+        V[i] += params->get_H()*v.back();
+        roots.emplace_back(32, i);
+    }
+
+    Grootle grootle(params->get_H(), params->get_G_grootle(), params->get_H_grootle(), n, m);
+    std::vector<GrootleProof> proofs(max_batch);
+    for (std::size_t i = 0; i < max_batch; i++) {
+        grootle.prove(i, s[i], S, S1[i], v[i], V, V1[i], roots[i], proofs[i]);
+    }
+
+    // Proofs are built into fresh objects, since proving appends to them
+    runner.run("proofs", "grootle_prove", N, [&] {
+        GrootleProof proof;
+        grootle.prove(0, s[0], S, S1[0], v[0], V, V1[0], roots[0], proof);
+    });
+
+    for (std::size_t batch = 1; batch <= max_batch; batch *= 2) {
+        std::vector<GroupElement> batch_S1(S1.begin(), S1.begin() + batch);
+        std::vector<GroupElement> batch_V1(V1.begin(), V1.begin() + batch);
+        std::vector<std::vector<unsigned char>> batch_roots(roots.begin(), roots.begin() + batch);
+        std::vector<std::size_t> batch_sizes(sizes.begin(), sizes.begin() + batch);
+        std::vector<GrootleProof> batch_proofs(proofs.begin(), proofs.begin() + batch);
+        runner.run("proofs", "grootle_verify", batch, batch, [&] {
+            if (!grootle.verify(S, batch_S1, V, batch_V1, batch_roots, batch_sizes, batch_proofs)) {
+                throw std::runtime_error("Grootle verification failed");
+            }
+        });
+    }
+}
+
+static void bpplus(Runner& runner) {
+    if (!runner.enabled("proofs", "bpplus")) {
+        return;
+    }
+
+    const Params* params = Params::get_default();
+    const std::size_t N = 64;
+    BPPlus bpplus(params->get_G(), params->get_H(), params->get_G_range(), params->get_H_range(), N);
+
+    for (std::size_t M = 1; M <= params->get_max_M_range(); M *= 2) {
+        std::vector<Scalar> v(M), r(M);
+        std::vector<GroupElement> C(M);
+        for (std::size_t j = 0; j < M; j++) {
+            v[j] = Scalar(uint64_t(1000 + j));
+            r[j].randomize();
+            C[j] = params->get_G()*v[j] + params->get_H()*r[j];
+        }
+
+        runner.run("proofs", "bpplus_prove", M, [&] {
+            BPPlusProof proof;
+            bpplus.prove(v, r, C, proof);
+        });
+        BPPlusProof proof;
+        bpplus.prove(v, r, C, proof);
+        runner.run("proofs", "bpplus_verify", M, [&] {
+            if (!bpplus.verify(C, proof)) {
+                throw std::runtime_error("BPPlus verification failed");
+            }
+        });
+    }
+}
+
+static void chaum(Runner& runner) {
+    if (!runner.enabled("proofs", "chaum")) {
+        return;
+    }
+
+    const Params* params = Params::get_default();
+    Chaum chaum(params->get_F(), params->get_G(), params->get_H(), params->get_U());
+
+    for (std::size_t n : { std::size_t(1), std::size_t(8) }) {
+        Scalar mu;
+        mu.randomize();
+        std::vector<Scalar> x(n), y(n), z(n);
+        std::vector<GroupElement> S(n), T(n);
+        for (std::size_t i = 0; i < n; i++) {
+            x[i].randomize();
+            y[i].randomize();
+            z[i].randomize();
+            S[i] = params->get_F()*x[i] + params->get_G()*y[i] + params->get_H()*z[i];
+            T[i] = (params->get_U() + params->get_G()*y[i].negate())*x[i].inverse();
+        }
+
+        runner.run("proofs", "chaum_prove", n, [&] {
+            ChaumProof proof;
+            chaum.prove(mu, x, y, z, S, T, proof);
+        });
+        ChaumProof proof;
+        chaum.prove(mu, x, y, z, S, T, proof);
+        runner.run("proofs", "chaum_verify", n, [&] {
+            if (!chaum.verify(mu, S, T, proof)) {
+                throw std::runtime_error("Chaum verification failed");
+            }
+        });
+    }
+}
+
+static void schnorr(Runner& runner) {
+    const Params* params = Params::get_default();
+    Schnorr schnorr(params->get_G());
+    Scalar y;
+    y.randomize();
+    GroupElement Y = params->get_G()*y;
+
+    runner.run("proofs", "schnorr_prove", 0, [&] {
+        SchnorrProof proof;
+        schnorr.prove(y, Y, proof);
+    });
+    SchnorrProof proof;
+    schnorr.prove(y, Y, proof);
+    runner.run("proofs", "schnorr_verify", 0, [&] {
+        if (!schnorr.verify(Y, proof)) {
+            throw std::runtime_error("Schnorr verification failed");
+        }
+    });
+}
+
+void proofs(Runner& runner) {
+    grootle(runner);
+    bpplus(runner);
+    chaum(runner);
+    schnorr(runner);
+}
+
+}
@@ -0,0 +1,148 @@
+#include "bench.h"
+#include "../src/mint_transaction.h"
+#include "../src/spend_transaction.h"
+
+namespace bench {
+
+using namespace spark;
+
+static const int PROTOCOL_VERSION = 90031;
+
+static std::vector<unsigned char> random_char_vector() {
+    Scalar temp;
+    temp.randomize();
+    std::vector<unsigned char> result(SCALAR_ENCODING);
+    temp.serialize(result.data());
+    return result;
+}
+
+static void mint(Runner& runner) {
+    if (!runner.enabled("transactions", "mint")) {
+        return;
+    }
+
+    const Params* params = Params::get_default();
+    SpendKey spend_key(params);
+    FullViewKey full_view_key(spend_key);
+    IncomingViewKey incoming_view_key(full_view_key);
+
+    std::vector<MintedCoinData> outputs(1);
+    outputs[0].address = Address(incoming_view_key, 1);
+    outputs[0].v = 100;
+    outputs[0].memo = "Spam and eggs";
+    const std::vector<unsigned char> serial_context = random_char_vector();
+
+    runner.run("transactions", "mint_build", 1, [&] {
+        MintTransaction(params, outputs, serial_context);
+    });
+    MintTransaction transaction(params, outputs, serial_context);
+    runner.run("transactions", "mint_verify", 1, [&] {
+        if (!transaction.verify()) {
+            throw std::runtime_error("Mint verification failed");
+        }
+    });
+}
+
+// Spends from a cover set of mints to one address, at the deployed parameters
+static void spend(Runner& runner) {
+    if (!runner.enabled("transactions", "spend")) {
+        return;
+    }
+
+    const Params* params = Params::get_default();
+    SpendKey spend_key(params);
+    FullViewKey full_view_key(spend_key);
+    IncomingViewKey incoming_view_key(full_view_key);
+    Address address(incoming_view_key, 1);
+
+    const std::size_t set_size = 1024;
+    const uint64_t cover_set_id = 1;
+    std::vector<Coin> coins;
+    for (std::size_t i = 0; i < set_size; i++) {
+        Scalar k;
+        k.randomize();
+        coins.emplace_back(params, COIN_TYPE_MINT, k, address, 1000, "", random_char_vector());
+    }
+    std::unordered_map<uint64_t, CoverSetData> cover_set_data;
+    cover_set_data[cover_set_id].cover_set = coins;
+    cover_set_data[cover_set_id].cover_set_representation = random_char_vector();
+    std::unordered_map<uint64_t, std::vector<Coin>> cover_sets;
+    cover_sets[cover_set_id] = coins;
+
+    for (std::size_t w : { std::size_t(1), std::size_t(2) }) {
+        std::vector<InputCoinData> inputs;
+        for (std::size_t u = 0; u < w; u++) {
+            IdentifiedCoinData identified = coins[u].identify(incoming_view_key);
+            RecoveredCoinData recovered = coins[u].recover(full_view_key, identified);
+            inputs.emplace_back();
+            inputs.back().cover_set_id = cover_set_id;
+            inputs.back().index = u;
+            inputs.back().k = identified.k;
+            inputs.back().s = recovered.s;
+            inputs.back().T = recovered.T;
+            inputs.back().v = identified.v;
+        }
+
+        std::vector<OutputCoinData> outputs(1);
+        outputs[0].address = address;
+        outputs[0].v = 500;
+        outputs[0].memo = "";
+        const uint64_t f = 1000*w - outputs[0].v;
+
+        runner.run("transactions", "spend_build", w, [&] {
+            SpendTransaction(params, full_view_key, spend_key, inputs, cover_set_data, f, 0, outputs);
+        });
+
+        SpendTransaction transaction(params, full_view_key, spend_key, inputs, cover_set_data, f, 0, outputs);
+        transaction.setCoverSets(cover_set_data);
+        runner.run("transactions", "spend_verify", w, [&] {
+            if (!SpendTransaction::verify(transaction, cover_sets)) {
+                throw std::runtime_error("Spend verification failed");
+            }
+        });
+    }
+}
+
+// Scanning serialized coins with a key that owns none of them, as a wallet does for most of the chain
+static void scan(Runner& runner) {
+    if (!runner.enabled("transactions", "identify")) {
+        return;
+    }
+
+    const Params* params = Params::get_default();
+    SpendKey spend_key(params);
+    FullViewKey full_view_key(spend_key);
+    IncomingViewKey incoming_view_key(full_view_key);
+    IncomingViewKey other_incoming_view_key((FullViewKey(SpendKey(params))));
+    Address other_address(other_incoming_view_key, 1);
+
+    const std::size_t count = 256;
+    const std::vector<unsigned char> serial_context = random_char_vector();
+    std::vector<std::vector<unsigned char>> serialized;
+    for (std::size_t i = 0; i < count; i++) {
+        Scalar k;
+        k.randomize();
+        Coin coin(params, COIN_TYPE_MINT, k, other_address, 1000, "", serial_context);
+        CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+        stream << coin;
+        serialized.emplace_back(stream.begin(), stream.end());
+    }
+
+    runner.run("transactions", "identify_scan", count, count, [&] {
+        IdentifiedCoinData data;
+        for (const std::vector<unsigned char>& coin : serialized) {
+            CoinView view(params, coin.data(), coin.size());
+            if (view.identify(incoming_view_key, serial_context, data)) {
+                throw std::runtime_error("Identified a coin of another key");
+            }
+        }
+    });
+}
+
+void transactions(Runner& runner) {
+    mint(runner);
+    spend(runner);
+    scan(runner);
+}
+
+}
@@ -12,6 +12,29 @@ extern "C" {
 #include "ctaes/ctaes.c"
 }
 
+namespace aes_ni
+{
+bool Available();
+void Init256(unsigned char rk[240], const unsigned char key[32]);
+void InvertSchedule256(unsigned char dk[240], const unsigned char rk[240]);
+void Encrypt256(const unsigned char rk[240], size_t blocks, unsigned char* cipher16, const unsigned char* plain16);
+void Decrypt256(const unsigned char dk[240], size_t blocks, unsigned char* plain16, const unsigned char* cipher16);
+}
+
+namespace
+{
+bool UseAESNI()
+{
+    static const bool available = aes_ni::Available();
+    return available;
+}
+} // namespace
+
+std::string AES256Implementation()
+{
+    return UseAESNI() ? "aes-ni" : "ctaes";
+}
+
 AES128Encrypt::AES128Encrypt(const unsigned char key[16])
 {
     AES128_init(&ctx, key);
@@ -42,34 +65,69 @@ void AES128Decrypt::Decrypt(unsigned char plaintext[16], const unsigned char cip
     AES128_decrypt(&ctx, 1, plaintext, ciphertext);
 }
 
-AES256Encrypt::AES256Encrypt(const unsigned char key[32])
+AES256Encrypt::AES256Encrypt(const unsigned char key[32]) : hw(UseAESNI())
 {
-    AES256_init(&ctx, key);
+    if (hw) {
+        memset(&ctx, 0, sizeof(ctx));
+        aes_ni::Init256(rk, key);
+    } else {
+        AES256_init(&ctx, key);
+        memset(rk, 0, sizeof(rk));
+    }
 }
 
 AES256Encrypt::~AES256Encrypt()
 {
     memset(&ctx, 0, sizeof(ctx));
+    memset(rk, 0, sizeof(rk));
 }
 
 void AES256Encrypt::Encrypt(unsigned char ciphertext[16], const unsigned char plaintext[16]) const
 {
-    AES256_encrypt(&ctx, 1, ciphertext, plaintext);
+    Encrypt(ciphertext, plaintext, 1);
+}
+
+void AES256Encrypt::Encrypt(unsigned char* ciphertext, const unsigned char* plaintext, size_t blocks) const
+{
+    if (hw) {
+        aes_ni::Encrypt256(rk, blocks, ciphertext, plaintext);
+    } else {
+        AES256_encrypt(&ctx, blocks, ciphertext, plaintext);
+    }
 }
 
-AES256Decrypt::AES256Decrypt(const unsigned char key[32])
+AES256Decrypt::AES256Decrypt(const unsigned char key[32]) : hw(UseAESNI())
 {
-    AES256_init(&ctx, key);
+    if (hw) {
+        memset(&ctx, 0, sizeof(ctx));
+        unsigned char enc[240];
+        aes_ni::Init256(enc, key);
+        aes_ni::InvertSchedule256(rk, enc);
+        memset(enc, 0, sizeof(enc));
+    } else {
+        AES256_init(&ctx, key);
+        memset(rk, 0, sizeof(rk));
+    }
 }
 
 AES256Decrypt::~AES256Decrypt()
 {
     memset(&ctx, 0, sizeof(ctx));
+    memset(rk, 0, sizeof(rk));
 }
 
 void AES256Decrypt::Decrypt(unsigned char plaintext[16], const unsigned char ciphertext[16]) const
 {
-    AES256_decrypt(&ctx, 1, plaintext, ciphertext);
+    Decrypt(plaintext, ciphertext, 1);
+}
+
+void AES256Decrypt::Decrypt(unsigned char* plaintext, const unsigned char* ciphertext, size_t blocks) const
+{
+    if (hw) {
+        aes_ni::Decrypt256(rk, blocks, plaintext, ciphertext);
+    } else {
+        AES256_decrypt(&ctx, blocks, plaintext, ciphertext);
+    }
 }
 
 
@@ -2,7 +2,8 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 //
-// C++ wrapper around ctaes, a constant-time AES implementation
+// C++ wrapper around ctaes, a constant-time AES implementation.
+// AES-256 uses the AES-NI instructions instead when the CPU supports them.
 
 #ifndef BITCOIN_CRYPTO_AES_H
 #define BITCOIN_CRYPTO_AES_H
@@ -11,6 +12,8 @@ extern "C" {
 #include "ctaes/ctaes.h"
 }
 
+#include <string>
+
 static const int AES_BLOCKSIZE = 16;
 static const int AES128_KEYSIZE = 16;
 static const int AES256_KEYSIZE = 32;
@@ -44,11 +47,15 @@ class AES256Encrypt
 {
 private:
     AES256_ctx ctx;
+    unsigned char rk[240];
+    bool hw;
 
 public:
     AES256Encrypt(const unsigned char key[32]);
     ~AES256Encrypt();
     void Encrypt(unsigned char ciphertext[16], const unsigned char plaintext[16]) const;
+    /** Encrypt independent 16-byte blocks (ECB); faster than one call per block. */
+    void Encrypt(unsigned char* ciphertext, const unsigned char* plaintext, size_t blocks) const;
 };
 
 /** A decryption class for AES-256. */
@@ -56,13 +63,20 @@ class AES256Decrypt
 {
 private:
     AES256_ctx ctx;
+    unsigned char rk[240];
+    bool hw;
 
 public:
     AES256Decrypt(const unsigned char key[32]);
     ~AES256Decrypt();
     void Decrypt(unsigned char plaintext[16], const unsigned char ciphertext[16]) const;
+    /** Decrypt independent 16-byte blocks (ECB); faster than one call per block. */
+    void Decrypt(unsigned char* plaintext, const unsigned char* ciphertext, size_t blocks) const;
 };
 
+/** Returns the name of the AES-256 implementation in use ("aes-ni" or "ctaes"). */
+std::string AES256Implementation();
+
 class AES256CBCEncrypt
 {
 public:
@@ -0,0 +1,155 @@
+// AES-256 using the AES-NI instructions. Only used when the CPU reports support at runtime.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if (defined(__x86_64__) || defined(__amd64__)) && defined(__GNUC__)
+#include <cpuid.h>
+#include <wmmintrin.h>
+#include <emmintrin.h>
+
+#define AES_NI_TARGET __attribute__((target("aes,sse2")))
+
+namespace aes_ni
+{
+namespace
+{
+AES_NI_TARGET inline __m128i Expand(__m128i k, __m128i t)
+{
+    k = _mm_xor_si128(k, _mm_slli_si128(k, 4));
+    k = _mm_xor_si128(k, _mm_slli_si128(k, 4));
+    k = _mm_xor_si128(k, _mm_slli_si128(k, 4));
+    return _mm_xor_si128(k, t);
+}
+
+AES_NI_TARGET inline void Store(unsigned char* rk, int round, __m128i k)
+{
+    _mm_storeu_si128((__m128i*)(rk + 16 * round), k);
+}
+
+AES_NI_TARGET inline __m128i Load(const unsigned char* rk, int round)
+{
+    return _mm_loadu_si128((const __m128i*)(rk + 16 * round));
+}
+} // namespace
+
+bool Available()
+{
+    uint32_t eax, ebx, ecx, edx;
+    return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx >> 25) & 1;
+}
+
+#define AES_NI_EXPAND_PAIR(round, rcon)                                                          \
+    k0 = Expand(k0, _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k1, rcon), 0xff));               \
+    Store(rk, round, k0);                                                                        \
+    k1 = Expand(k1, _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k0, 0x00), 0xaa));               \
+    Store(rk, round + 1, k1);
+
+AES_NI_TARGET void Init256(unsigned char rk[240], const unsigned char key[32])
+{
+    __m128i k0 = _mm_loadu_si128((const __m128i*)key);
+    __m128i k1 = _mm_loadu_si128((const __m128i*)(key + 16));
+    Store(rk, 0, k0);
+    Store(rk, 1, k1);
+    AES_NI_EXPAND_PAIR(2, 0x01)
+    AES_NI_EXPAND_PAIR(4, 0x02)
+    AES_NI_EXPAND_PAIR(6, 0x04)
+    AES_NI_EXPAND_PAIR(8, 0x08)
+    AES_NI_EXPAND_PAIR(10, 0x10)
+    AES_NI_EXPAND_PAIR(12, 0x20)
+    k0 = Expand(k0, _mm_shuffle_epi32(_mm_aeskeygenassist_si128(k1, 0x40), 0xff));
+    Store(rk, 14, k0);
+}
+
+#undef AES_NI_EXPAND_PAIR
+
+AES_NI_TARGET void InvertSchedule256(unsigned char dk[240], const unsigned char rk[240])
+{
+    Store(dk, 0, Load(rk, 14));
+    for (int i = 1; i < 14; i++) {
+        Store(dk, i, _mm_aesimc_si128(Load(rk, 14 - i)));
+    }
+    Store(dk, 14, Load(rk, 0));
+}
+
+// Blocks are independent, so process four at a time to hide the latency of the round instructions
+AES_NI_TARGET void Encrypt256(const unsigned char rk[240], size_t blocks, unsigned char* cipher16, const unsigned char* plain16)
+{
+    __m128i k[15];
+    for (int i = 0; i < 15; i++) k[i] = Load(rk, i);
+
+    while (blocks >= 4) {
+        __m128i b0 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)plain16), k[0]);
+        __m128i b1 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(plain16 + 16)), k[0]);
+        __m128i b2 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(plain16 + 32)), k[0]);
+        __m128i b3 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(plain16 + 48)), k[0]);
+        for (int i = 1; i < 14; i++) {
+            b0 = _mm_aesenc_si128(b0, k[i]);
+            b1 = _mm_aesenc_si128(b1, k[i]);
+            b2 = _mm_aesenc_si128(b2, k[i]);
+            b3 = _mm_aesenc_si128(b3, k[i]);
+        }
+        _mm_storeu_si128((__m128i*)cipher16, _mm_aesenclast_si128(b0, k[14]));
+        _mm_storeu_si128((__m128i*)(cipher16 + 16), _mm_aesenclast_si128(b1, k[14]));
+        _mm_storeu_si128((__m128i*)(cipher16 + 32), _mm_aesenclast_si128(b2, k[14]));
+        _mm_storeu_si128((__m128i*)(cipher16 + 48), _mm_aesenclast_si128(b3, k[14]));
+        blocks -= 4;
+        plain16 += 64;
+        cipher16 += 64;
+    }
+    while (blocks--) {
+        __m128i b = _mm_xor_si128(_mm_loadu_si128((const __m128i*)plain16), k[0]);
+        for (int i = 1; i < 14; i++) b = _mm_aesenc_si128(b, k[i]);
+        _mm_storeu_si128((__m128i*)cipher16, _mm_aesenclast_si128(b, k[14]));
+        plain16 += 16;
+        cipher16 += 16;
+    }
+}
+
+AES_NI_TARGET void Decrypt256(const unsigned char dk[240], size_t blocks, unsigned char* plain16, const unsigned char* cipher16)
+{
+    __m128i k[15];
+    for (int i = 0; i < 15; i++) k[i] = Load(dk, i);
+
+    while (blocks >= 4) {
+        __m128i b0 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)cipher16), k[0]);
+        __m128i b1 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(cipher16 + 16)), k[0]);
+        __m128i b2 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(cipher16 + 32)), k[0]);
+        __m128i b3 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(cipher16 + 48)), k[0]);
+        for (int i = 1; i < 14; i++) {
+            b0 = _mm_aesdec_si128(b0, k[i]);
+            b1 = _mm_aesdec_si128(b1, k[i]);
+            b2 = _mm_aesdec_si128(b2, k[i]);
+            b3 = _mm_aesdec_si128(b3, k[i]);
+        }
+        _mm_storeu_si128((__m128i*)plain16, _mm_aesdeclast_si128(b0, k[14]));
+        _mm_storeu_si128((__m128i*)(plain16 + 16), _mm_aesdeclast_si128(b1, k[14]));
+        _mm_storeu_si128((__m128i*)(plain16 + 32), _mm_aesdeclast_si128(b2, k[14]));
+        _mm_storeu_si128((__m128i*)(plain16 + 48), _mm_aesdeclast_si128(b3, k[14]));
+        blocks -= 4;
+        cipher16 += 64;
+        plain16 += 64;
+    }
+    while (blocks--) {
+        __m128i b = _mm_xor_si128(_mm_loadu_si128((const __m128i*)cipher16), k[0]);
+        for (int i = 1; i < 14; i++) b = _mm_aesdec_si128(b, k[i]);
+        _mm_storeu_si128((__m128i*)plain16, _mm_aesdeclast_si128(b, k[14]));
+        cipher16 += 16;
+        plain16 += 16;
+    }
+}
+
+} // namespace aes_ni
+
+#else
+
+namespace aes_ni
+{
+bool Available() { return false; }
+void Init256(unsigned char rk[240], const unsigned char key[32]) {}
+void InvertSchedule256(unsigned char dk[240], const unsigned char rk[240]) {}
+void Encrypt256(const unsigned char rk[240], size_t blocks, unsigned char* cipher16, const unsigned char* plain16) {}
+void Decrypt256(const unsigned char dk[240], size_t blocks, unsigned char* plain16, const unsigned char* cipher16) {}
+} // namespace aes_ni
+
+#endif
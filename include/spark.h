@@ -68,13 +68,30 @@ void createSparkSpendTransaction(
         const spark::IncomingViewKey& incomingViewKey,
         const std::vector<std::pair<CAmount, bool>>& recipients,
         const std::vector<std::pair<spark::OutputCoinData, bool>>& privateRecipients,
-        std::list<CSparkMintMeta> coins,
-        const std::unordered_map<uint64_t, spark::CoverSetData> cover_set_data_all,
+        const std::list<CSparkMintMeta>& coins,
+        const std::unordered_map<uint64_t, spark::CoverSetData>& cover_set_data_all,
         const std::map<uint64_t, uint256>& idAndBlockHashes_all,
         const uint256& txHashSig,
         CAmount &fee,
         std::vector<uint8_t>& serializedSpend,
-        std::vector<std::vector<unsigned char>>& outputScripts);
+        std::vector<std::vector<unsigned char>>& outputScripts,
+        secp_primitives::Executor& executor = secp_primitives::Executor::get_default());
+
+// Same, with cover sets shared through a store; only the sets the selected inputs need are used, and none are copied
+void createSparkSpendTransaction(
+        const spark::SpendKey& spendKey,
+        const spark::FullViewKey& fullViewKey,
+        const spark::IncomingViewKey& incomingViewKey,
+        const std::vector<std::pair<CAmount, bool>>& recipients,
+        const std::vector<std::pair<spark::OutputCoinData, bool>>& privateRecipients,
+        const std::list<CSparkMintMeta>& coins,
+        const spark::CoverSetStore& cover_sets,
+        const std::map<uint64_t, uint256>& idAndBlockHashes_all,
+        const uint256& txHashSig,
+        CAmount &fee,
+        std::vector<uint8_t>& serializedSpend,
+        std::vector<std::vector<unsigned char>>& outputScripts,
+        secp_primitives::Executor& executor = secp_primitives::Executor::get_default());
 
 
 #endif // SPARK_H
\ No newline at end of file
@@ -0,0 +1,88 @@
+#ifndef SECP_EXECUTOR_H
+#define SECP_EXECUTOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace secp_primitives {
+
+// Runs batches of independent tasks for everything in the library that can work in parallel.
+// Callers pass an executor explicitly or use the process-wide default, which runs tasks inline on the calling thread
+// until the embedder installs another one, e.g. a ThreadPool sized to its thread budget.
+class Executor {
+public:
+    virtual ~Executor();
+
+    // How many tasks may run at once, which callers use to decide how finely to split work
+    virtual std::size_t concurrency() const = 0;
+
+    // Runs every task and returns once all have finished; if any failed, the failure of the earliest one is rethrown.
+    // Tasks may run nested batches on the same executor.
+    virtual void run(const std::vector<std::function<void()>>& tasks) = 0;
+
+    // Shared executor running tasks inline
+    static Executor& serial();
+
+    // Install the default before starting work that uses it: a replaced default is kept alive, but work already
+    // running on it is not moved to the new one
+    static Executor& get_default();
+    static void set_default(const std::shared_ptr<Executor>& executor);
+};
+
+// Runs tasks one after another on the calling thread
+class SerialExecutor final : public Executor {
+public:
+    std::size_t concurrency() const override;
+    void run(const std::vector<std::function<void()>>& tasks) override;
+};
+
+// Runs tasks on `threads` threads (one per core if 0): the thread running a batch and `threads - 1` workers.
+// Every worker has its own queue and steals from the others when it runs out. A thread waiting for its batch works on
+// queued tasks instead of blocking, so nested batches cannot exhaust the pool.
+class ThreadPool final : public Executor {
+public:
+    explicit ThreadPool(std::size_t threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool& other) = delete;
+    ThreadPool& operator=(const ThreadPool& other) = delete;
+
+    std::size_t concurrency() const override;
+    void run(const std::vector<std::function<void()>>& tasks) override;
+
+private:
+    struct Batch;
+    struct Task {
+        Batch* batch;
+        std::size_t index;
+    };
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    bool take(std::size_t queue, Task& task);
+    void execute(const Task& task);
+    void work(std::size_t queue);
+
+    std::size_t threads;
+    // One queue per worker, and a last one for batches run from other threads
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable available;
+    std::atomic<std::size_t> queued;
+    bool stopping;
+};
+
+}// namespace secp_primitives
+
+#endif //SECP_EXECUTOR_H
@@ -0,0 +1,53 @@
+#ifndef SECP_FIXED_BASE_TABLE_H
+#define SECP_FIXED_BASE_TABLE_H
+
+#include "../include/GroupElement.h"
+#include "../include/Scalar.h"
+
+#include <vector>
+
+namespace secp_primitives {
+
+// Precomputed multiples of a fixed base point, for repeated multiplication by the same generator.
+// The scalar is split into windows of `window_bits` bits, and every window holds all of its nonzero multiples,
+// so a multiplication costs one mixed addition per window and no doublings.
+// Like GroupElement::operator*, this is not constant time.
+class FixedBaseTable final {
+public:
+    static constexpr unsigned int default_window_bits = 4;
+
+    FixedBaseTable(const GroupElement& base, unsigned int window_bits = default_window_bits);
+    // Uses a table written earlier from data(), e.g. a mapped file, without copying it; it must outlive this object.
+    // The layout is platform specific, so a table that does not start with `base` throws std::invalid_argument
+    FixedBaseTable(const GroupElement& base, unsigned int window_bits, const void* table);
+    ~FixedBaseTable();
+
+    FixedBaseTable(const FixedBaseTable& other) = delete;
+    FixedBaseTable& operator=(const FixedBaseTable& other) = delete;
+
+    GroupElement multiply(const Scalar& multiplier) const;
+
+    const GroupElement& get_base() const;
+    unsigned int get_window_bits() const;
+    // The table itself, memoryRequired() bytes
+    const void* data() const;
+    std::size_t memoryRequired() const;
+
+    static std::size_t memoryRequired(unsigned int window_bits);
+    // The widest window whose table fits in `memory` bytes, and at least 1
+    static unsigned int window_bits_for(std::size_t memory);
+    // Identifies the native table layout: byte order, field representation and point storage format.
+    // A table written where this differs cannot be used here
+    static std::vector<unsigned char> layout_tag();
+
+private:
+    GroupElement base_;
+    unsigned int window_bits_;
+    unsigned int windows_;
+    void *table_; // secp256k1_ge_storage[]
+    bool owned_;
+};
+
+}// namespace secp_primitives
+
+#endif //SECP_FIXED_BASE_TABLE_H
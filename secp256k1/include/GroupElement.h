@@ -1,6 +1,7 @@
 #ifndef SECP_GROUP_ELEMENT_H__
 #define SECP_GROUP_ELEMENT_H__
 
+#include "Executor.h"
 #include "Scalar.h"
 
 #include <cstddef>
@@ -16,6 +17,7 @@ namespace secp_primitives {
 class GroupElement final {
 public:
     static constexpr std::size_t serialize_size = 34;
+    static constexpr std::size_t affine_size = 64;
 
 public:
 
@@ -53,6 +55,7 @@ public:
   bool isInfinity() const;
 
 
+  // Compares by cross-multiplication of the coordinates, without inverting either side
   bool operator==(const GroupElement&other) const;
 
   bool operator!=(const GroupElement&other) const;
@@ -81,6 +84,34 @@ public:
   // it accepts infinity point, handle it based on your use case
   unsigned const char* deserialize(unsigned const char* buffer);
 
+  // Uncompressed affine encoding x || y (32 bytes each, big-endian), with all zeros for infinity.
+  // Reading it needs no square root, which makes it suitable for large in-memory point sets
+  unsigned char* serialize_affine(unsigned char* buffer) const;
+  unsigned const char* deserialize_affine(unsigned const char* buffer);
+  // Encodes many points with a single field inversion
+  static void serialize_affine(const std::vector<GroupElement>& points, unsigned char* buffer);
+
+  // Stores the serialized point and defers decompression and the validity check until the point is first used,
+  // at which point an invalid encoding throws std::invalid_argument
+  unsigned const char* deserialize_lazy(unsigned const char* buffer);
+  bool isDecompressed() const;
+
+  // Decompresses every deferred point, splitting the work between the executor's threads.
+  // If any encoding is invalid, throws std::invalid_argument naming the lowest such index,
+  // so the result does not depend on scheduling
+  static void decompress_all(const std::vector<GroupElement*>& points, Executor& executor = Executor::get_default());
+
+  // While an instance is alive, Unserialize on the current thread defers decompression (see deserialize_lazy)
+  class LazyDeserialization final {
+  public:
+      LazyDeserialization();
+      ~LazyDeserialization();
+
+      LazyDeserialization(const LazyDeserialization&) = delete;
+      LazyDeserialization& operator=(const LazyDeserialization&) = delete;
+  };
+  static bool lazy_deserialization();
+
   // These functions are for READWRITE() in serialize.h
   template<typename Stream>
   inline void Serialize(Stream& s) const {
@@ -97,7 +128,11 @@ public:
         unsigned char buffer[size];
         char* b = (char*)buffer;
         s.read(b, size);
-        deserialize(buffer);
+        if (lazy_deserialization()) {
+            deserialize_lazy(buffer);
+        } else {
+            deserialize(buffer);
+        }
   }
 
   //function name like in CBignum
@@ -110,14 +145,20 @@ public:
   GroupElement& set_base_g();
 
   friend class MultiExponent;
+  friend class FixedBaseTable;
 private:
     // Returns the secp object inside it.
     const void * get_value() const;
 
+    // Writes the affine forms of `count` points to `result` (secp256k1_ge[]), reusing cached ones
+    // and finding the rest with a single inversion
+    static void get_affine(const GroupElement* points, std::size_t count, void* result);
+
     GroupElement(const void *g);
 
 private:
-    void *g_; // secp256k1_gej
+    void *g_; // secp256k1_gej, plus the serialized point while decompression is deferred
+              // and the affine form once computed, which serialization, hashing and isMember() reuse until the point changes
 
 };
 
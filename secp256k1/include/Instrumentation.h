@@ -0,0 +1,111 @@
+#ifndef SECP_INSTRUMENTATION_H
+#define SECP_INSTRUMENTATION_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace secp_primitives {
+
+// Operation counters and stage timers for finding where verification and proving time goes.
+// They are only updated by code built with SPARK_INSTRUMENTATION defined; otherwise the SPARK_COUNT and SPARK_TIME_STAGE
+// macros expand to nothing, so there is no cost. The totals are process-wide and safe to update from any thread.
+// Include this header after any config header that may define SPARK_INSTRUMENTATION.
+namespace instrumentation {
+
+enum Counter {
+    SCALAR_MULTIPLICATIONS, // variable- and fixed-base, outside multiexponentiation
+    MULTIEXPONENTIATIONS,
+    MULTIEXPONENTIATION_POINTS,
+    INVERSIONS, // scalar inversions and field inversions made to normalize points
+    HASH_BYTES, // absorbed by transcripts, hash functions and KDFs
+    HASH_FINALIZATIONS,
+    ALLOCATIONS, // heap allocations for points, scalars, multiexponentiation buffers and tables
+    COUNTER_COUNT
+};
+
+enum Stage {
+    SPEND_SERIALIZATION, // reading or writing a spend transaction, which is where parsing time shows up
+    SPEND_VERIFY,
+    SPEND_VERIFY_CHAUM,
+    SPEND_VERIFY_BALANCE,
+    SPEND_VERIFY_RANGE,
+    SPEND_VERIFY_MEMBERSHIP,
+    GROOTLE_PROVE,
+    GROOTLE_VERIFY,
+    BPPLUS_PROVE,
+    BPPLUS_VERIFY,
+    COIN_IDENTIFY,
+    STAGE_COUNT
+};
+
+struct StageTime {
+    uint64_t calls;
+    uint64_t nanoseconds; // nested stages are also included in the stages around them
+};
+
+struct Snapshot {
+    uint64_t counters[COUNTER_COUNT];
+    StageTime stages[STAGE_COUNT];
+
+    // SHA-512 works on 128-byte blocks, and finishing a hash takes one more block or two
+    uint64_t estimated_hash_compressions() const;
+};
+
+// Whether this header was built with instrumentation; code built separately may differ
+constexpr bool enabled() {
+#ifdef SPARK_INSTRUMENTATION
+    return true;
+#else
+    return false;
+#endif
+}
+
+Snapshot snapshot();
+void reset();
+
+const char* name(Counter counter);
+const char* name(Stage stage);
+
+extern std::atomic<uint64_t> counters[COUNTER_COUNT];
+extern std::atomic<uint64_t> stage_calls[STAGE_COUNT];
+extern std::atomic<uint64_t> stage_nanoseconds[STAGE_COUNT];
+
+inline void count(Counter counter, uint64_t amount = 1) {
+    counters[counter].fetch_add(amount, std::memory_order_relaxed);
+}
+
+// Adds the time from construction to destruction to a stage
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Stage stage) : stage(stage), start(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        stage_calls[stage].fetch_add(1, std::memory_order_relaxed);
+        stage_nanoseconds[stage].fetch_add(elapsed.count(), std::memory_order_relaxed);
+    }
+
+    ScopedTimer(const ScopedTimer& other) = delete;
+    ScopedTimer& operator=(const ScopedTimer& other) = delete;
+
+private:
+    Stage stage;
+    std::chrono::steady_clock::time_point start;
+};
+
+}// namespace instrumentation
+
+}// namespace secp_primitives
+
+#ifdef SPARK_INSTRUMENTATION
+#define SPARK_COUNT(counter, amount) ::secp_primitives::instrumentation::count(::secp_primitives::instrumentation::counter, (amount))
+#define SPARK_TIME_STAGE_NAME(line) spark_stage_timer_##line
+#define SPARK_TIME_STAGE_AT(stage, line) ::secp_primitives::instrumentation::ScopedTimer SPARK_TIME_STAGE_NAME(line)(::secp_primitives::instrumentation::stage)
+#define SPARK_TIME_STAGE(stage) SPARK_TIME_STAGE_AT(stage, __LINE__)
+#else
+#define SPARK_COUNT(counter, amount) do {} while (0)
+#define SPARK_TIME_STAGE(stage) do {} while (0)
+#endif
+
+#endif //SECP_INSTRUMENTATION_H
@@ -4,6 +4,7 @@
 #include <vector>
 #include "../include/GroupElement.h"
 #include "../include/Scalar.h"
+#include "../include/Executor.h"
 
 namespace secp_primitives {
 
@@ -11,13 +12,25 @@ class MultiExponent {
 public:
     MultiExponent(const MultiExponent& other);
     MultiExponent(const std::vector<GroupElement>& generators, const std::vector<Scalar>& powers);
+    // Generators given as consecutive affine encodings (see GroupElement::serialize_affine), one per power.
+    // The encodings are trusted to be valid points
+    MultiExponent(const unsigned char* affine_generators, const std::vector<Scalar>& powers);
     ~MultiExponent();
 
     GroupElement get_multiple();
+    // Splits large sets of points between the executor's threads
+    GroupElement get_multiple(Executor& executor);
+
+    // Fewest points worth giving a thread of their own
+    static constexpr std::size_t min_part_size = 1024;
+
+    // Peak heap memory of constructing an instance for `n_points` points and computing its multiple on `executor`:
+    // the copied scalars and points, and the scratch space of every part run at once
+    static std::size_t memory_required(const std::size_t n_points, const Executor& executor = Executor::serial());
 
 private:
     void  *sc_; // secp256k1_scalar[]
-    void  *pt_; // secp256k1_gej[]
+    void  *pt_; // secp256k1_ge[], affine so that the multiplication needs no inversion per point
     int n_points;
 };
 
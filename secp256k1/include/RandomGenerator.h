@@ -0,0 +1,58 @@
+#ifndef SECP_RANDOM_GENERATOR_H
+#define SECP_RANDOM_GENERATOR_H
+
+#include "../include/Scalar.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace secp_primitives {
+
+// Random bytes for proof masks and batch verification weights, without a system call per scalar.
+// Each thread has its own ChaCha20 keystream, keyed from the operating system on first use, again after every
+// `reseed_interval` bytes and in the child after a fork. Output is taken from the keystream in blocks, and the first
+// 32 bytes of every block become the next key, so a later state does not reveal earlier output.
+class RandomGenerator final {
+public:
+    static const std::size_t reseed_interval = 1 << 20;
+
+    // The generator of the calling thread
+    static RandomGenerator& get();
+
+    // A deterministic generator keyed by the 32 bytes of `key`, which is never reseeded; for tests and benchmarks
+    explicit RandomGenerator(const unsigned char* key);
+    ~RandomGenerator();
+
+    RandomGenerator(const RandomGenerator& other) = delete;
+    RandomGenerator& operator=(const RandomGenerator& other) = delete;
+
+    void fill(unsigned char* output, std::size_t size);
+
+    // Nonzero scalars below the group order, drawing the bytes for all of them at once
+    void randomize(Scalar* scalars, std::size_t count);
+    void randomize(std::vector<Scalar>& scalars);
+
+    // A nonzero scalar drawn straight from the operating system, bypassing any generator state; for long-term keys
+    static void randomize_from_system(Scalar& scalar);
+
+private:
+    static const std::size_t block_size = 512;
+
+    RandomGenerator();
+
+    void refill();
+    void reseed();
+    bool forked() const;
+
+    void *ctx_; // EVP_CIPHER_CTX
+    unsigned char key_[32];
+    unsigned char buffer_[block_size];
+    std::size_t available_; // unused bytes at the end of buffer_
+    std::size_t since_reseed_;
+    unsigned int fork_generation_;
+    bool deterministic_;
+};
+
+}// namespace secp_primitives
+
+#endif //SECP_RANDOM_GENERATOR_H
@@ -51,6 +51,8 @@ public:
     bool operator!=(const Scalar& other) const;
 
     Scalar inverse() const;
+    // Variable time; only for public values such as transcript challenges
+    Scalar inverse_var() const;
 
     Scalar negate() const;
 
@@ -86,6 +88,8 @@ public:
     std::string tostring() const;
 
     static constexpr size_t memoryRequired() { return 32; }
+    // Heap memory owned by each instance
+    static std::size_t allocated_size();
 
     unsigned char* serialize(unsigned char* buffer) const;
     unsigned const char* deserialize(unsigned const char* buffer);
@@ -0,0 +1,200 @@
+#include "../include/Executor.h"
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+namespace secp_primitives {
+
+// Every task runs even if another fails, and the earliest failure is reported
+static void rethrow_first(const std::vector<std::exception_ptr>& failures) {
+    for (const std::exception_ptr& failure : failures) {
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+}
+
+Executor::~Executor() {}
+
+Executor& Executor::serial() {
+    static SerialExecutor executor;
+    return executor;
+}
+
+static std::mutex default_mutex;
+static std::vector<std::shared_ptr<Executor>> installed;
+static std::atomic<Executor*> current_default(nullptr);
+
+Executor& Executor::get_default() {
+    Executor* executor = current_default.load(std::memory_order_acquire);
+    return executor ? *executor : serial();
+}
+
+void Executor::set_default(const std::shared_ptr<Executor>& executor) {
+    if (!executor) {
+        throw std::invalid_argument("Executor: no default executor given");
+    }
+    std::lock_guard<std::mutex> lock(default_mutex);
+    installed.push_back(executor);
+    current_default.store(executor.get(), std::memory_order_release);
+}
+
+std::size_t SerialExecutor::concurrency() const {
+    return 1;
+}
+
+void SerialExecutor::run(const std::vector<std::function<void()>>& tasks) {
+    std::vector<std::exception_ptr> failures(tasks.size());
+    for (std::size_t i = 0; i < tasks.size(); i++) {
+        try {
+            tasks[i]();
+        } catch (...) {
+            failures[i] = std::current_exception();
+        }
+    }
+    rethrow_first(failures);
+}
+
+struct ThreadPool::Batch {
+    explicit Batch(const std::vector<std::function<void()>>& tasks_)
+            : tasks(tasks_)
+            , remaining(tasks_.size())
+            , failures(tasks_.size())
+    {}
+
+    const std::vector<std::function<void()>>& tasks;
+    std::size_t remaining; // guarded by `mutex`
+    std::vector<std::exception_ptr> failures;
+    std::mutex mutex;
+    std::condition_variable finished;
+};
+
+// Queue of the worker running on this thread, if any
+static thread_local ThreadPool* worker_pool = nullptr;
+static thread_local std::size_t worker_queue = 0;
+
+ThreadPool::ThreadPool(std::size_t threads)
+        : threads(threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads)
+        , queued(0)
+        , stopping(false)
+{
+    for (std::size_t i = 0; i < this->threads; i++) {
+        this->queues.emplace_back(new Queue);
+    }
+    for (std::size_t i = 0; i + 1 < this->threads; i++) {
+        this->workers.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->available.notify_all();
+    for (std::thread& worker : this->workers) {
+        worker.join();
+    }
+}
+
+std::size_t ThreadPool::concurrency() const {
+    return this->threads;
+}
+
+// Newest task from the given queue, otherwise the oldest task of another queue
+bool ThreadPool::take(std::size_t queue, Task& task) {
+    for (std::size_t i = 0; i < this->queues.size(); i++) {
+        Queue& q = *this->queues[(queue + i) % this->queues.size()];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty()) {
+            continue;
+        }
+        if (i == 0) {
+            task = q.tasks.back();
+            q.tasks.pop_back();
+        } else {
+            task = q.tasks.front();
+            q.tasks.pop_front();
+        }
+        this->queued--;
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::execute(const Task& task) {
+    Batch& batch = *task.batch;
+    try {
+        batch.tasks[task.index]();
+    } catch (...) {
+        batch.failures[task.index] = std::current_exception();
+    }
+
+    // The batch belongs to a thread waiting on it, and may go away as soon as the lock is released
+    std::lock_guard<std::mutex> lock(batch.mutex);
+    if (--batch.remaining == 0) {
+        batch.finished.notify_all();
+    }
+}
+
+void ThreadPool::work(std::size_t queue) {
+    worker_pool = this;
+    worker_queue = queue;
+
+    Task task;
+    while (true) {
+        if (take(queue, task)) {
+            execute(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->available.wait(lock, [this] { return this->stopping || this->queued > 0; });
+        if (this->stopping && this->queued == 0) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::run(const std::vector<std::function<void()>>& tasks) {
+    if (tasks.empty()) {
+        return;
+    }
+
+    // A worker queues nested tasks for itself and lets others steal them; other threads share the last queue
+    std::size_t queue = worker_pool == this ? worker_queue : this->queues.size() - 1;
+    Batch batch(tasks);
+
+    // Count the tasks before publishing them, so that a worker taking one cannot take the count below zero
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->queued += tasks.size();
+    }
+    {
+        Queue& q = *this->queues[queue];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        for (std::size_t i = tasks.size(); i-- > 0;) {
+            q.tasks.push_back(Task{&batch, i});
+        }
+    }
+    this->available.notify_all();
+
+    // Work until nothing is queued; whatever remains of the batch is then running on other threads
+    Task task;
+    while (take(queue, task)) {
+        execute(task);
+        std::lock_guard<std::mutex> lock(batch.mutex);
+        if (batch.remaining == 0) {
+            break;
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(batch.mutex);
+    batch.finished.wait(lock, [&batch] { return batch.remaining == 0; });
+    lock.unlock();
+
+    rethrow_first(batch.failures);
+}
+
+}// namespace secp_primitives
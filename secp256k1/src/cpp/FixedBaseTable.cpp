@@ -0,0 +1,174 @@
+#include "../include/FixedBaseTable.h"
+
+#include "../include/secp256k1.h"
+#include "../field.h"
+#include "../field_impl.h"
+#include "../group.h"
+#include "../group_impl.h"
+#include "../scalar.h"
+#include "../scalar_impl.h"
+
+#include "../include/Instrumentation.h"
+
+#include <stdexcept>
+#include <vector>
+
+namespace secp_primitives {
+
+FixedBaseTable::FixedBaseTable(const GroupElement& base, unsigned int window_bits)
+        : base_(base)
+        , window_bits_(window_bits)
+        , windows_((256 + window_bits - 1) / window_bits)
+        , table_(nullptr)
+        , owned_(true)
+{
+    if (window_bits == 0 || window_bits > 8) {
+        throw std::invalid_argument("FixedBaseTable: bad window size");
+    }
+    if (base.isInfinity()) {
+        throw std::invalid_argument("FixedBaseTable: base is infinity");
+    }
+
+    const std::size_t per_window = (std::size_t(1) << window_bits_) - 1;
+    const std::size_t size = windows_ * per_window;
+
+    // Window j holds d * 2^(j * window_bits) * base for d = 1 .. 2^window_bits - 1
+    std::vector<secp256k1_gej> multiples(size);
+    secp256k1_gej window_base = *reinterpret_cast<const secp256k1_gej *>(base_.get_value());
+    for (std::size_t j = 0; j < windows_; j++) {
+        secp256k1_gej* window = &multiples[j * per_window];
+        window[0] = window_base;
+        for (std::size_t d = 1; d < per_window; d++) {
+            secp256k1_gej_add_var(&window[d], &window[d - 1], &window_base, NULL);
+        }
+        secp256k1_gej_add_var(&window_base, &window[per_window - 1], &window_base, NULL);
+    }
+
+    // Normalize everything with a single inversion
+    SPARK_COUNT(INVERSIONS, 1);
+    std::vector<secp256k1_ge> affine(size);
+    secp256k1_ge_set_all_gej_var(affine.data(), multiples.data(), size, NULL);
+
+    SPARK_COUNT(ALLOCATIONS, 1);
+    secp256k1_ge_storage* table = new secp256k1_ge_storage[size];
+    for (std::size_t i = 0; i < size; i++) {
+        secp256k1_ge_to_storage(&table[i], &affine[i]);
+    }
+    table_ = table;
+}
+
+FixedBaseTable::FixedBaseTable(const GroupElement& base, unsigned int window_bits, const void* table)
+        : base_(base)
+        , window_bits_(window_bits)
+        , windows_((256 + window_bits - 1) / window_bits)
+        , table_(const_cast<void *>(table))
+        , owned_(false)
+{
+    if (window_bits == 0 || window_bits > 8) {
+        throw std::invalid_argument("FixedBaseTable: bad window size");
+    }
+    if (base.isInfinity()) {
+        throw std::invalid_argument("FixedBaseTable: base is infinity");
+    }
+
+    // The first entry is the base itself
+    secp256k1_ge first;
+    secp256k1_ge_from_storage(&first, reinterpret_cast<const secp256k1_ge_storage *>(table));
+    secp256k1_gej first_gej;
+    secp256k1_gej_set_ge(&first_gej, &first);
+    if (!secp256k1_ge_is_valid_var(&first) || !(GroupElement(&first_gej) == base_)) {
+        throw std::invalid_argument("FixedBaseTable: table does not match the base");
+    }
+}
+
+FixedBaseTable::~FixedBaseTable()
+{
+    if (owned_) {
+        delete []reinterpret_cast<secp256k1_ge_storage *>(table_);
+    }
+}
+
+GroupElement FixedBaseTable::multiply(const Scalar& multiplier) const
+{
+    SPARK_COUNT(SCALAR_MULTIPLICATIONS, 1);
+    const secp256k1_scalar* s = reinterpret_cast<const secp256k1_scalar *>(multiplier.get_value());
+    const secp256k1_ge_storage* table = reinterpret_cast<const secp256k1_ge_storage *>(table_);
+    const std::size_t per_window = (std::size_t(1) << window_bits_) - 1;
+
+    secp256k1_gej result;
+    secp256k1_gej_set_infinity(&result);
+    for (unsigned int j = 0; j < windows_; j++) {
+        unsigned int offset = j * window_bits_;
+        unsigned int count = offset + window_bits_ > 256 ? 256 - offset : window_bits_;
+        unsigned int digit = secp256k1_scalar_get_bits_var(s, offset, count);
+        if (digit != 0) {
+            secp256k1_ge entry;
+            secp256k1_ge_from_storage(&entry, &table[j * per_window + digit - 1]);
+            secp256k1_gej_add_ge_var(&result, &result, &entry, NULL);
+        }
+    }
+
+    return &result;
+}
+
+const GroupElement& FixedBaseTable::get_base() const
+{
+    return base_;
+}
+
+unsigned int FixedBaseTable::get_window_bits() const
+{
+    return window_bits_;
+}
+
+const void* FixedBaseTable::data() const
+{
+    return table_;
+}
+
+std::size_t FixedBaseTable::memoryRequired() const
+{
+    return memoryRequired(window_bits_);
+}
+
+std::size_t FixedBaseTable::memoryRequired(unsigned int window_bits)
+{
+    std::size_t windows = (256 + window_bits - 1) / window_bits;
+    return windows * ((std::size_t(1) << window_bits) - 1) * sizeof(secp256k1_ge_storage);
+}
+
+std::vector<unsigned char> FixedBaseTable::layout_tag() {
+    std::vector<unsigned char> result;
+
+    const uint32_t byte_order = 0x01020304;
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&byte_order);
+    result.insert(result.end(), bytes, bytes + sizeof(byte_order));
+
+#if defined(USE_FIELD_5X52)
+    result.push_back(52);
+#elif defined(USE_FIELD_10X26)
+    result.push_back(26);
+#else
+#error "Unknown field representation"
+#endif
+    result.push_back(sizeof(secp256k1_ge_storage));
+
+    // The generator as stored in a table, which shows the limb layout
+    secp256k1_ge_storage g;
+    secp256k1_ge_to_storage(&g, &secp256k1_ge_const_g);
+    bytes = reinterpret_cast<const unsigned char*>(&g);
+    result.insert(result.end(), bytes, bytes + sizeof(g));
+
+    return result;
+}
+
+unsigned int FixedBaseTable::window_bits_for(std::size_t memory)
+{
+    unsigned int window_bits = 1;
+    while (window_bits < 8 && memoryRequired(window_bits + 1) <= memory) {
+        window_bits++;
+    }
+    return window_bits;
+}
+
+}// namespace secp_primitives
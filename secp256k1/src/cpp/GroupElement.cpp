@@ -1,4 +1,5 @@
 #include "include/GroupElement.h"
+#include "include/RandomGenerator.h"
 #include "include/secp256k1.h"
 
 #include "../field.h"
@@ -12,26 +13,211 @@
 #include "../ecmult.h"
 #include "../ecmult_impl.h"
 
-#include <openssl/rand.h>
+#include "../include/Instrumentation.h"
 
+
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 
 #include <stdlib.h>
 
-static secp256k1_ecmult_context ctx;
+// Only variable-base multiplication is done here, which never reads the precomputed generator tables,
+// so an empty context is enough and is safe to share between threads
+static const secp256k1_ecmult_context* ecmult_context() {
+    static const secp256k1_ecmult_context ctx = [] {
+        secp256k1_ecmult_context result;
+        secp256k1_ecmult_context_init(&result);
+        return result;
+    }();
+    return &ctx;
+}
+
+// A group element is either decompressed, or holds its serialized form until the point is first used
+enum : uint8_t {
+    POINT_READY,
+    POINT_COMPRESSED,
+    POINT_DECOMPRESSING,
+    POINT_INVALID
+};
+
+// The affine form of the point is computed on first use and kept until the point changes
+enum : uint8_t {
+    AFFINE_NONE,
+    AFFINE_COMPUTING,
+    AFFINE_READY
+};
+
+struct point_state {
+    secp256k1_gej gej;
+    std::atomic<uint8_t> status;
+    std::atomic<uint8_t> affine_status;
+    secp256k1_ge affine; // normalized coordinates, valid while affine_status is AFFINE_READY
+    unsigned char compressed[secp_primitives::GroupElement::serialize_size];
+
+    point_state() : status(POINT_READY), affine_status(AFFINE_NONE) {}
+};
+
+static point_state* state(void* g) {
+    return reinterpret_cast<point_state *>(g);
+}
+
+// Record a known affine form; only for points not yet visible to other threads
+static void set_affine(point_state* s, const secp256k1_ge& ge) {
+    s->affine = ge;
+    secp256k1_fe_normalize_var(&s->affine.x);
+    secp256k1_fe_normalize_var(&s->affine.y);
+    s->affine_status.store(AFFINE_READY, std::memory_order_release);
+}
+
+// Decompress and validate a serialized point, keeping the affine form if it is valid
+static bool decompress(point_state* s, const unsigned char* buffer) {
+    secp256k1_fe x;
+    secp256k1_fe_set_b32(&x, buffer);
+    unsigned char oddness = buffer[32];
+    unsigned char infinity = buffer[33];
+    secp256k1_ge result;
+    secp256k1_ge_set_xo_var(&result, &x, (int)oddness);
+    result.infinity = (int)infinity;
+
+    secp256k1_gej_set_ge(&s->gej, &result);
+
+    if (!secp256k1_ge_is_valid_var(&result) && !result.infinity) {
+        s->affine_status.store(AFFINE_NONE, std::memory_order_relaxed);
+        return false;
+    }
+    set_affine(s, result);
+    return true;
+}
+
+// Finish a deferred decompression; concurrent callers wait for whichever thread does the work
+// Returns false if the serialized point was invalid
+static bool resolve(point_state* s) {
+    uint8_t status = POINT_COMPRESSED;
+    if (s->status.compare_exchange_strong(status, POINT_DECOMPRESSING, std::memory_order_acquire)) {
+        status = decompress(s, s->compressed) ? POINT_READY : POINT_INVALID;
+        s->status.store(status, std::memory_order_release);
+    }
+    while (status == POINT_DECOMPRESSING) {
+        std::this_thread::yield();
+        status = s->status.load(std::memory_order_acquire);
+    }
+    return status == POINT_READY;
+}
+
+// Access the point, decompressing it first if needed
+static secp256k1_gej* point(void* g) {
+    point_state* s = state(g);
+    if (s->status.load(std::memory_order_acquire) != POINT_READY && !resolve(s)) {
+        throw std::invalid_argument("GroupElement: deserialize failed");
+    }
+    return &s->gej;
+}
+
+// Access the point for modification, which drops its affine form
+static secp256k1_gej* mutable_point(void* g) {
+    secp256k1_gej* result = point(g);
+    state(g)->affine_status.store(AFFINE_NONE, std::memory_order_relaxed);
+    return result;
+}
+
+// Copy a point, keeping it compressed if it has not been used yet
+static void copy_point(point_state* r, point_state* a) {
+    if (r == a) {
+        return;
+    }
+    uint8_t status = a->status.load(std::memory_order_acquire);
+    if (status == POINT_DECOMPRESSING) {
+        resolve(a);
+        status = a->status.load(std::memory_order_acquire);
+    }
+    if (status == POINT_READY) {
+        r->gej = a->gej;
+        if (a->affine_status.load(std::memory_order_acquire) == AFFINE_READY) {
+            r->affine = a->affine;
+            r->affine_status.store(AFFINE_READY, std::memory_order_relaxed);
+        } else {
+            r->affine_status.store(AFFINE_NONE, std::memory_order_relaxed);
+        }
+    } else {
+        memcpy(r->compressed, a->compressed, sizeof(r->compressed));
+        r->affine_status.store(AFFINE_NONE, std::memory_order_relaxed);
+    }
+    r->status.store(status, std::memory_order_release);
+}
+
+static thread_local int lazy_deserialization_depth = 0;
 
-// Converts the value from secp256k1_gej to secp256k1_ge and returns.
+// Converts the value from secp256k1_gej to secp256k1_ge with normalized coordinates and returns.
 static secp256k1_ge gej_to_ge(const secp256k1_gej &gej)
 {
     secp256k1_ge ge;
     secp256k1_gej j(gej);
+    SPARK_COUNT(INVERSIONS, 1);
     secp256k1_ge_set_gej(&ge, &j);
+    secp256k1_fe_normalize_var(&ge.x);
+    secp256k1_fe_normalize_var(&ge.y);
     return ge;
 }
 
+// The cached affine form, or nullptr if it has not been computed
+static const secp256k1_ge* cached_affine(void* g) {
+    point_state* s = state(g);
+    return s->affine_status.load(std::memory_order_acquire) == AFFINE_READY ? &s->affine : nullptr;
+}
+
+// The affine form of the point, computed and cached on first use. Const callers on several threads may race here;
+// whichever claims the slot first stores its result, while the others use their own copy in `scratch`
+static const secp256k1_ge* affine(void* g, secp256k1_ge* scratch) {
+    const secp256k1_gej* j = point(g);
+    point_state* s = state(g);
+    uint8_t status = s->affine_status.load(std::memory_order_acquire);
+    if (status == AFFINE_READY) {
+        return &s->affine;
+    }
+
+    *scratch = gej_to_ge(*j);
+    if (status == AFFINE_NONE && s->affine_status.compare_exchange_strong(status, AFFINE_COMPUTING, std::memory_order_acquire)) {
+        s->affine = *scratch;
+        s->affine_status.store(AFFINE_READY, std::memory_order_release);
+    }
+    return scratch;
+}
+
+// Compares an affine point with a Jacobian one, scaling the former instead of inverting z
+static bool equal_mixed(const secp256k1_ge& a, const secp256k1_gej& b) {
+    secp256k1_fe zz, u, s;
+    secp256k1_fe_sqr(&zz, &b.z);
+    secp256k1_fe_mul(&u, &a.x, &zz);
+    if (!secp256k1_fe_equal_var(&u, &b.x)) {
+        return false;
+    }
+    secp256k1_fe_mul(&s, &a.y, &zz);
+    secp256k1_fe_mul(&s, &s, &b.z);
+    return secp256k1_fe_equal_var(&s, &b.y);
+}
+
+// Compares two Jacobian points by cross-multiplication: x1*z2^2 == x2*z1^2 and y1*z2^3 == y2*z1^3
+static bool equal_jacobian(const secp256k1_gej& a, const secp256k1_gej& b) {
+    secp256k1_fe za2, zb2, u1, u2, s1, s2;
+    secp256k1_fe_sqr(&za2, &a.z);
+    secp256k1_fe_sqr(&zb2, &b.z);
+    secp256k1_fe_mul(&u1, &a.x, &zb2);
+    secp256k1_fe_mul(&u2, &b.x, &za2);
+    if (!secp256k1_fe_equal_var(&u1, &u2)) {
+        return false;
+    }
+    secp256k1_fe_mul(&s1, &a.y, &zb2);
+    secp256k1_fe_mul(&s1, &s1, &b.z);
+    secp256k1_fe_mul(&s2, &b.y, &za2);
+    secp256k1_fe_mul(&s2, &s2, &a.z);
+    return secp256k1_fe_equal_var(&s1, &s2);
+}
+
 //	Implements the algorithm from:
 //   Indifferentiable Hashing to Barreto-Naehrig Curves
 //    Pierre-Alain Fouque and Mehdi Tibouchi
@@ -160,21 +346,26 @@ static void _negate (uint8_t(&num) [Len])
 }
 
 GroupElement::GroupElement()
-        : g_(new secp256k1_gej())
+        : g_(new point_state())
 {
-    auto g = reinterpret_cast<secp256k1_gej *>(g_);
+    SPARK_COUNT(ALLOCATIONS, 1);
+    auto g = mutable_point(g_);
     secp256k1_gej_clear(g);
     g->infinity = 1;
 }
 
 GroupElement::GroupElement(const GroupElement& other)
-        : g_(new secp256k1_gej(*reinterpret_cast<secp256k1_gej *>(other.g_)))
+        : g_(new point_state())
 {
+    SPARK_COUNT(ALLOCATIONS, 1);
+    copy_point(state(g_), state(other.g_));
 }
 
 GroupElement::GroupElement(const void *g)
-        : g_(new secp256k1_gej(*reinterpret_cast<const secp256k1_gej *>(g)))
+        : g_(new point_state())
 {
+    SPARK_COUNT(ALLOCATIONS, 1);
+    state(g_)->gej = *reinterpret_cast<const secp256k1_gej *>(g);
 }
 
 static void _convertToFieldElement(secp256k1_fe *r, const char* str, int base) {
@@ -225,9 +416,10 @@ static void _convertToFieldElement(secp256k1_fe *r, const char* str, int base) {
 }
 
 GroupElement::GroupElement(const char* x,const char* y, int base)
-        : g_(new secp256k1_gej())
+        : g_(new point_state())
 {
-    auto g = reinterpret_cast<secp256k1_gej *>(g_);
+    SPARK_COUNT(ALLOCATIONS, 1);
+    auto g = mutable_point(g_);
 
     secp256k1_gej_clear(g);
     secp256k1_ge element;
@@ -239,7 +431,7 @@ GroupElement::GroupElement(const char* x,const char* y, int base)
 
 GroupElement::~GroupElement()
 {
-    delete reinterpret_cast<secp256k1_gej *>(g_);
+    delete state(g_);
 }
 
 GroupElement& GroupElement::operator=(const GroupElement &other)
@@ -249,72 +441,103 @@ GroupElement& GroupElement::operator=(const GroupElement &other)
 
 GroupElement& GroupElement::set(const GroupElement &other)
 {
-    *reinterpret_cast<secp256k1_gej *>(g_) = *reinterpret_cast<secp256k1_gej *>(other.g_);
+    copy_point(state(g_), state(other.g_));
     return *this;
 }
 
 GroupElement GroupElement::operator*(const Scalar& multiplier) const
 {
+    SPARK_COUNT(SCALAR_MULTIPLICATIONS, 1);
     secp256k1_gej result;
-    secp256k1_scalar ng;
-    secp256k1_scalar_set_int(&ng,0);
-    secp256k1_ecmult(&ctx,&result,reinterpret_cast<secp256k1_gej *>(g_), reinterpret_cast<const secp256k1_scalar *>(multiplier.get_value()),&ng);
+    secp256k1_ecmult(ecmult_context(),&result,point(g_), reinterpret_cast<const secp256k1_scalar *>(multiplier.get_value()),NULL);
     return &result;
 }
 
 GroupElement& GroupElement::operator*=(const Scalar& multiplier)
 {
-    auto g = reinterpret_cast<secp256k1_gej *>(g_);
-    secp256k1_scalar ng;
-    secp256k1_scalar_set_int(&ng,0);
-    secp256k1_ecmult(&ctx,g,g, reinterpret_cast<const secp256k1_scalar *>(multiplier.get_value()),&ng);
+    SPARK_COUNT(SCALAR_MULTIPLICATIONS, 1);
+    auto g = mutable_point(g_);
+    secp256k1_ecmult(ecmult_context(),g,g, reinterpret_cast<const secp256k1_scalar *>(multiplier.get_value()),NULL);
     return *this;
 }
 
+// Sets r = a + b, with the cheaper mixed addition when either side has a known affine form
+static void add_points(secp256k1_gej* r, void* a, void* b) {
+    const secp256k1_gej* a_gej = point(a);
+    const secp256k1_gej* b_gej = point(b);
+    const secp256k1_ge* b_ge = cached_affine(b);
+    if (b_ge) {
+        secp256k1_gej_add_ge_var(r, a_gej, b_ge, NULL);
+        return;
+    }
+    const secp256k1_ge* a_ge = cached_affine(a);
+    if (a_ge) {
+        secp256k1_gej_add_ge_var(r, b_gej, a_ge, NULL);
+        return;
+    }
+    secp256k1_gej_add_var(r, a_gej, b_gej, NULL);
+}
+
 GroupElement GroupElement::operator+(const GroupElement &other) const
 {
     secp256k1_gej result_gej;
-    secp256k1_gej_add_var(&result_gej, reinterpret_cast<secp256k1_gej *>(g_), reinterpret_cast<secp256k1_gej *>(other.g_), NULL);
+    add_points(&result_gej, g_, other.g_);
     return &result_gej;
 }
 
 GroupElement& GroupElement::operator+=(const GroupElement& other)
 {
-    auto g = reinterpret_cast<secp256k1_gej *>(g_);
-    secp256k1_gej_add_var(g, g, reinterpret_cast<secp256k1_gej *>(other.g_), NULL);
+    secp256k1_gej result_gej;
+    add_points(&result_gej, g_, other.g_);
+    *mutable_point(g_) = result_gej;
     return *this;
 }
 
 GroupElement GroupElement::inverse() const
 {
     secp256k1_gej result_gej;
-    secp256k1_gej_neg(&result_gej,reinterpret_cast<secp256k1_gej *>(g_));
-    return &result_gej;
+    secp256k1_gej_neg(&result_gej,point(g_));
+    GroupElement result(&result_gej);
+
+    // Negation keeps an affine point affine
+    const secp256k1_ge* ge = cached_affine(g_);
+    if (ge) {
+        secp256k1_ge negated;
+        secp256k1_ge_neg(&negated, ge);
+        set_affine(state(result.g_), negated);
+    }
+    return result;
 }
 
 void GroupElement::square()
 {
-    auto g = reinterpret_cast<secp256k1_gej *>(g_);
+    auto g = mutable_point(g_);
     secp256k1_gej_double_var(g, g, NULL);
 }
 
 bool GroupElement::operator==(const  GroupElement& other) const
 {
-    auto g = reinterpret_cast<secp256k1_gej *>(g_);
-    auto og = reinterpret_cast<secp256k1_gej *>(other.g_);
+    auto g = point(g_);
+    auto og = point(other.g_);
 
     if(g->infinity && og->infinity)
         return true;
     if(g->infinity != og->infinity)
         return false;
-    secp256k1_ge this_ge = gej_to_ge(*g);
-    secp256k1_ge other_ge = gej_to_ge(*og);
-    if(!secp256k1_fe_equal(&this_ge.x, &other_ge.x))
-        return false;
-    if(!secp256k1_fe_equal(&this_ge.y, &other_ge.y))
-        return false;
 
-    return true;
+    // Neither side is inverted; cached affine forms only save multiplications
+    const secp256k1_ge* this_ge = cached_affine(g_);
+    const secp256k1_ge* other_ge = cached_affine(other.g_);
+    if (this_ge && other_ge) {
+        return secp256k1_fe_equal_var(&this_ge->x, &other_ge->x) && secp256k1_fe_equal_var(&this_ge->y, &other_ge->y);
+    }
+    if (this_ge) {
+        return equal_mixed(*this_ge, *og);
+    }
+    if (other_ge) {
+        return equal_mixed(*other_ge, *g);
+    }
+    return equal_jacobian(*g, *og);
 }
 
 bool GroupElement::operator!=(const  GroupElement& other) const
@@ -324,25 +547,24 @@ bool GroupElement::operator!=(const  GroupElement& other) const
 
 bool GroupElement::isMember() const
 {
-    secp256k1_ge v1 = gej_to_ge(*reinterpret_cast<secp256k1_gej *>(g_));
-    if (secp256k1_ge_is_infinity(&v1)) {
+    secp256k1_ge scratch;
+    const secp256k1_ge* v1 = affine(g_, &scratch);
+    if (secp256k1_ge_is_infinity(v1)) {
         return true;
     }
-    return secp256k1_ge_is_valid_var(&v1);
+    return secp256k1_ge_is_valid_var(v1);
 }
 
 bool GroupElement::isInfinity() const
 {
-    return secp256k1_gej_is_infinity(reinterpret_cast<const secp256k1_gej *>(g_));
+    return secp256k1_gej_is_infinity(point(g_));
 }
 
 void GroupElement::randomize() {
     unsigned char temp[32] = { 0 };
 
     do {
-        if (RAND_bytes(temp, 32) != 1) {
-            throw "Unable to generate random GroupElement";
-        }
+        RandomGenerator::get().fill(temp, 32);
         generate(temp);
     } while (!(this->isMember()));
 }
@@ -383,20 +605,22 @@ GroupElement& GroupElement::generate(unsigned char* seed){
     if (gen[0] & 1) {
         secp256k1_ge_neg(&ge, &ge);
     }
-    secp256k1_gej_set_ge(reinterpret_cast<secp256k1_gej *>(g_), &ge);
+    secp256k1_gej_set_ge(&state(g_)->gej, &ge);
+    set_affine(state(g_), ge);
+    state(g_)->status.store(POINT_READY, std::memory_order_release);
     return *this;
 }
 
 void GroupElement::normalSha256(unsigned char* result) const {
     GroupElement tmp = *this;
-    auto g = reinterpret_cast<secp256k1_gej *>(tmp.g_);
+    auto g = point(tmp.g_);
     secp256k1_fe_normalize(&g->x);
     secp256k1_fe_normalize(&g->y);
     tmp.sha256(result);
 }
 
 void GroupElement::sha256(unsigned char* result) const {
-    auto g = reinterpret_cast<secp256k1_gej *>(g_);
+    auto g = point(g_);
     unsigned char buff[64];
     secp256k1_fe_get_b32(&buff[0], &g->x);
     secp256k1_fe_get_b32(&buff[32], &g->y);
@@ -455,7 +679,8 @@ std::string _convertToString(const unsigned char(&buffer) [Len], int base) {
 
 std::string GroupElement::tostring() const {
     int base = 10;
-    secp256k1_ge ge = gej_to_ge(*reinterpret_cast<secp256k1_gej *>(g_));
+    secp256k1_ge scratch;
+    const secp256k1_ge& ge = *affine(g_, &scratch);
 
     if (ge.infinity) {
     return std::string("O");
@@ -477,7 +702,8 @@ std::string GroupElement::tostring() const {
 
 std::string GroupElement::GetHex() const {
     int base = 16;
-    secp256k1_ge ge = gej_to_ge(*reinterpret_cast<secp256k1_gej *>(g_));
+    secp256k1_ge scratch;
+    const secp256k1_ge& ge = *affine(g_, &scratch);
 
     if (ge.infinity) {
         return std::string("O");
@@ -498,7 +724,7 @@ std::string GroupElement::GetHex() const {
 }
 
 unsigned char* GroupElement::serialize() const {
-    auto g = reinterpret_cast<secp256k1_gej *>(g_);
+    auto g = point(g_);
     unsigned char* data = new unsigned char[ 2 * sizeof(secp256k1_fe)];
     memcpy(&data[0], &g->x.n[0], sizeof(secp256k1_fe));
     memcpy(&data[0] + sizeof(secp256k1_fe), &g->y.n[0], sizeof(secp256k1_fe));
@@ -506,34 +732,155 @@ unsigned char* GroupElement::serialize() const {
 }
 
 unsigned char* GroupElement::serialize(unsigned char* buffer) const {
-    secp256k1_ge value = gej_to_ge(*reinterpret_cast<secp256k1_gej *>(g_));
-    secp256k1_fe x = value.x;
-    secp256k1_fe y = value.y;
-    secp256k1_fe_normalize(&x);
-    secp256k1_fe_normalize(&y);
-    unsigned char oddness = secp256k1_fe_is_odd(&y);
+    secp256k1_ge scratch;
+    const secp256k1_ge& value = *affine(g_, &scratch);
+    unsigned char oddness = secp256k1_fe_is_odd(&value.y);
     unsigned char infinity = value.infinity;
-    secp256k1_fe_get_b32(buffer, &x);
+    secp256k1_fe_get_b32(buffer, &value.x);
     buffer[32] = oddness;
     buffer[33] = infinity;
     return buffer + memoryRequired();
 }
 
 const unsigned char* GroupElement::deserialize(const unsigned char* buffer) {
-    secp256k1_fe x;
-    secp256k1_fe_set_b32(&x, buffer);
-    unsigned char oddness = buffer[32];
-    unsigned char infinity = buffer[33];
+    bool valid = decompress(state(g_), buffer);
+    state(g_)->status.store(POINT_READY, std::memory_order_release);
+
+    if (!valid) {
+        throw std::invalid_argument("GroupElement: deserialize failed");
+    }
+    return buffer + memoryRequired();
+}
+
+const unsigned char* GroupElement::deserialize_lazy(const unsigned char* buffer) {
+    memcpy(state(g_)->compressed, buffer, memoryRequired());
+    state(g_)->affine_status.store(AFFINE_NONE, std::memory_order_relaxed);
+    state(g_)->status.store(POINT_COMPRESSED, std::memory_order_release);
+    return buffer + memoryRequired();
+}
+
+bool GroupElement::isDecompressed() const {
+    return state(g_)->status.load(std::memory_order_acquire) == POINT_READY;
+}
+
+void GroupElement::decompress_all(const std::vector<GroupElement*>& points, Executor& executor) {
+    std::size_t parts = std::max<std::size_t>(1, std::min(executor.concurrency(), (points.size() + 63) / 64));
+
+    // Each task takes a contiguous range and records its first failure
+    std::vector<std::size_t> failures(parts, points.size());
+    std::vector<std::function<void()>> tasks;
+    std::size_t chunk = (points.size() + parts - 1) / parts;
+    for (std::size_t part = 0; part < parts; part++) {
+        std::size_t begin = std::min(points.size(), part * chunk);
+        std::size_t end = std::min(points.size(), begin + chunk);
+        tasks.emplace_back([&points, &failures, part, begin, end] {
+            for (std::size_t i = begin; i < end; i++) {
+                point_state* s = state(points[i]->g_);
+                if (s->status.load(std::memory_order_acquire) != POINT_READY && !resolve(s) && failures[part] == points.size()) {
+                    failures[part] = i;
+                }
+            }
+        });
+    }
+    executor.run(tasks);
+
+    // Report the lowest failing index, so the outcome does not depend on scheduling
+    std::size_t failure = *std::min_element(failures.begin(), failures.end());
+    if (failure != points.size()) {
+        throw std::invalid_argument("GroupElement: deserialize failed at index " + std::to_string(failure));
+    }
+}
+
+bool GroupElement::lazy_deserialization() {
+    return lazy_deserialization_depth > 0;
+}
+
+GroupElement::LazyDeserialization::LazyDeserialization() {
+    lazy_deserialization_depth++;
+}
+
+GroupElement::LazyDeserialization::~LazyDeserialization() {
+    lazy_deserialization_depth--;
+}
+
+unsigned char* GroupElement::serialize_affine(unsigned char* buffer) const {
+    secp256k1_ge scratch;
+    const secp256k1_ge& value = *affine(g_, &scratch);
+    if (value.infinity) {
+        memset(buffer, 0, affine_size);
+    } else {
+        secp256k1_fe_get_b32(buffer, &value.x);
+        secp256k1_fe_get_b32(buffer + 32, &value.y);
+    }
+    return buffer + affine_size;
+}
+
+const unsigned char* GroupElement::deserialize_affine(const unsigned char* buffer) {
     secp256k1_ge result;
-    secp256k1_ge_set_xo_var(&result, &x, (int)oddness);
-    result.infinity = (int)infinity;
+    int in_range = secp256k1_fe_set_b32(&result.x, buffer);
+    in_range &= secp256k1_fe_set_b32(&result.y, buffer + 32);
+    result.infinity = secp256k1_fe_is_zero(&result.x) && secp256k1_fe_is_zero(&result.y);
 
-    secp256k1_gej_set_ge(reinterpret_cast<secp256k1_gej *>(g_), &result);
+    if (result.infinity) {
+        secp256k1_gej_set_infinity(&state(g_)->gej);
+    } else {
+        secp256k1_gej_set_ge(&state(g_)->gej, &result);
+    }
+    state(g_)->affine_status.store(AFFINE_NONE, std::memory_order_relaxed);
+    state(g_)->status.store(POINT_READY, std::memory_order_release);
 
-    if (!secp256k1_ge_is_valid_var(&result) && !result.infinity) {
+    if (!in_range || (!result.infinity && !secp256k1_ge_is_valid_var(&result))) {
         throw std::invalid_argument("GroupElement: deserialize failed");
     }
-    return buffer + memoryRequired();
+    set_affine(state(g_), result);
+    return buffer + affine_size;
+}
+
+void GroupElement::get_affine(const GroupElement* points, std::size_t count, void* result) {
+    secp256k1_ge* ge = reinterpret_cast<secp256k1_ge *>(result);
+
+    // Only points without a cached affine form take part in the batch inversion
+    std::vector<secp256k1_gej> gej;
+    std::vector<std::size_t> indices;
+    for (std::size_t i = 0; i < count; i++) {
+        const secp256k1_gej* g = point(points[i].g_);
+        const secp256k1_ge* cached = cached_affine(points[i].g_);
+        if (cached) {
+            ge[i] = *cached;
+        } else {
+            gej.emplace_back(*g);
+            indices.emplace_back(i);
+        }
+    }
+    if (gej.empty()) {
+        return;
+    }
+
+    std::vector<secp256k1_ge> computed(gej.size());
+    SPARK_COUNT(INVERSIONS, 1);
+    secp256k1_ge_set_all_gej_var(computed.data(), gej.data(), gej.size(), NULL);
+    for (std::size_t i = 0; i < computed.size(); i++) {
+        if (!computed[i].infinity) {
+            secp256k1_fe_normalize_var(&computed[i].x);
+            secp256k1_fe_normalize_var(&computed[i].y);
+        }
+        ge[indices[i]] = computed[i];
+    }
+}
+
+void GroupElement::serialize_affine(const std::vector<GroupElement>& points, unsigned char* buffer) {
+    std::vector<secp256k1_ge> ge(points.size());
+    get_affine(points.data(), points.size(), ge.data());
+
+    for (std::size_t i = 0; i < ge.size(); i++) {
+        unsigned char* out = buffer + i * affine_size;
+        if (ge[i].infinity) {
+            memset(out, 0, affine_size);
+            continue;
+        }
+        secp256k1_fe_get_b32(out, &ge[i].x);
+        secp256k1_fe_get_b32(out + 32, &ge[i].y);
+    }
 }
 
 std::vector<unsigned char> GroupElement::getvch() const {
@@ -546,7 +893,8 @@ std::vector<unsigned char> GroupElement::getvch() const {
 
 std::size_t GroupElement::hash() const
 {
-    auto ge = gej_to_ge(*reinterpret_cast<secp256k1_gej *>(g_));
+    secp256k1_ge scratch;
+    const secp256k1_ge& ge = *affine(g_, &scratch);
     std::array<unsigned char, 32 * 2> coord;
 
     if (ge.infinity) {
@@ -560,17 +908,20 @@ std::size_t GroupElement::hash() const
 }
 
 std::size_t GroupElement::get_hash() const {
-    secp256k1_fe x = reinterpret_cast<secp256k1_gej *>(g_)->x;
-    secp256k1_fe_normalize(&x);
+    // Taken from the affine x, so that points comparing equal hash equally whatever their z
+    secp256k1_ge scratch;
+    const secp256k1_fe& x = affine(g_, &scratch)->x;
     return x.n[0] ^ (x.n[1] << 16);
 }
 
 const void* GroupElement::get_value() const {
-    return g_;
+    return point(g_);
 }
 
 GroupElement& GroupElement::set_base_g() {
-    secp256k1_gej_set_ge(reinterpret_cast<secp256k1_gej *>(g_), &secp256k1_ge_const_g);
+    secp256k1_gej_set_ge(&state(g_)->gej, &secp256k1_ge_const_g);
+    set_affine(state(g_), secp256k1_ge_const_g);
+    state(g_)->status.store(POINT_READY, std::memory_order_release);
     return *this;
 }
 
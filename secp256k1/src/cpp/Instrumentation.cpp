@@ -0,0 +1,69 @@
+#include "../include/Instrumentation.h"
+
+namespace secp_primitives {
+
+namespace instrumentation {
+
+std::atomic<uint64_t> counters[COUNTER_COUNT];
+std::atomic<uint64_t> stage_calls[STAGE_COUNT];
+std::atomic<uint64_t> stage_nanoseconds[STAGE_COUNT];
+
+uint64_t Snapshot::estimated_hash_compressions() const {
+    return counters[HASH_BYTES] / 128 + counters[HASH_FINALIZATIONS];
+}
+
+Snapshot snapshot() {
+    Snapshot result;
+    for (std::size_t i = 0; i < COUNTER_COUNT; i++) {
+        result.counters[i] = counters[i].load(std::memory_order_relaxed);
+    }
+    for (std::size_t i = 0; i < STAGE_COUNT; i++) {
+        result.stages[i].calls = stage_calls[i].load(std::memory_order_relaxed);
+        result.stages[i].nanoseconds = stage_nanoseconds[i].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+void reset() {
+    for (std::size_t i = 0; i < COUNTER_COUNT; i++) {
+        counters[i].store(0, std::memory_order_relaxed);
+    }
+    for (std::size_t i = 0; i < STAGE_COUNT; i++) {
+        stage_calls[i].store(0, std::memory_order_relaxed);
+        stage_nanoseconds[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+const char* name(Counter counter) {
+    static const char* names[COUNTER_COUNT] = {
+        "scalar_multiplications",
+        "multiexponentiations",
+        "multiexponentiation_points",
+        "inversions",
+        "hash_bytes",
+        "hash_finalizations",
+        "allocations"
+    };
+    return counter < COUNTER_COUNT ? names[counter] : "unknown";
+}
+
+const char* name(Stage stage) {
+    static const char* names[STAGE_COUNT] = {
+        "spend_serialization",
+        "spend_verify",
+        "spend_verify_chaum",
+        "spend_verify_balance",
+        "spend_verify_range",
+        "spend_verify_membership",
+        "grootle_prove",
+        "grootle_verify",
+        "bpplus_prove",
+        "bpplus_verify",
+        "coin_identify"
+    };
+    return stage < STAGE_COUNT ? names[stage] : "unknown";
+}
+
+}// namespace instrumentation
+
+}// namespace secp_primitives
@@ -12,13 +12,28 @@
 #include "../src/scratch_impl.h"
 #include "../src/ecmult_impl.h"
 
+#include "../include/Instrumentation.h"
+
+#include <algorithm>
+
 
 typedef struct {
     secp256k1_scalar *sc;
-    secp256k1_gej *pt;
+    secp256k1_ge *pt;
 } ecmult_multi_data;
 
-int ecmult_multi_callback(secp256k1_scalar *sc, secp256k1_gej *pt, size_t idx, void *cbdata) {
+// Only variable-base multiplication is done here, which never reads the precomputed generator tables,
+// so an empty context is enough and is safe to share between threads
+static const secp256k1_ecmult_context* ecmult_context() {
+    static const secp256k1_ecmult_context ctx = [] {
+        secp256k1_ecmult_context result;
+        secp256k1_ecmult_context_init(&result);
+        return result;
+    }();
+    return &ctx;
+}
+
+int ecmult_multi_callback(secp256k1_scalar *sc, secp256k1_ge *pt, size_t idx, void *cbdata) {
     ecmult_multi_data *data = (ecmult_multi_data*) cbdata;
     *sc = data->sc[idx];
     *pt = data->pt[idx];
@@ -29,55 +44,127 @@ namespace secp_primitives {
 
 MultiExponent::MultiExponent(const MultiExponent& other)
         : sc_(new secp256k1_scalar[other.n_points])
-        , pt_(new secp256k1_gej[other.n_points])
+        , pt_(new secp256k1_ge[other.n_points])
         , n_points(other.n_points)
 {
+    SPARK_COUNT(ALLOCATIONS, 2);
     for(int i = 0; i < n_points; ++i)
     {
         (reinterpret_cast<secp256k1_scalar *>(sc_))[i] = (reinterpret_cast<secp256k1_scalar *>(other.sc_))[i];
-        (reinterpret_cast<secp256k1_gej *>(pt_))[i] = (reinterpret_cast<secp256k1_gej *>(other.pt_))[i];
+        (reinterpret_cast<secp256k1_ge *>(pt_))[i] = (reinterpret_cast<secp256k1_ge *>(other.pt_))[i];
     }
 }
 
 MultiExponent::MultiExponent(const std::vector<GroupElement>& generators, const std::vector<Scalar>& powers){
+    SPARK_COUNT(ALLOCATIONS, 2);
     sc_ = new secp256k1_scalar[powers.size()];
-    pt_ = new secp256k1_gej[generators.size()];
+    pt_ = new secp256k1_ge[generators.size()];
     n_points = generators.size();
     for(int i = 0; i < n_points; ++i)
     {
         (reinterpret_cast<secp256k1_scalar *>(sc_))[i] = *reinterpret_cast<const secp256k1_scalar *>(powers[i].get_value());
-        (reinterpret_cast<secp256k1_gej *>(pt_))[i] = *reinterpret_cast<const secp256k1_gej *>(generators[i].get_value());
+    }
+    // Deserialized points already have their affine form; any others share one inversion
+    GroupElement::get_affine(generators.data(), generators.size(), pt_);
+}
+
+MultiExponent::MultiExponent(const unsigned char* affine_generators, const std::vector<Scalar>& powers){
+    SPARK_COUNT(ALLOCATIONS, 2);
+    sc_ = new secp256k1_scalar[powers.size()];
+    pt_ = new secp256k1_ge[powers.size()];
+    n_points = powers.size();
+    for(int i = 0; i < n_points; ++i)
+    {
+        (reinterpret_cast<secp256k1_scalar *>(sc_))[i] = *reinterpret_cast<const secp256k1_scalar *>(powers[i].get_value());
+
+        const unsigned char* encoding = affine_generators + i * GroupElement::affine_size;
+        secp256k1_ge& ge = (reinterpret_cast<secp256k1_ge *>(pt_))[i];
+        secp256k1_fe_set_b32(&ge.x, encoding);
+        secp256k1_fe_set_b32(&ge.y, encoding + 32);
+        ge.infinity = secp256k1_fe_is_zero(&ge.x) && secp256k1_fe_is_zero(&ge.y);
     }
 }
 
 MultiExponent::~MultiExponent(){
     delete []reinterpret_cast<secp256k1_scalar *>(sc_);
-    delete []reinterpret_cast<secp256k1_gej *>(pt_);
+    delete []reinterpret_cast<secp256k1_ge *>(pt_);
 }
 
-GroupElement MultiExponent::get_multiple() {
-    secp256k1_gej r;
+// Scratch space for a multi-exponentiation of `n` points, enough for a single batch of whichever algorithm is used
+static size_t scratch_size(size_t n) {
+    if (n > ECMULT_PIPPENGER_THRESHOLD) {
+        int bucket_window = secp256k1_pippenger_bucket_window(n);
+        return secp256k1_pippenger_scratch_size(n, bucket_window) + PIPPENGER_SCRATCH_OBJECTS*ALIGNMENT;
+    }
+    return secp256k1_strauss_scratch_size(n) + STRAUSS_SCRATCH_OBJECTS*ALIGNMENT;
+}
 
+// Parts get_multiple(executor) splits `n` points into
+static std::size_t part_count(std::size_t n, const secp_primitives::Executor& executor) {
+    return std::min<std::size_t>(executor.concurrency(), n / secp_primitives::MultiExponent::min_part_size);
+}
+
+// Multi-exponentiation of `n` points, using its own scratch space so that parts can run concurrently
+static void multi_exponent(secp256k1_scalar* sc, secp256k1_ge* pt, size_t n, secp256k1_gej* r) {
     ecmult_multi_data data;
-    data.sc = reinterpret_cast<secp256k1_scalar *>(sc_);
-    data.pt = reinterpret_cast<secp256k1_gej *>(pt_);
-
-    secp256k1_scratch *scratch;
-    if (n_points > ECMULT_PIPPENGER_THRESHOLD) {
-        int bucket_window = secp256k1_pippenger_bucket_window(n_points);
-        size_t scratch_size = secp256k1_pippenger_scratch_size(n_points, bucket_window);
-        scratch = secp256k1_scratch_create(NULL, scratch_size + PIPPENGER_SCRATCH_OBJECTS*ALIGNMENT);
-    } else {
-        size_t scratch_size = secp256k1_strauss_scratch_size(n_points);
-        scratch = secp256k1_scratch_create(NULL, scratch_size + STRAUSS_SCRATCH_OBJECTS*ALIGNMENT);
-    }
+    data.sc = sc;
+    data.pt = pt;
 
-    secp256k1_ecmult_context ctx;
+    SPARK_COUNT(ALLOCATIONS, 1);
+    secp256k1_scratch *scratch = secp256k1_scratch_create(NULL, scratch_size(n));
 
-    secp256k1_ecmult_multi_var(&ctx, scratch, &r, NULL, ecmult_multi_callback, &data, n_points);
+    secp256k1_ecmult_multi_var(ecmult_context(), scratch, r, NULL, ecmult_multi_callback, &data, n);
 
     secp256k1_scratch_destroy(scratch);
+}
+
+GroupElement MultiExponent::get_multiple() {
+    SPARK_COUNT(MULTIEXPONENTIATIONS, 1);
+    SPARK_COUNT(MULTIEXPONENTIATION_POINTS, n_points);
+    secp256k1_gej r;
+    multi_exponent(reinterpret_cast<secp256k1_scalar *>(sc_), reinterpret_cast<secp256k1_ge *>(pt_), n_points, &r);
+    return  reinterpret_cast<secp256k1_scalar *>(&r);
+}
 
+std::size_t MultiExponent::memory_required(const std::size_t n_points, const Executor& executor) {
+    std::size_t result = n_points*(sizeof(secp256k1_scalar) + sizeof(secp256k1_ge));
+    std::size_t parts = part_count(n_points, executor);
+    if (parts <= 1) {
+        return result + scratch_size(n_points);
+    }
+    std::size_t part_size = (n_points + parts - 1) / parts;
+    return result + parts*(scratch_size(part_size) + sizeof(secp256k1_gej));
+}
+
+GroupElement MultiExponent::get_multiple(Executor& executor) {
+    std::size_t parts = part_count(n_points, executor);
+    if (parts <= 1) {
+        return get_multiple();
+    }
+
+    SPARK_COUNT(MULTIEXPONENTIATIONS, 1);
+    SPARK_COUNT(MULTIEXPONENTIATION_POINTS, n_points);
+
+    // Split the points into contiguous parts and add up their multiples
+    secp256k1_scalar* sc = reinterpret_cast<secp256k1_scalar *>(sc_);
+    secp256k1_ge* pt = reinterpret_cast<secp256k1_ge *>(pt_);
+    std::vector<secp256k1_gej> partial(parts);
+    std::vector<std::function<void()>> tasks;
+    std::size_t part_size = (n_points + parts - 1) / parts;
+    for (std::size_t i = 0; i < parts; i++) {
+        std::size_t begin = std::min<std::size_t>(n_points, i * part_size);
+        std::size_t end = std::min<std::size_t>(n_points, begin + part_size);
+        secp256k1_gej* result = &partial[i];
+        tasks.emplace_back([sc, pt, begin, end, result] {
+            multi_exponent(sc + begin, pt + begin, end - begin, result);
+        });
+    }
+    executor.run(tasks);
+
+    secp256k1_gej r = partial[0];
+    for (std::size_t i = 1; i < parts; i++) {
+        secp256k1_gej_add_var(&r, &r, &partial[i], NULL);
+    }
     return  reinterpret_cast<secp256k1_scalar *>(&r);
 }
 
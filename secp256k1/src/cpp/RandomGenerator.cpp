@@ -0,0 +1,158 @@
+#include "../include/RandomGenerator.h"
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+namespace secp_primitives {
+
+// Bumped in the child after a fork, so that it does not repeat the output of its parent
+static std::atomic<unsigned int> fork_generation(0);
+
+static void register_fork_handler() {
+#ifndef _WIN32
+    static std::once_flag registered;
+    std::call_once(registered, [] {
+        pthread_atfork(nullptr, nullptr, [] { fork_generation.fetch_add(1, std::memory_order_relaxed); });
+    });
+#endif
+}
+
+RandomGenerator& RandomGenerator::get() {
+    thread_local RandomGenerator generator;
+    return generator;
+}
+
+RandomGenerator::RandomGenerator()
+        : ctx_(EVP_CIPHER_CTX_new())
+        , available_(0)
+        , since_reseed_(0)
+        , fork_generation_(0)
+        , deterministic_(false)
+{
+    if (ctx_ == nullptr) {
+        throw std::runtime_error("RandomGenerator: unable to allocate cipher context");
+    }
+    register_fork_handler();
+    reseed();
+}
+
+RandomGenerator::RandomGenerator(const unsigned char* key)
+        : ctx_(EVP_CIPHER_CTX_new())
+        , available_(0)
+        , since_reseed_(0)
+        , fork_generation_(0)
+        , deterministic_(true)
+{
+    if (ctx_ == nullptr) {
+        throw std::runtime_error("RandomGenerator: unable to allocate cipher context");
+    }
+    std::memcpy(key_, key, sizeof(key_));
+}
+
+RandomGenerator::~RandomGenerator() {
+    OPENSSL_cleanse(key_, sizeof(key_));
+    OPENSSL_cleanse(buffer_, sizeof(buffer_));
+    EVP_CIPHER_CTX_free(reinterpret_cast<EVP_CIPHER_CTX *>(ctx_));
+}
+
+void RandomGenerator::reseed() {
+    if (RAND_bytes(key_, sizeof(key_)) != 1) {
+        throw std::runtime_error("RandomGenerator: unable to seed from the operating system");
+    }
+    OPENSSL_cleanse(buffer_, sizeof(buffer_));
+    available_ = 0;
+    since_reseed_ = 0;
+    fork_generation_ = fork_generation.load(std::memory_order_relaxed);
+}
+
+bool RandomGenerator::forked() const {
+    return !deterministic_ && fork_generation_ != fork_generation.load(std::memory_order_relaxed);
+}
+
+void RandomGenerator::refill() {
+    if (!deterministic_ && since_reseed_ >= reseed_interval) {
+        reseed();
+    }
+
+    // Each key is used for a single keystream block with a zero counter and nonce
+    static const unsigned char zero[sizeof(key_) + block_size] = { 0 };
+    static const unsigned char iv[16] = { 0 };
+    unsigned char stream[sizeof(key_) + block_size];
+    EVP_CIPHER_CTX* ctx = reinterpret_cast<EVP_CIPHER_CTX *>(ctx_);
+    int length = 0;
+    if (EVP_EncryptInit_ex(ctx, EVP_chacha20(), nullptr, key_, iv) != 1 ||
+            EVP_EncryptUpdate(ctx, stream, &length, zero, sizeof(stream)) != 1 ||
+            length != static_cast<int>(sizeof(stream))) {
+        throw std::runtime_error("RandomGenerator: keystream generation failed");
+    }
+
+    std::memcpy(key_, stream, sizeof(key_));
+    std::memcpy(buffer_, stream + sizeof(key_), block_size);
+    OPENSSL_cleanse(stream, sizeof(stream));
+    available_ = block_size;
+    since_reseed_ += block_size;
+}
+
+void RandomGenerator::fill(unsigned char* output, std::size_t size) {
+    // Bytes buffered before a fork are also in the other process, so they are dropped along with the key
+    if (forked()) {
+        reseed();
+    }
+
+    while (size > 0) {
+        if (available_ == 0) {
+            refill();
+        }
+
+        // Hand out bytes from the front of the unused part and erase them
+        std::size_t offset = block_size - available_;
+        std::size_t count = size < available_ ? size : available_;
+        std::memcpy(output, buffer_ + offset, count);
+        OPENSSL_cleanse(buffer_ + offset, count);
+        available_ -= count;
+        output += count;
+        size -= count;
+    }
+}
+
+void RandomGenerator::randomize(Scalar* scalars, std::size_t count) {
+    std::vector<unsigned char> bytes(32 * count);
+    fill(bytes.data(), bytes.size());
+    for (std::size_t i = 0; i < count; i++) {
+        scalars[i].generate(&bytes[32 * i]);
+
+        // Out of range or zero; this is rare enough to redraw one at a time
+        while (!scalars[i].isMember()) {
+            fill(&bytes[32 * i], 32);
+            scalars[i].generate(&bytes[32 * i]);
+        }
+    }
+    OPENSSL_cleanse(bytes.data(), bytes.size());
+}
+
+void RandomGenerator::randomize(std::vector<Scalar>& scalars) {
+    randomize(scalars.data(), scalars.size());
+}
+
+void RandomGenerator::randomize_from_system(Scalar& scalar) {
+    unsigned char bytes[32];
+    do {
+        if (RAND_bytes(bytes, sizeof(bytes)) != 1) {
+            throw std::runtime_error("RandomGenerator: unable to read randomness from the operating system");
+        }
+        scalar.generate(bytes);
+    } while (!scalar.isMember());
+    OPENSSL_cleanse(bytes, sizeof(bytes));
+}
+
+}// namespace secp_primitives
@@ -1,4 +1,5 @@
 #include "include/Scalar.h"
+#include "include/RandomGenerator.h"
 
 #include "include/secp256k1.h"
 
@@ -11,20 +12,23 @@
 #include "../hash_impl.h"
 #include "../hash.h"
 
+#include "../include/Instrumentation.h"
+
 #include <array>
 #include <sstream>
 #include <iostream>
-#include <openssl/rand.h>
 
 namespace secp_primitives {
 
 Scalar::Scalar()
    : value_(new secp256k1_scalar()) {
+    SPARK_COUNT(ALLOCATIONS, 1);
     secp256k1_scalar_clear(reinterpret_cast<secp256k1_scalar *>(value_));
 }
 
 Scalar::Scalar(uint64_t value)
    : value_(new secp256k1_scalar()) {
+    SPARK_COUNT(ALLOCATIONS, 1);
     unsigned char b32[32];
     for(int i = 0; i < 24; i++)
         b32[i] = 0;
@@ -41,16 +45,19 @@ Scalar::Scalar(uint64_t value)
 
 Scalar::Scalar(const unsigned char* str)
      : value_(new secp256k1_scalar()) {
+    SPARK_COUNT(ALLOCATIONS, 1);
     secp256k1_scalar_set_b32(reinterpret_cast<secp256k1_scalar *>(value_), str, 0);
 }
 
 Scalar::Scalar(const void *value)
    : value_(new secp256k1_scalar(*reinterpret_cast<const secp256k1_scalar *>(value))) {
+    SPARK_COUNT(ALLOCATIONS, 1);
 
 }
 
 Scalar::Scalar(const Scalar& other)
    : value_(new secp256k1_scalar(*reinterpret_cast<const secp256k1_scalar *>(other.value_))) {
+    SPARK_COUNT(ALLOCATIONS, 1);
 
 }
 
@@ -138,12 +145,24 @@ const void * Scalar::get_value() const {
     return value_;
 }
 
+std::size_t Scalar::allocated_size() {
+    return sizeof(secp256k1_scalar);
+}
+
 Scalar Scalar::inverse() const {
+    SPARK_COUNT(INVERSIONS, 1);
     secp256k1_scalar result;
     secp256k1_scalar_inverse(&result, reinterpret_cast<const secp256k1_scalar *>(value_));
  return &result;
 }
 
+Scalar Scalar::inverse_var() const {
+    SPARK_COUNT(INVERSIONS, 1);
+    secp256k1_scalar result;
+    secp256k1_scalar_inverse_var(&result, reinterpret_cast<const secp256k1_scalar *>(value_));
+    return &result;
+}
+
 Scalar Scalar::negate() const {
     secp256k1_scalar result;
     secp256k1_scalar_negate(&result, reinterpret_cast<const secp256k1_scalar *>(value_));
@@ -210,15 +229,8 @@ Scalar& Scalar::memberFromSeed(unsigned char* seed) {
 }
 
 Scalar& Scalar::randomize() {
-    unsigned char temp[32] = { 0 };
-
-    do {
-        if (RAND_bytes(temp, 32) != 1) {
-            throw "Unable to generate random Scalar";
-        }
-        generate(temp);
-    } while (!this->isMember()); // we need to ensure, generated value is valid and non 0
-
+    // The generator ensures the value is valid and non 0
+    RandomGenerator::get().randomize(this, 1);
     return *this;
 }
 
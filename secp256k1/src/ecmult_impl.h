@@ -541,10 +541,12 @@ static int secp256k1_ecmult_strauss_batch(const secp256k1_ecmult_context *ctx, s
     state.ps = (struct secp256k1_strauss_point_state*)secp256k1_scratch_alloc(scratch, n_points * sizeof(struct secp256k1_strauss_point_state));
 
     for (i = 0; i < n_points; i++) {
-        if (!cb(&scalars[i], &points[i] , i+cb_offset, cbdata)) {
+        secp256k1_ge point;
+        if (!cb(&scalars[i], &point, i+cb_offset, cbdata)) {
             secp256k1_scratch_deallocate_frame(scratch);
             return 0;
         }
+        secp256k1_gej_set_ge(&points[i], &point);
     }
     secp256k1_ecmult_strauss_wnaf(ctx, &state, r, n_points, points, scalars, inp_g_sc);
     secp256k1_scratch_deallocate_frame(scratch);
@@ -840,12 +842,10 @@ static int secp256k1_ecmult_pippenger_batch(const secp256k1_ecmult_context *ctx,
     }
 
     while (point_idx < n_points) {
-        secp256k1_gej point;
-        if (!cb(&scalars[idx], &point, point_idx + cb_offset, cbdata)) {
+        if (!cb(&scalars[idx], &points[idx], point_idx + cb_offset, cbdata)) {
             secp256k1_scratch_deallocate_frame(scratch);
             return 0;
         }
-        secp256k1_ge_set_gej(&points[idx], &point);
         idx++;
 #ifdef USE_ENDOMORPHISM
         secp256k1_ecmult_endo_split(&scalars[idx - 1], &scalars[idx], &points[idx - 1], &points[idx]);
@@ -21,6 +21,10 @@
 #error "Please select field implementation"
 #endif
 
+#if defined(USE_FIELD_INV_SAFEGCD) && !defined(USE_FIELD_5X52)
+#error "safegcd field inversion requires the 5x52 field implementation"
+#endif
+
 SECP256K1_INLINE static int secp256k1_fe_equal(const secp256k1_fe *a, const secp256k1_fe *b) {
     secp256k1_fe na;
     secp256k1_fe_negate(&na, a, 1);
@@ -133,7 +137,7 @@ static int secp256k1_fe_sqrt(secp256k1_fe *r, const secp256k1_fe *a) {
     return secp256k1_fe_equal(&t1, a);
 }
 
-static void secp256k1_fe_inv(secp256k1_fe *r, const secp256k1_fe *a) {
+static void secp256k1_fe_inv_builtin(secp256k1_fe *r, const secp256k1_fe *a) {
     secp256k1_fe x2, x3, x6, x9, x11, x22, x44, x88, x176, x220, x223, t1;
     int j;
 
@@ -223,8 +227,18 @@ static void secp256k1_fe_inv(secp256k1_fe *r, const secp256k1_fe *a) {
     secp256k1_fe_mul(r, a, &t1);
 }
 
+static void secp256k1_fe_inv(secp256k1_fe *r, const secp256k1_fe *a) {
+#if defined(USE_FIELD_INV_SAFEGCD)
+    secp256k1_fe_inv_safegcd(r, a);
+#else
+    secp256k1_fe_inv_builtin(r, a);
+#endif
+}
+
 static void secp256k1_fe_inv_var(secp256k1_fe *r, const secp256k1_fe *a) {
-#if defined(USE_FIELD_INV_BUILTIN)
+#if defined(USE_FIELD_INV_SAFEGCD)
+    secp256k1_fe_inv_safegcd_var(r, a);
+#elif defined(USE_FIELD_INV_BUILTIN)
     secp256k1_fe_inv(r, a);
 #elif defined(USE_FIELD_INV_NUM)
     secp256k1_num n, m;
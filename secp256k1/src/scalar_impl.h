@@ -14,6 +14,10 @@
 #include "libsecp256k1-config.h"
 #endif
 
+#if defined(USE_SCALAR_INV_SAFEGCD) && !defined(USE_SCALAR_4X64) && !defined(EXHAUSTIVE_TEST_ORDER)
+#error "safegcd scalar inversion requires the 4x64 scalar implementation"
+#endif
+
 #if defined(EXHAUSTIVE_TEST_ORDER)
 #include "scalar_low_impl.h"
 #elif defined(USE_SCALAR_4X64)
@@ -52,7 +56,7 @@ static void secp256k1_scalar_order_get_num(secp256k1_num *r) {
 }
 #endif
 
-static void secp256k1_scalar_inverse(secp256k1_scalar *r, const secp256k1_scalar *x) {
+static void secp256k1_scalar_inverse_builtin(secp256k1_scalar *r, const secp256k1_scalar *x) {
 #if defined(EXHAUSTIVE_TEST_ORDER)
     int i;
     *r = 0;
@@ -259,8 +263,18 @@ SECP256K1_INLINE static int secp256k1_scalar_is_even(const secp256k1_scalar *a)
 }
 #endif
 
+static void secp256k1_scalar_inverse(secp256k1_scalar *r, const secp256k1_scalar *x) {
+#if defined(USE_SCALAR_INV_SAFEGCD) && !defined(EXHAUSTIVE_TEST_ORDER)
+    secp256k1_scalar_inverse_safegcd(r, x);
+#else
+    secp256k1_scalar_inverse_builtin(r, x);
+#endif
+}
+
 static void secp256k1_scalar_inverse_var(secp256k1_scalar *r, const secp256k1_scalar *x) {
-#if defined(USE_SCALAR_INV_BUILTIN)
+#if defined(USE_SCALAR_INV_SAFEGCD) && !defined(EXHAUSTIVE_TEST_ORDER)
+    secp256k1_scalar_inverse_safegcd_var(r, x);
+#elif defined(USE_SCALAR_INV_BUILTIN)
     secp256k1_scalar_inverse(r, x);
 #elif defined(USE_SCALAR_INV_NUM)
     unsigned char b[32];
@@ -1751,6 +1751,85 @@ void run_field_inv_all_var(void) {
     }
 }
 
+#if defined(USE_FIELD_INV_SAFEGCD)
+void test_inverse_safegcd_fe(const secp256k1_fe *x) {
+    secp256k1_fe r1, r2, r3, xn = *x;
+    secp256k1_fe_inv_safegcd(&r1, x);
+    secp256k1_fe_inv_safegcd_var(&r2, x);
+    secp256k1_fe_inv_builtin(&r3, x);
+    CHECK(check_fe_equal(&r1, &r3));
+    CHECK(check_fe_equal(&r2, &r3));
+    if (!secp256k1_fe_normalizes_to_zero_var(&xn)) {
+        CHECK(check_fe_inverse(x, &r1));
+    } else {
+        CHECK(secp256k1_fe_normalizes_to_zero_var(&r1));
+        CHECK(secp256k1_fe_normalizes_to_zero_var(&r2));
+    }
+}
+
+void test_inverse_safegcd_scalar(const secp256k1_scalar *x) {
+    secp256k1_scalar r1, r2, r3;
+    secp256k1_scalar_inverse_safegcd(&r1, x);
+    secp256k1_scalar_inverse_safegcd_var(&r2, x);
+    secp256k1_scalar_inverse_builtin(&r3, x);
+    CHECK(secp256k1_scalar_eq(&r1, &r3));
+    CHECK(secp256k1_scalar_eq(&r2, &r3));
+    if (!secp256k1_scalar_is_zero(x)) {
+        secp256k1_scalar_mul(&r1, &r1, x);
+        CHECK(secp256k1_scalar_is_one(&r1));
+    } else {
+        CHECK(secp256k1_scalar_is_zero(&r1));
+    }
+}
+
+/* Compare the safegcd inverses against the addition chains, on random values and on values whose
+ * binary expansions stress the divsteps: small, near the modulus, and with long runs of equal bits. */
+void run_inverse_safegcd(void) {
+    static const secp256k1_fe fe_cases[] = {
+        SECP256K1_FE_CONST(0, 0, 0, 0, 0, 0, 0, 0),
+        SECP256K1_FE_CONST(0, 0, 0, 0, 0, 0, 0, 1),
+        SECP256K1_FE_CONST(0, 0, 0, 0, 0, 0, 0, 2),
+        SECP256K1_FE_CONST(0xFFFFFFFFUL, 0xFFFFFFFFUL, 0xFFFFFFFFUL, 0xFFFFFFFFUL,
+                           0xFFFFFFFFUL, 0xFFFFFFFFUL, 0xFFFFFFFEUL, 0xFFFFFC2EUL),
+        SECP256K1_FE_CONST(0x80000000UL, 0, 0, 0, 0, 0, 0, 0),
+        SECP256K1_FE_CONST(0x7FFFFFFFUL, 0xFFFFFFFFUL, 0xFFFFFFFFUL, 0xFFFFFFFFUL,
+                           0xFFFFFFFFUL, 0xFFFFFFFFUL, 0xFFFFFFFFUL, 0xFFFFFFFFUL),
+        SECP256K1_FE_CONST(0, 0, 0, 1, 0, 0, 0, 0),
+        SECP256K1_FE_CONST(0, 0, 0, 0, 0, 0, 1, 0x000003D1UL)
+    };
+    static const secp256k1_scalar scalar_cases[] = {
+        SECP256K1_SCALAR_CONST(0, 0, 0, 0, 0, 0, 0, 0),
+        SECP256K1_SCALAR_CONST(0, 0, 0, 0, 0, 0, 0, 1),
+        SECP256K1_SCALAR_CONST(0, 0, 0, 0, 0, 0, 0, 2),
+        SECP256K1_SCALAR_CONST(0xFFFFFFFFUL, 0xFFFFFFFFUL, 0xFFFFFFFFUL, 0xFFFFFFFEUL,
+                               0xBAAEDCE6UL, 0xAF48A03BUL, 0xBFD25E8CUL, 0xD0364140UL),
+        SECP256K1_SCALAR_CONST(0x80000000UL, 0, 0, 0, 0, 0, 0, 0),
+        SECP256K1_SCALAR_CONST(0x7FFFFFFFUL, 0xFFFFFFFFUL, 0xFFFFFFFFUL, 0xFFFFFFFFUL,
+                               0xFFFFFFFFUL, 0xFFFFFFFFUL, 0xFFFFFFFFUL, 0xFFFFFFFFUL),
+        SECP256K1_SCALAR_CONST(0, 0, 0, 1, 0, 0, 0, 0)
+    };
+    secp256k1_fe x;
+    secp256k1_scalar s;
+    size_t i;
+
+    for (i = 0; i < sizeof(fe_cases) / sizeof(fe_cases[0]); i++) {
+        test_inverse_safegcd_fe(&fe_cases[i]);
+    }
+    for (i = 0; i < sizeof(scalar_cases) / sizeof(scalar_cases[0]); i++) {
+        test_inverse_safegcd_scalar(&scalar_cases[i]);
+    }
+    for (i = 0; i < (size_t)(100 * count); i++) {
+        random_fe(&x);
+        test_inverse_safegcd_fe(&x);
+        random_field_element_test(&x);
+        secp256k1_fe_normalize(&x);
+        test_inverse_safegcd_fe(&x);
+        random_scalar_order_test(&s);
+        test_inverse_safegcd_scalar(&s);
+    }
+}
+#endif
+
 void run_sqr(void) {
     secp256k1_fe x, s;
 
@@ -4460,6 +4539,9 @@ int main(int argc, char **argv) {
     run_field_inv();
     run_field_inv_var();
     run_field_inv_all_var();
+#if defined(USE_FIELD_INV_SAFEGCD)
+    run_inverse_safegcd();
+#endif
     run_field_misc();
     run_field_convert();
     run_sqr();
@@ -1,90 +1,170 @@
 #include "aead.h"
 
+#include <memory>
+#include <string.h>
+
 namespace spark {
 
-// Perform authenticated encryption with ChaCha20-Poly1305 using key commitment
-AEADEncryptedData AEAD::encrypt(const GroupElement& prekey, const std::string additional_data, CDataStream& data) {
-	// Set up the result structure
-	AEADEncryptedData result;
+// For our application, we can safely use a zero nonce since keys are never reused
+static const unsigned char AEAD_IV[AEAD_IV_SIZE] = {};
+
+struct CipherContextDeleter {
+	void operator()(EVP_CIPHER_CTX* ctx) const {
+		EVP_CIPHER_CTX_free(ctx);
+	}
+};
+
+// Fetch this thread's cipher context, which is reinitialized with a fresh key on every use
+static EVP_CIPHER_CTX* thread_cipher_context() {
+	static thread_local std::unique_ptr<EVP_CIPHER_CTX, CipherContextDeleter> ctx(EVP_CIPHER_CTX_new());
+	if (!ctx) {
+		throw std::runtime_error("Unable to allocate AEAD cipher context");
+	}
 
+	return ctx.get();
+}
+
+AEADEncryptedDataView::AEADEncryptedDataView()
+	: ciphertext(nullptr), ciphertext_size(0), tag(nullptr), tag_size(0), key_commitment(nullptr), key_commitment_size(0) {}
+
+AEADEncryptedDataView::AEADEncryptedDataView(const AEADEncryptedData& data)
+	: ciphertext(data.ciphertext.data()), ciphertext_size(data.ciphertext.size())
+	, tag(data.tag.data()), tag_size(data.tag.size())
+	, key_commitment(data.key_commitment.data()), key_commitment_size(data.key_commitment.size()) {}
+
+AEADEngine::AEADEngine(const std::string& associated_data)
+	: associated_data(associated_data.begin(), associated_data.end()) {}
+
+// Perform authenticated encryption with ChaCha20-Poly1305 using key commitment
+void AEADEngine::encrypt(const GroupElement& prekey, const unsigned char* data, const std::size_t size, AEADEncryptedData& result) const {
 	// Derive the key and commitment
-	std::vector<unsigned char> key = SparkUtils::kdf_aead(prekey);
-	result.key_commitment = SparkUtils::commit_aead(prekey);
+	std::vector<unsigned char> key;
+	SparkUtils::kdf_commit_aead(prekey, key, result.key_commitment);
 
 	// Internal size tracker; we know the size of the data already, and can ignore
 	int TEMP;
 
-	// For our application, we can safely use a zero nonce since keys are never reused
-	std::vector<unsigned char> iv;
-	iv.resize(AEAD_IV_SIZE);
-
 	// Set up the cipher
-	EVP_CIPHER_CTX* ctx;
-	ctx = EVP_CIPHER_CTX_new();
-	EVP_EncryptInit_ex(ctx, EVP_chacha20_poly1305(), NULL, key.data(), iv.data());
+	EVP_CIPHER_CTX* ctx = thread_cipher_context();
+	EVP_EncryptInit_ex(ctx, EVP_chacha20_poly1305(), NULL, key.data(), AEAD_IV);
 
 	// Include the associated data
-	std::vector<unsigned char> additional_data_bytes(additional_data.begin(), additional_data.end());
-	EVP_EncryptUpdate(ctx, NULL, &TEMP, additional_data_bytes.data(), additional_data_bytes.size());
+	EVP_EncryptUpdate(ctx, NULL, &TEMP, this->associated_data.data(), this->associated_data.size());
 
 	// Encrypt the plaintext
-	result.ciphertext.resize(data.size());
-	EVP_EncryptUpdate(ctx, result.ciphertext.data(), &TEMP, reinterpret_cast<unsigned char *>(data.data()), data.size());
+	result.ciphertext.resize(size);
+	EVP_EncryptUpdate(ctx, result.ciphertext.data(), &TEMP, data, size);
 	EVP_EncryptFinal_ex(ctx, NULL, &TEMP);
 
 	// Get the tag
 	result.tag.resize(AEAD_TAG_SIZE);
 	EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_GET_TAG, AEAD_TAG_SIZE, result.tag.data());
+}
 
-	// Clean up
-	EVP_CIPHER_CTX_free(ctx);
+AEADEncryptedData AEADEngine::encrypt(const GroupElement& prekey, CDataStream& data) const {
+	AEADEncryptedData result;
+	encrypt(prekey, reinterpret_cast<const unsigned char *>(data.data()), data.size(), result);
 
 	return result;
 }
 
-// Perform authenticated decryption with ChaCha20-Poly1305 using key commitment
-CDataStream AEAD::decrypt_and_verify(const GroupElement& prekey, const std::string additional_data, AEADEncryptedData& data) {
-	// Derive the key and commitment
-	std::vector<unsigned char> key = SparkUtils::kdf_aead(prekey);
-	std::vector<unsigned char> key_commitment = SparkUtils::commit_aead(prekey);
-
-	// Assert that the key commitment is valid
-	if (key_commitment != data.key_commitment) {
-		throw std::runtime_error("Bad AEAD key commitment");
+// Perform authenticated decryption with ChaCha20-Poly1305 using an already-derived key
+bool AEADEngine::decrypt_with_key(const std::vector<unsigned char>& key, const AEADEncryptedDataView& data, unsigned char* plaintext) const {
+	if (data.tag_size != AEAD_TAG_SIZE) {
+		return false;
 	}
 
-	// Set up the result
-	CDataStream result(SER_NETWORK, PROTOCOL_VERSION);
-
 	// Internal size tracker; we know the size of the data already, and can ignore
 	int TEMP;
 
-	// For our application, we can safely use a zero nonce since keys are never reused
-	std::vector<unsigned char> iv;
-	iv.resize(AEAD_IV_SIZE);
-
 	// Set up the cipher
-	EVP_CIPHER_CTX* ctx;
-	ctx = EVP_CIPHER_CTX_new();
-	EVP_DecryptInit_ex(ctx, EVP_chacha20_poly1305(), NULL, key.data(), iv.data());
+	EVP_CIPHER_CTX* ctx = thread_cipher_context();
+	EVP_DecryptInit_ex(ctx, EVP_chacha20_poly1305(), NULL, key.data(), AEAD_IV);
 
 	// Include the associated data
-	std::vector<unsigned char> additional_data_bytes(additional_data.begin(), additional_data.end());
-	EVP_DecryptUpdate(ctx, NULL, &TEMP, additional_data_bytes.data(), additional_data_bytes.size());
+	EVP_DecryptUpdate(ctx, NULL, &TEMP, this->associated_data.data(), this->associated_data.size());
 
 	// Decrypt the ciphertext
-	result.resize(data.ciphertext.size());
-	EVP_DecryptUpdate(ctx, reinterpret_cast<unsigned char *>(result.data()), &TEMP, data.ciphertext.data(), data.ciphertext.size());
-	
+	EVP_DecryptUpdate(ctx, plaintext, &TEMP, data.ciphertext, data.ciphertext_size);
+
 	// Set the expected tag
-	EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_TAG, AEAD_TAG_SIZE, data.tag.data());
+	EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_TAG, AEAD_TAG_SIZE, const_cast<unsigned char *>(data.tag));
+
+	// Decrypt
+	return EVP_DecryptFinal_ex(ctx, NULL, &TEMP) == 1;
+}
+
+// Perform authenticated decryption with ChaCha20-Poly1305 using key commitment
+bool AEADEngine::decrypt(const GroupElement& prekey, const AEADEncryptedDataView& data, unsigned char* plaintext) const {
+	// Derive the key and commitment
+	std::vector<unsigned char> key;
+	std::vector<unsigned char> key_commitment;
+	SparkUtils::kdf_commit_aead(prekey, key, key_commitment);
+
+	// Assert that the key commitment is valid
+	if (data.key_commitment_size != key_commitment.size() || memcmp(data.key_commitment, key_commitment.data(), key_commitment.size()) != 0) {
+		return false;
+	}
+
+	return decrypt_with_key(key, data, plaintext);
+}
+
+bool AEADEngine::decrypt(const GroupElement& prekey, const AEADEncryptedData& data, unsigned char* plaintext) const {
+	return decrypt(prekey, AEADEncryptedDataView(data), plaintext);
+}
+
+void AEADEngine::decrypt_and_verify(const GroupElement& prekey, const AEADEncryptedData& data, CDataStream& result) const {
+	// Derive the key and commitment
+	std::vector<unsigned char> key;
+	std::vector<unsigned char> key_commitment;
+	SparkUtils::kdf_commit_aead(prekey, key, key_commitment);
+
+	// Assert that the key commitment is valid
+	if (key_commitment != data.key_commitment) {
+		throw std::runtime_error("Bad AEAD key commitment");
+	}
 
-	// Decrypt and clean up
-	int ret = EVP_DecryptFinal_ex(ctx, NULL, &TEMP);
-	EVP_CIPHER_CTX_free(ctx);
-	if (ret != 1) {
+	result.clear();
+	result.resize(data.ciphertext.size());
+	if (!decrypt_with_key(key, data, reinterpret_cast<unsigned char *>(result.data()))) {
 		throw std::runtime_error("Bad AEAD authentication");
 	}
+}
+
+std::vector<bool> AEADEngine::decrypt(
+	const std::vector<GroupElement>& prekeys,
+	const std::vector<const AEADEncryptedData*>& data,
+	std::vector<CDataStream>& results
+) const {
+	if (prekeys.size() != data.size()) {
+		throw std::invalid_argument("Bad AEAD batch size");
+	}
+
+	// Reuse any streams the caller already has
+	while (results.size() < data.size()) {
+		results.emplace_back(SER_NETWORK, PROTOCOL_VERSION);
+	}
+
+	std::vector<bool> valid(data.size());
+	for (std::size_t i = 0; i < data.size(); i++) {
+		results[i].clear();
+		results[i].resize(data[i]->ciphertext.size());
+		valid[i] = decrypt(prekeys[i], *data[i], reinterpret_cast<unsigned char *>(results[i].data()));
+		if (!valid[i]) {
+			results[i].clear();
+		}
+	}
+
+	return valid;
+}
+
+AEADEncryptedData AEAD::encrypt(const GroupElement& prekey, const std::string additional_data, CDataStream& data) {
+	return AEADEngine(additional_data).encrypt(prekey, data);
+}
+
+CDataStream AEAD::decrypt_and_verify(const GroupElement& prekey, const std::string additional_data, AEADEncryptedData& data) {
+	CDataStream result(SER_NETWORK, PROTOCOL_VERSION);
+	AEADEngine(additional_data).decrypt_and_verify(prekey, data, result);
 
 	return result;
 }
@@ -20,6 +20,49 @@ struct AEADEncryptedData {
     }
 };
 
+// Borrowed view of encrypted data, e.g. pointing straight into a serialized coin
+struct AEADEncryptedDataView {
+	AEADEncryptedDataView();
+	AEADEncryptedDataView(const AEADEncryptedData& data);
+
+	const unsigned char* ciphertext;
+	std::size_t ciphertext_size;
+	const unsigned char* tag;
+	std::size_t tag_size;
+	const unsigned char* key_commitment;
+	std::size_t key_commitment_size;
+};
+
+// ChaCha20-Poly1305 with key commitment for a fixed associated data label
+// Each thread reuses a single cipher context, and decryption writes into caller-provided buffers
+class AEADEngine {
+public:
+	AEADEngine(const std::string& associated_data);
+
+	void encrypt(const GroupElement& prekey, const unsigned char* data, const std::size_t size, AEADEncryptedData& result) const;
+	AEADEncryptedData encrypt(const GroupElement& prekey, CDataStream& data) const;
+
+	// Decrypt into `plaintext`, which must hold `data.ciphertext.size()` bytes; returns false on any failure
+	bool decrypt(const GroupElement& prekey, const AEADEncryptedData& data, unsigned char* plaintext) const;
+	bool decrypt(const GroupElement& prekey, const AEADEncryptedDataView& data, unsigned char* plaintext) const;
+
+	// Decrypt into a reusable stream; throws on failure
+	void decrypt_and_verify(const GroupElement& prekey, const AEADEncryptedData& data, CDataStream& result) const;
+
+	// Decrypt a batch of ciphertexts, resizing `results` as needed
+	// Failures are expected when scanning, so they are reported per entry instead of thrown
+	std::vector<bool> decrypt(
+		const std::vector<GroupElement>& prekeys,
+		const std::vector<const AEADEncryptedData*>& data,
+		std::vector<CDataStream>& results
+	) const;
+
+private:
+	bool decrypt_with_key(const std::vector<unsigned char>& key, const AEADEncryptedDataView& data, unsigned char* plaintext) const;
+
+	std::vector<unsigned char> associated_data;
+};
+
 class AEAD {
 public:
 	static AEADEncryptedData encrypt(const GroupElement& prekey, const std::string additional_data, CDataStream& data);
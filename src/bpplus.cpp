@@ -13,12 +13,14 @@ BPPlus::BPPlus(
         const GroupElement& H_,
         const std::vector<GroupElement>& Gi_,
         const std::vector<GroupElement>& Hi_,
-        const std::size_t N_)
+        const std::size_t N_,
+        Executor& executor_)
         : G (G_)
         , H (H_)
         , Gi (Gi_)
         , Hi (Hi_)
         , N (N_)
+        , executor (&executor_)
 {
     if (Gi.size() != Hi.size()) {
         throw std::invalid_argument("Bad BPPlus generator sizes!");
@@ -57,6 +59,8 @@ void BPPlus::prove(
         const std::vector<Scalar>& unpadded_r,
         const std::vector<GroupElement>& unpadded_C,  
         BPPlusProof& proof) {
+    SPARK_TIME_STAGE(BPPLUS_PROVE);
+
     // Bulletproofs+ are only defined when the input set size is a nonzero power of two
     // To get around this, we can trivially pad the input set with zero commitments
     // We make sure this is done canonically in a way that's transparent to the caller
@@ -200,12 +204,17 @@ void BPPlus::prove(
     std::vector<Scalar> b1(aR1);
     std::size_t N1 = N*M;
 
+    // Masks for every round, drawn at once
+    std::vector<Scalar> d_masks(2*log2(N*M));
+    RandomGenerator::get().randomize(d_masks);
+    std::size_t round = 0;
+
     while (N1 > 1) {
         N1 /= 2;
 
-        Scalar dL, dR;
-        dL.randomize();
-        dR.randomize();
+        const Scalar& dL = d_masks[2*round];
+        const Scalar& dR = d_masks[2*round + 1];
+        round++;
 
         // Compute cL, cR
         Scalar cL, cR;
@@ -222,7 +231,7 @@ void BPPlus::prove(
         R_points.reserve(2*N1 + 2);
         L_scalars.reserve(2*N1 + 2);
         R_scalars.reserve(2*N1 + 2);
-        Scalar y_N1_inverse = y_powers[N1].inverse();
+        Scalar y_N1_inverse = y_powers[N1].inverse_var();
         for (std::size_t i = 0; i < N1; i++) {
             L_points.emplace_back(Gi1[i+N1]);
             L_scalars.emplace_back(a1[i]*y_N1_inverse);
@@ -253,7 +262,7 @@ void BPPlus::prove(
         transcript.add("L", L_);
         transcript.add("R", R_);
         Scalar e = transcript.challenge("e");
-        Scalar e_inverse = e.inverse();
+        Scalar e_inverse = e.inverse_var();
 
         // Compress round elements
         for (std::size_t i = 0; i < N1; i++) {
@@ -298,6 +307,8 @@ bool BPPlus::verify(const std::vector<GroupElement>& unpadded_C, const BPPlusPro
 }
 
 bool BPPlus::verify(const std::vector<std::vector<GroupElement>>& unpadded_C, const std::vector<BPPlusProof>& proofs) {
+    SPARK_TIME_STAGE(BPPLUS_VERIFY);
+
     // Preprocess all proofs
     if (!(unpadded_C.size() == proofs.size())) {
         return false;
@@ -388,7 +399,7 @@ bool BPPlus::verify(const std::vector<std::vector<GroupElement>>& unpadded_C, co
         if (y == ZERO) {
             return false;
         }
-        Scalar y_inverse = y.inverse();
+        Scalar y_inverse = y.inverse_var();
         Scalar y_NM = y;
         for (std::size_t i = 0; i < rounds; i++) {
             y_NM = y_NM.square();
@@ -411,7 +422,7 @@ bool BPPlus::verify(const std::vector<std::vector<GroupElement>>& unpadded_C, co
                 return false;
             }
             e.emplace_back(e_);
-            e_inverse.emplace_back(e[j].inverse());
+            e_inverse.emplace_back(e[j].inverse_var());
         }
 
         transcript.add("A1", proof.A1);
@@ -527,7 +538,7 @@ bool BPPlus::verify(const std::vector<std::vector<GroupElement>>& unpadded_C, co
 
     // Test the batch
     secp_primitives::MultiExponent multiexp(points, scalars);
-    return multiexp.get_multiple().isInfinity();
+    return multiexp.get_multiple(*this->executor).isInfinity();
 }
 
 }
\ No newline at end of file
@@ -16,7 +16,8 @@ public:
         const GroupElement& H,
         const std::vector<GroupElement>& Gi,
         const std::vector<GroupElement>& Hi,
-        const std::size_t N);
+        const std::size_t N,
+        Executor& executor = Executor::get_default());
     
     void prove(const std::vector<Scalar>& unpadded_v, const std::vector<Scalar>& unpadded_r, const std::vector<GroupElement>& unpadded_C, BPPlusProof& proof);
     bool verify(const std::vector<GroupElement>& unpadded_C, const BPPlusProof& proof); // single proof
@@ -29,6 +30,7 @@ private:
     std::vector<GroupElement> Hi;
     std::size_t N;
     Scalar TWO_N_MINUS_ONE;
+    Executor* executor; // splits the batch verification multiscalar multiplication
 };
 
 }
@@ -22,6 +22,16 @@ public:
         return 3*GroupElement::memoryRequired() + 3*Scalar::memoryRequired() + L.size()*GroupElement::memoryRequired() + R.size()*GroupElement::memoryRequired();
     }
 
+    // Serialized size of a proof for M commitments of N bits each, with M padded to a power of 2 as the prover does
+    static inline std::size_t serializedSize(std::size_t N, std::size_t M) {
+        std::size_t padded_M = 1;
+        while (padded_M < M)
+            padded_M <<= 1;
+        std::size_t rounds = int_log2(N*padded_M);
+
+        return 3*GroupElement::memoryRequired() + 3*Scalar::memoryRequired() + 2*(GetSizeOfCompactSize(rounds) + rounds*GroupElement::memoryRequired());
+    }
+
     ADD_SERIALIZE_METHODS;
     template <typename Stream, typename Operation>
     inline void SerializationOp(Stream& s, Operation ser_action) {
@@ -52,10 +52,8 @@ void Chaum::prove(
     r.resize(n);
     std::vector<Scalar> s;
     s.resize(n);
-    for (std::size_t i = 0; i < n; i++) {
-        r[i].randomize();
-        s[i].randomize();
-    }
+    RandomGenerator::get().randomize(r);
+    RandomGenerator::get().randomize(s);
     Scalar t;
     t.randomize();
 
@@ -11,6 +11,11 @@ public:
         return GroupElement::memoryRequired() + A2.size()*GroupElement::memoryRequired() + t1.size()*Scalar::memoryRequired() + 2*Scalar::memoryRequired();
     }
 
+    // Serialized size of a proof over n statements
+    static inline std::size_t serializedSize(std::size_t n) {
+        return GroupElement::memoryRequired() + GetSizeOfCompactSize(n) + n*GroupElement::memoryRequired() + GetSizeOfCompactSize(n) + n*Scalar::memoryRequired() + 2*Scalar::memoryRequired();
+    }
+
     ADD_SERIALIZE_METHODS;
     template <typename Stream, typename Operation>
     inline void SerializationOp(Stream& s, Operation ser_action) {
@@ -1,10 +1,53 @@
 #include "coin.h"
 #include "../bitcoin/hash.h"
+#include "../bitcoin/crypto/common.h"
+
+#include <string.h>
 
 namespace spark {
 
 using namespace secp_primitives;
 
+// Shared engine for the recipient data of the given coin type
+static const AEADEngine& recipient_data_aead(const char type) {
+	static const AEADEngine mint_aead(AEAD_LABEL_MINT);
+	static const AEADEngine spend_aead(AEAD_LABEL_SPEND);
+
+	return type == COIN_TYPE_MINT ? mint_aead : spend_aead;
+}
+
+// Check decrypted recipient data against a coin's commitments
+// Commitments are fetched only when needed, so a coin view decompresses as little as possible
+template <typename GetC, typename GetS>
+static bool validate_recipient_data(
+	const Params* params,
+	const GroupElement& K,
+	GetC get_C,
+	GetS get_S,
+	const std::vector<unsigned char>& serial_context,
+	const IncomingViewKey& incoming_view_key,
+	IdentifiedCoinData& data
+) {
+	// Check recovery key
+	if (SparkUtils::hash_div(data.d)*SparkUtils::hash_k(data.k) != K) {
+        return false;
+	}
+
+	// Check value commitment
+	if (params->get_G_table().multiply(Scalar(data.v)) + params->get_H_table().multiply(SparkUtils::hash_val(data.k)) != get_C()) {
+        return false;
+	}
+
+	// Check serial commitment
+	data.i = incoming_view_key.get_diversifier(data.d);
+
+	if (params->get_F_table().multiply(SparkUtils::hash_ser(data.k, serial_context) + SparkUtils::hash_Q2(incoming_view_key.get_s1(), data.i)) + incoming_view_key.get_P2() != get_S()) {
+        return false;
+	}
+
+	return true;
+}
+
 Coin::Coin() {}
 
 Coin::Coin(const Params* params)
@@ -39,10 +82,10 @@ Coin::Coin(
 	this->K = SparkUtils::hash_div(address.get_d())*SparkUtils::hash_k(k);
 
 	// Construct the serial commitment
-	this->S = this->params->get_F()*SparkUtils::hash_ser(k, serial_context) + address.get_Q2();
+	this->S = this->params->get_F_table().multiply(SparkUtils::hash_ser(k, serial_context)) + address.get_Q2();
 
 	// Construct the value commitment
-	this->C = this->params->get_G()*Scalar(v) + this->params->get_H()*SparkUtils::hash_val(k);
+	this->C = this->params->get_G_table().multiply(Scalar(v)) + this->params->get_H_table().multiply(SparkUtils::hash_val(k));
 
 	// Check the memo validity, and pad if needed
 	if (memo.size() > this->params->get_memo_bytes()) {
@@ -66,7 +109,7 @@ Coin::Coin(
 		r.memo = std::string(padded_memo.begin(), padded_memo.end());
 		CDataStream r_stream(SER_NETWORK, PROTOCOL_VERSION);
 		r_stream << r;
-		this->r_ = AEAD::encrypt(address.get_Q1()*SparkUtils::hash_k(k), "Mint coin data", r_stream);
+		this->r_ = recipient_data_aead(COIN_TYPE_MINT).encrypt(address.get_Q1()*SparkUtils::hash_k(k), r_stream);
 	} else {
 		// Encrypt recipient data
 		SpendCoinRecipientData r;
@@ -76,7 +119,7 @@ Coin::Coin(
 		r.memo = std::string(padded_memo.begin(), padded_memo.end());
 		CDataStream r_stream(SER_NETWORK, PROTOCOL_VERSION);
 		r_stream << r;
-		this->r_ = AEAD::encrypt(address.get_Q1()*SparkUtils::hash_k(k), "Spend coin data", r_stream);
+		this->r_ = recipient_data_aead(COIN_TYPE_SPEND).encrypt(address.get_Q1()*SparkUtils::hash_k(k), r_stream);
 	}
 }
 
@@ -86,24 +129,15 @@ bool Coin::validate(
 	const IncomingViewKey& incoming_view_key,
 	IdentifiedCoinData& data
 ) {
-	// Check recovery key
-	if (SparkUtils::hash_div(data.d)*SparkUtils::hash_k(data.k) != this->K) {
-        return false;
-	}
-
-	// Check value commitment
-	if (this->params->get_G()*Scalar(data.v) + this->params->get_H()*SparkUtils::hash_val(data.k) != this->C) {
-        return false;
-	}
-
-	// Check serial commitment
-	data.i = incoming_view_key.get_diversifier(data.d);
-
-	if (this->params->get_F()*(SparkUtils::hash_ser(data.k, this->serial_context) + SparkUtils::hash_Q2(incoming_view_key.get_s1(), data.i)) + incoming_view_key.get_P2() != this->S) {
-        return false;
-	}
-
-	return true;
+	return validate_recipient_data(
+		this->params,
+		this->K,
+		[this]() -> const GroupElement& { return this->C; },
+		[this]() -> const GroupElement& { return this->S; },
+		this->serial_context,
+		incoming_view_key,
+		data
+	);
 }
 
 // Recover a coin
@@ -117,7 +151,9 @@ RecoveredCoinData Coin::recover(const FullViewKey& full_view_key, const Identifi
 
 // Identify a coin
 IdentifiedCoinData Coin::identify(const IncomingViewKey& incoming_view_key) {
+	SPARK_TIME_STAGE(COIN_IDENTIFY);
 	IdentifiedCoinData data;
+	CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
 
 	// Deserialization means this process depends on the coin type
 	if (this->type == COIN_TYPE_MINT) {
@@ -125,7 +161,7 @@ IdentifiedCoinData Coin::identify(const IncomingViewKey& incoming_view_key) {
 
 		try {
 			// Decrypt recipient data
-			CDataStream stream = AEAD::decrypt_and_verify(this->K*incoming_view_key.get_s1(), "Mint coin data", this->r_);
+			recipient_data_aead(COIN_TYPE_MINT).decrypt_and_verify(this->K*incoming_view_key.get_s1(), this->r_, stream);
 			stream >> r;
 		} catch (...) {
 			throw std::runtime_error("Unable to identify coin");
@@ -140,7 +176,7 @@ IdentifiedCoinData Coin::identify(const IncomingViewKey& incoming_view_key) {
 
 		try {
 			// Decrypt recipient data
-			CDataStream stream = AEAD::decrypt_and_verify(this->K*incoming_view_key.get_s1(), "Spend coin data", this->r_);
+			recipient_data_aead(COIN_TYPE_SPEND).decrypt_and_verify(this->K*incoming_view_key.get_s1(), this->r_, stream);
 			stream >> r;
 		} catch (...) {
 			throw std::runtime_error("Unable to identify coin");
@@ -165,6 +201,24 @@ std::size_t Coin::memoryRequired() {
     return 1 + groupElement.memoryRequired() * 3 + 32 + AEAD_TAG_SIZE;
 }
 
+std::size_t Coin::serializedSize(const Params* params, const char type) {
+    // Recipient data is encrypted without expansion, so the ciphertext is as long as its serialization
+    std::size_t recipient_data = GetSizeOfCompactSize(AES_BLOCKSIZE) + AES_BLOCKSIZE + Scalar::memoryRequired() + GetSizeOfCompactSize(params->get_memo_bytes()) + params->get_memo_bytes();
+    if (type == COIN_TYPE_SPEND) {
+        recipient_data += sizeof(uint64_t);
+    }
+
+    std::size_t size = 1 + 3*GroupElement::memoryRequired();
+    size += GetSizeOfCompactSize(recipient_data) + recipient_data;
+    size += GetSizeOfCompactSize(AEAD_TAG_SIZE) + AEAD_TAG_SIZE;
+    size += GetSizeOfCompactSize(AEAD_COMMIT_SIZE) + AEAD_COMMIT_SIZE;
+    if (type == COIN_TYPE_MINT) {
+        size += sizeof(uint64_t);
+    }
+
+    return size;
+}
+
 bool Coin::operator==(const Coin& other) const {
     if(this->S != other.S)
         return false;
@@ -206,4 +260,171 @@ void Coin::setParams(const Params* params) {
     this->params = params;
 }
 
+// Minimal stream over borrowed bytes, so the serialization helpers can parse a coin view in place
+class ByteSpanReader {
+public:
+	ByteSpanReader(const unsigned char* data, const std::size_t size) : data(data), remaining(size) {}
+
+	int GetType() const { return SER_NETWORK; }
+	int GetVersion() const { return PROTOCOL_VERSION; }
+
+	void read(char* out, const std::size_t size) {
+		memcpy(out, skip(size), size);
+	}
+
+	// Advance past the next `size` bytes, returning where they start
+	const unsigned char* skip(const std::size_t size) {
+		if (size > this->remaining) {
+			throw std::invalid_argument("Bad serialized coin size");
+		}
+		const unsigned char* result = this->data;
+		this->data += size;
+		this->remaining -= size;
+		return result;
+	}
+
+	const unsigned char* skip_vector(std::size_t& size) {
+		size = ReadCompactSize(*this);
+		return skip(size);
+	}
+
+	std::size_t get_remaining() const {
+		return this->remaining;
+	}
+
+private:
+	const unsigned char* data;
+	std::size_t remaining;
+};
+
+CoinView::CoinView()
+	: params(nullptr), size_(0), type(0), v(0), S_bytes(nullptr), K_bytes(nullptr), C_bytes(nullptr)
+	, S_ready(false), K_ready(false), C_ready(false) {}
+
+CoinView::CoinView(const Params* params, const unsigned char* data, const std::size_t size)
+	: params(params), v(0), S_ready(false), K_ready(false), C_ready(false)
+{
+	ByteSpanReader reader(data, size);
+	this->type = *reinterpret_cast<const char *>(reader.skip(1));
+	if (this->type != COIN_TYPE_MINT && this->type != COIN_TYPE_SPEND) {
+		throw std::invalid_argument("Bad coin type");
+	}
+
+	// Points are kept compressed until they are needed
+	this->S_bytes = reader.skip(GroupElement::serialize_size);
+	this->K_bytes = reader.skip(GroupElement::serialize_size);
+	this->C_bytes = reader.skip(GroupElement::serialize_size);
+
+	// Recipient data is decrypted in place
+	this->r_.ciphertext = reader.skip_vector(this->r_.ciphertext_size);
+	this->r_.tag = reader.skip_vector(this->r_.tag_size);
+	this->r_.key_commitment = reader.skip_vector(this->r_.key_commitment_size);
+
+	if (this->type == COIN_TYPE_MINT) {
+		this->v = ReadLE64(reader.skip(sizeof(uint64_t)));
+	}
+
+	this->size_ = size - reader.get_remaining();
+}
+
+const GroupElement& CoinView::get_point(const unsigned char* bytes, GroupElement& point, bool& ready) const {
+	if (!ready) {
+		point.deserialize(bytes);
+		ready = true;
+	}
+
+	return point;
+}
+
+char CoinView::get_type() const {
+	return this->type;
+}
+
+uint64_t CoinView::get_v() const {
+	return this->v;
+}
+
+const GroupElement& CoinView::get_S() const {
+	return get_point(this->S_bytes, this->S, this->S_ready);
+}
+
+const GroupElement& CoinView::get_K() const {
+	return get_point(this->K_bytes, this->K, this->K_ready);
+}
+
+const GroupElement& CoinView::get_C() const {
+	return get_point(this->C_bytes, this->C, this->C_ready);
+}
+
+const AEADEncryptedDataView& CoinView::get_r_() const {
+	return this->r_;
+}
+
+std::size_t CoinView::size() const {
+	return this->size_;
+}
+
+bool CoinView::identify(
+	const IncomingViewKey& incoming_view_key,
+	const std::vector<unsigned char>& serial_context,
+	IdentifiedCoinData& data
+) const {
+	SPARK_TIME_STAGE(COIN_IDENTIFY);
+	try {
+		// Decrypt recipient data; only K is needed to check the key commitment
+		CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+		stream.resize(this->r_.ciphertext_size);
+		if (!recipient_data_aead(this->type).decrypt(this->get_K()*incoming_view_key.get_s1(), this->r_, reinterpret_cast<unsigned char *>(stream.data()))) {
+			return false;
+		}
+
+		// Deserialization depends on the coin type
+		if (this->type == COIN_TYPE_MINT) {
+			MintCoinRecipientData r;
+			stream >> r;
+
+			data.d = r.d;
+			data.v = this->v;
+			data.k = r.k;
+			data.memo = r.memo;
+		} else {
+			SpendCoinRecipientData r;
+			stream >> r;
+
+			data.d = r.d;
+			data.v = r.v;
+			data.k = r.k;
+			data.memo = r.memo;
+		}
+
+		// Validate the coin
+		return validate_recipient_data(
+			this->params,
+			this->get_K(),
+			[this]() -> const GroupElement& { return this->get_C(); },
+			[this]() -> const GroupElement& { return this->get_S(); },
+			serial_context,
+			incoming_view_key,
+			data
+		);
+	} catch (...) {
+		return false;
+	}
+}
+
+Coin CoinView::to_coin(const std::vector<unsigned char>& serial_context) const {
+	Coin coin(this->params);
+	coin.type = this->type;
+	coin.S = this->get_S();
+	coin.K = this->get_K();
+	coin.C = this->get_C();
+	coin.r_.ciphertext.assign(this->r_.ciphertext, this->r_.ciphertext + this->r_.ciphertext_size);
+	coin.r_.tag.assign(this->r_.tag, this->r_.tag + this->r_.tag_size);
+	coin.r_.key_commitment.assign(this->r_.key_commitment, this->r_.key_commitment + this->r_.key_commitment_size);
+	coin.v = this->v;
+	coin.serial_context = serial_context;
+
+	return coin;
+}
+
 }
@@ -16,6 +16,10 @@ using namespace secp_primitives;
 const char COIN_TYPE_MINT = 0;
 const char COIN_TYPE_SPEND = 1;
 
+// Associated data labels for encrypted recipient data
+const std::string AEAD_LABEL_MINT = "Mint coin data";
+const std::string AEAD_LABEL_SPEND = "Spend coin data";
+
 struct IdentifiedCoinData {
 	uint64_t i; // diversifier
 	std::vector<unsigned char> d; // encrypted diversifier
@@ -85,6 +89,9 @@ public:
 
     static std::size_t memoryRequired();
 
+    // Exact serialized size of a coin of the given type; recipient data has fixed size, since memos are padded
+    static std::size_t serializedSize(const Params* params, const char type);
+
     bool operator==(const Coin& other) const;
     bool operator!=(const Coin& other) const;
 
@@ -120,6 +127,47 @@ public:
 	}
 };
 
+// Read-only view of a serialized coin that borrows its bytes, e.g. directly from an output script
+// Construction only checks the layout; each point is decompressed the first time it is used,
+// so coins rejected at the key commitment never have S or C decompressed
+// The bytes must outlive the view, and a view must not be shared between threads
+class CoinView {
+public:
+	CoinView();
+	CoinView(const Params* params, const unsigned char* data, const std::size_t size);
+
+	char get_type() const;
+	uint64_t get_v() const;
+	const GroupElement& get_S() const;
+	const GroupElement& get_K() const;
+	const GroupElement& get_C() const;
+	const AEADEncryptedDataView& get_r_() const;
+
+	// Number of bytes the serialized coin occupies
+	std::size_t size() const;
+
+	// Identify the coin; unlike Coin::identify, a coin that is not ours is reported by returning false
+	bool identify(const IncomingViewKey& incoming_view_key, const std::vector<unsigned char>& serial_context, IdentifiedCoinData& data) const;
+
+	// Materialize a full coin
+	Coin to_coin(const std::vector<unsigned char>& serial_context) const;
+
+private:
+	const GroupElement& get_point(const unsigned char* bytes, GroupElement& point, bool& ready) const;
+
+	const Params* params;
+	std::size_t size_;
+	char type;
+	uint64_t v;
+	const unsigned char* S_bytes;
+	const unsigned char* K_bytes;
+	const unsigned char* C_bytes;
+	AEADEncryptedDataView r_;
+
+	mutable GroupElement S, K, C;
+	mutable bool S_ready, K_ready, C_ready;
+};
+
 }
 
 #endif
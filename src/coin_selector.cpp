@@ -0,0 +1,166 @@
+#include "coin_selector.h"
+#include "spend_transaction.h"
+#include <algorithm>
+#include <limits>
+#include <set>
+#include <stdexcept>
+
+bool SparkCoinSelector::Key::operator<(const Key& other) const {
+	if (this->v != other.v)
+		return this->v < other.v;
+	if (this->nHeight != other.nHeight)
+		return this->nHeight < other.nHeight;
+	return this->order < other.order;
+}
+
+SparkCoinSelector::SparkCoinSelector(): next_order(0), total(0) {}
+
+SparkCoinSelector::SparkCoinSelector(const std::list<CSparkMintMeta>& coins): SparkCoinSelector() {
+	for (const CSparkMintMeta& coin : coins) {
+		add(coin);
+	}
+}
+
+void SparkCoinSelector::add(const CSparkMintMeta& coin) {
+	// Coins are added in order, so each one goes after every coin already present
+	this->coins.emplace_hint(this->coins.end(), Key{coin.v, coin.nHeight, this->next_order++}, coin);
+	this->total += coin.v;
+}
+
+// Coins are identified by nonce, so only those with the same value and height need to be compared
+bool SparkCoinSelector::remove(const CSparkMintMeta& coin) {
+	Coins::const_iterator it = this->coins.lower_bound(Key{coin.v, coin.nHeight, 0});
+	for (; it != this->coins.end() && it->first.v == coin.v && it->first.nHeight == coin.nHeight; ++it) {
+		if (it->second == coin) {
+			this->total -= coin.v;
+			this->coins.erase(it);
+			return true;
+		}
+	}
+	return false;
+}
+
+std::size_t SparkCoinSelector::size() const {
+	return this->coins.size();
+}
+
+bool SparkCoinSelector::empty() const {
+	return this->coins.empty();
+}
+
+uint64_t SparkCoinSelector::balance() const {
+	return this->total;
+}
+
+bool SparkCoinSelector::get_coins_to_spend(
+		CAmount required,
+		std::vector<CSparkMintMeta>& coinsToSpend_out,
+		int64_t& changeToMint) const {
+	if (required > 0 && (uint64_t)required > this->total) {
+		throw std::runtime_error("Insufficient funds !");
+	}
+
+	CAmount spend_val(0);
+
+	// Chosen coins stay in the index. Coins are taken from the top down, oldest first within a value, so every chosen
+	// coin lies in [group_begin, next) or above it, and no chosen coin has to be looked up again
+	Coins::const_iterator group_begin = this->coins.end(); // the value being taken
+	Coins::const_iterator group_end = this->coins.end();
+	Coins::const_iterator next = this->coins.end(); // its oldest coin not chosen yet
+	std::vector<CSparkMintMeta> coinsToSpend;
+	while (spend_val < required && coinsToSpend.size() < this->coins.size()) {
+		uint64_t need = required - spend_val;
+
+		// Every coin of the current value is chosen, so move to the next lower one
+		if (next == group_end) {
+			group_end = group_begin;
+			group_begin = this->coins.lower_bound(Key{std::prev(group_end)->first.v, std::numeric_limits<int>::min(), 0});
+			next = group_begin;
+		}
+
+		// If the need covers the largest unused value, take its oldest coin
+		Coins::const_iterator choosen = next;
+		if (need < next->first.v) {
+			// The smallest value covering the need, oldest first; only coins of the current value may already be chosen
+			choosen = this->coins.lower_bound(Key{need, std::numeric_limits<int>::min(), 0});
+			if (choosen->first.v == next->first.v) {
+				choosen = next;
+			}
+		}
+		if (choosen == next) {
+			++next;
+		}
+
+		spend_val += choosen->second.v;
+		coinsToSpend.emplace_back(choosen->second);
+	}
+
+	// sort by group id ay ascending order. it is mandatory for creting proper joinsplit
+	std::stable_sort(coinsToSpend.begin(), coinsToSpend.end(), [](const CSparkMintMeta& a, const CSparkMintMeta& b) -> bool {
+		return a.nId < b.nId;
+	});
+
+	changeToMint = spend_val - required;
+	coinsToSpend_out.insert(coinsToSpend_out.begin(), coinsToSpend.begin(), coinsToSpend.end());
+
+	return true;
+}
+
+std::size_t SparkCoinSelector::estimate_transaction_size(const spark::Params* params, std::size_t inputs, std::size_t sets, std::size_t outputs) {
+	std::size_t spend = spark::SpendTransaction::estimate_serialized_size(params, inputs, outputs, sets);
+
+	// Each output is a value and an OP_SPARKSMINT script holding the coin
+	std::size_t script = 1 + spark::Coin::serializedSize(params, spark::COIN_TYPE_SPEND);
+	std::size_t output = sizeof(CAmount) + GetSizeOfCompactSize(script) + script;
+
+	// 144 other parts of tx
+	return 144 + GetSizeOfCompactSize(spend) + spend + outputs*output;
+}
+
+// Each round of the fee fixpoint only queries the index for the coins it chooses, so it costs O(k log n) for k inputs
+std::pair<CAmount, std::vector<CSparkMintMeta>> SparkCoinSelector::select(
+		CAmount required,
+		bool subtractFeeFromAmount,
+		std::size_t mintNum,
+		const spark::Params* params) const {
+	CFeeRate fRate;
+
+	CAmount fee;
+	unsigned size;
+	int64_t changeToMint = 0; // this value can be negative, that means we need to spend remaining part of required value with another transaction (nMaxInputPerTransaction exceeded)
+
+	std::vector<CSparkMintMeta> spendCoins;
+	for (fee = fRate.GetFeePerK();;) {
+		CAmount currentRequired = required;
+
+		if (!subtractFeeFromAmount)
+			currentRequired += fee;
+		spendCoins.clear();
+		if (!get_coins_to_spend(currentRequired, spendCoins, changeToMint)) {
+			throw std::invalid_argument("Unable to select cons for spend");
+		}
+
+		// Change is minted to a new output, unless the recipients take everything
+		std::size_t outputs = mintNum + (changeToMint > 0 || mintNum == 0 ? 1 : 0);
+		std::set<int> sets;
+		for (const CSparkMintMeta& coin : spendCoins)
+			sets.insert(coin.nId);
+
+		size = estimate_transaction_size(params, spendCoins.size(), sets.size(), outputs); //TODO (levon) take in account also utxoNum
+		CAmount feeNeeded = size;
+
+		if (fee >= feeNeeded) {
+			break;
+		}
+
+		fee = feeNeeded;
+
+		if (subtractFeeFromAmount)
+			break;
+	}
+
+	if (changeToMint < 0)
+		throw std::invalid_argument("Unable to select cons for spend");
+
+	return std::make_pair(fee, spendCoins);
+}
@@ -0,0 +1,55 @@
+#ifndef FIRO_LIBSPARK_COIN_SELECTOR_H
+#define FIRO_LIBSPARK_COIN_SELECTOR_H
+#include "../bitcoin/amount.h"
+#include "primitives.h"
+#include <list>
+#include <map>
+
+// Spendable coins kept ordered by value, so that a wallet can build the index once and keep it current as coins
+// arrive and are spent, instead of copying and sorting its whole coin list for every selection
+// Selection makes the same choices as sorting by value (largest first, older block first among equal values):
+// take the largest coin while the remaining need is at least its value, otherwise the smallest coin covering the need
+class SparkCoinSelector {
+public:
+	SparkCoinSelector();
+	SparkCoinSelector(const std::list<CSparkMintMeta>& coins);
+
+	void add(const CSparkMintMeta& coin);
+	bool remove(const CSparkMintMeta& coin);
+
+	std::size_t size() const;
+	bool empty() const;
+	uint64_t balance() const;
+
+	// Select coins covering `required`, sorted by group id and appended to the front of `coinsToSpend_out`
+	bool get_coins_to_spend(
+		CAmount required,
+		std::vector<CSparkMintMeta>& coinsToSpend_out,
+		int64_t& changeToMint) const;
+
+	// Select coins covering `required` and the fee of a transaction spending them; returns the fee and the coins
+	std::pair<CAmount, std::vector<CSparkMintMeta>> select(
+		CAmount required,
+		bool subtractFeeFromAmount,
+		std::size_t mintNum,
+		const spark::Params* params = spark::Params::get_default()) const;
+
+	// Size of a transaction spending `inputs` coins from `sets` groups into `outputs` private outputs
+	static std::size_t estimate_transaction_size(const spark::Params* params, std::size_t inputs, std::size_t sets, std::size_t outputs);
+
+private:
+	struct Key {
+		uint64_t v;
+		int nHeight;
+		uint64_t order; // insertion order, keeping equal coins in the order they were added
+
+		bool operator<(const Key& other) const;
+	};
+	typedef std::map<Key, CSparkMintMeta> Coins;
+
+	Coins coins;
+	uint64_t next_order;
+	uint64_t total;
+};
+
+#endif
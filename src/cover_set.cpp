@@ -0,0 +1,226 @@
+#include "cover_set.h"
+#include "coin.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string.h>
+
+namespace spark {
+
+// Points are normalized in chunks to bound the temporary Jacobian copies
+static const std::size_t COVER_SET_CHUNK = 1024;
+
+CoverSet::CoverSet()
+	: S_view(nullptr)
+	, C_view(nullptr)
+	, view_size(0)
+{}
+
+CoverSet::CoverSet(const std::vector<Coin>& coins)
+	: CoverSet()
+{
+	append(coins);
+}
+
+CoverSet CoverSet::view(std::shared_ptr<const void> backing, const unsigned char* S, const unsigned char* C, const std::size_t size) {
+	CoverSet result;
+	result.backing = std::move(backing);
+	result.S_view = S;
+	result.C_view = C;
+	result.view_size = size;
+	return result;
+}
+
+// Copy viewed points into owned storage so they can be appended to
+void CoverSet::detach() {
+	if (!this->backing) {
+		return;
+	}
+	std::size_t bytes = this->view_size*GroupElement::affine_size;
+	this->S.assign(this->S_view, this->S_view + bytes);
+	this->C.assign(this->C_view, this->C_view + bytes);
+	this->backing.reset();
+	this->S_view = nullptr;
+	this->C_view = nullptr;
+	this->view_size = 0;
+}
+
+void CoverSet::reserve(const std::size_t size) {
+	detach();
+	this->S.reserve(size*GroupElement::affine_size);
+	this->C.reserve(size*GroupElement::affine_size);
+}
+
+// Commitment accessors shared by full coins and views
+static const GroupElement& serial_commitment(const Coin& coin) { return coin.S; }
+static const GroupElement& value_commitment(const Coin& coin) { return coin.C; }
+static const GroupElement& serial_commitment(const CoinView& coin) { return coin.get_S(); }
+static const GroupElement& value_commitment(const CoinView& coin) { return coin.get_C(); }
+
+template <typename Coins>
+void CoverSet::append_coins(const Coins& coins) {
+	reserve(size() + coins.size());
+
+	std::vector<GroupElement> S_chunk, C_chunk;
+	for (std::size_t start = 0; start < coins.size(); start += COVER_SET_CHUNK) {
+		std::size_t end = std::min(coins.size(), start + COVER_SET_CHUNK);
+		S_chunk.clear();
+		C_chunk.clear();
+		for (std::size_t i = start; i < end; i++) {
+			S_chunk.emplace_back(serial_commitment(coins[i]));
+			C_chunk.emplace_back(value_commitment(coins[i]));
+		}
+
+		std::size_t offset = this->S.size();
+		this->S.resize(offset + S_chunk.size()*GroupElement::affine_size);
+		this->C.resize(offset + C_chunk.size()*GroupElement::affine_size);
+		GroupElement::serialize_affine(S_chunk, this->S.data() + offset);
+		GroupElement::serialize_affine(C_chunk, this->C.data() + offset);
+	}
+}
+
+void CoverSet::append(const std::vector<Coin>& coins) {
+	append_coins(coins);
+}
+
+void CoverSet::append(const std::vector<CoinView>& coins) {
+	append_coins(coins);
+}
+
+void CoverSet::append(const GroupElement& S, const GroupElement& C) {
+	detach();
+	std::size_t offset = this->S.size();
+	this->S.resize(offset + GroupElement::affine_size);
+	this->C.resize(offset + GroupElement::affine_size);
+	S.serialize_affine(this->S.data() + offset);
+	C.serialize_affine(this->C.data() + offset);
+}
+
+std::size_t CoverSet::size() const {
+	if (this->backing) {
+		return this->view_size;
+	}
+	return this->S.size() / GroupElement::affine_size;
+}
+
+bool CoverSet::empty() const {
+	return size() == 0;
+}
+
+GroupElement CoverSet::get_S(const std::size_t i) const {
+	if (i >= size()) {
+		throw std::out_of_range("Bad cover set index");
+	}
+	GroupElement result;
+	result.deserialize_affine(S_data() + i*GroupElement::affine_size);
+	return result;
+}
+
+GroupElement CoverSet::get_C(const std::size_t i) const {
+	if (i >= size()) {
+		throw std::out_of_range("Bad cover set index");
+	}
+	GroupElement result;
+	result.deserialize_affine(C_data() + i*GroupElement::affine_size);
+	return result;
+}
+
+const unsigned char* CoverSet::S_data() const {
+	return this->backing ? this->S_view : this->S.data();
+}
+
+const unsigned char* CoverSet::C_data() const {
+	return this->backing ? this->C_view : this->C.data();
+}
+
+std::size_t CoverSet::memoryRequired() const {
+	return this->S.capacity() + this->C.capacity();
+}
+
+CoverSetIndex::CoverSetIndex()
+	: size_(0)
+{}
+
+CoverSetIndex::CoverSetIndex(const std::vector<Coin>& coins)
+	: CoverSetIndex()
+{
+	append(coins);
+}
+
+CoverSetIndex::CoverSetIndex(const CoverSet& set)
+	: CoverSetIndex()
+{
+	append(set);
+}
+
+std::size_t CoverSetIndex::KeyHash::operator()(const Key& key) const {
+	std::size_t result;
+	memcpy(&result, key.data(), sizeof(result));
+	return result;
+}
+
+void CoverSetIndex::insert(const unsigned char* S) {
+	Key key;
+	memcpy(key.data(), S, key.size());
+	// Keep the first position if a commitment repeats
+	this->positions.emplace(key, this->size_++);
+}
+
+void CoverSetIndex::append(const std::vector<Coin>& coins) {
+	this->positions.reserve(this->size_ + coins.size());
+
+	std::vector<GroupElement> S_chunk;
+	std::vector<unsigned char> encoded;
+	for (std::size_t start = 0; start < coins.size(); start += COVER_SET_CHUNK) {
+		std::size_t end = std::min(coins.size(), start + COVER_SET_CHUNK);
+		S_chunk.clear();
+		for (std::size_t i = start; i < end; i++) {
+			S_chunk.emplace_back(coins[i].S);
+		}
+
+		encoded.resize(S_chunk.size()*GroupElement::affine_size);
+		GroupElement::serialize_affine(S_chunk, encoded.data());
+		for (std::size_t i = 0; i < S_chunk.size(); i++) {
+			insert(encoded.data() + i*GroupElement::affine_size);
+		}
+	}
+}
+
+void CoverSetIndex::append(const CoverSet& set) {
+	this->positions.reserve(this->size_ + set.size());
+	for (std::size_t i = 0; i < set.size(); i++) {
+		insert(set.S_data() + i*GroupElement::affine_size);
+	}
+}
+
+bool CoverSetIndex::find(const GroupElement& S, std::size_t& index) const {
+	Key key;
+	S.serialize_affine(key.data());
+	auto position = this->positions.find(key);
+	if (position == this->positions.end()) {
+		return false;
+	}
+	index = position->second;
+	return true;
+}
+
+std::size_t CoverSetIndex::size() const {
+	return this->size_;
+}
+
+CoverSetMemoryReader::CoverSetMemoryReader(const CoverSet& set_)
+	: set(set_)
+{}
+
+std::size_t CoverSetMemoryReader::size() const {
+	return this->set.size();
+}
+
+void CoverSetMemoryReader::read(const std::size_t start, const std::size_t count, unsigned char* S, unsigned char* C) {
+	if (start > this->set.size() || count > this->set.size() - start) {
+		throw std::out_of_range("Bad cover set range");
+	}
+	memcpy(S, this->set.S_data() + start*GroupElement::affine_size, count*GroupElement::affine_size);
+	memcpy(C, this->set.C_data() + start*GroupElement::affine_size, count*GroupElement::affine_size);
+}
+
+}
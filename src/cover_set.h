@@ -0,0 +1,116 @@
+#ifndef FIRO_SPARK_COVER_SET_H
+#define FIRO_SPARK_COVER_SET_H
+#include "../secp256k1/include/GroupElement.h"
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace spark {
+
+using namespace secp_primitives;
+
+class Coin;
+class CoinView;
+
+// The part of a cover set that one-of-many proofs actually read: the serial commitment `S` and value commitment `C` of each coin
+// Both are stored as contiguous arrays of affine points (see GroupElement::serialize_affine), which is an order of magnitude
+// smaller than a vector of full coins and can be passed to multiscalar multiplication without conversion
+class CoverSet {
+public:
+	CoverSet();
+	CoverSet(const std::vector<Coin>& coins);
+
+	// Use points stored elsewhere without copying them; `backing` keeps that storage alive for as long as the set refers to it.
+	// The points are trusted to be valid. Appending to such a set first copies the points into memory owned by the set
+	static CoverSet view(std::shared_ptr<const void> backing, const unsigned char* S, const unsigned char* C, const std::size_t size);
+
+	void reserve(const std::size_t size);
+	void append(const std::vector<Coin>& coins);
+	void append(const std::vector<CoinView>& coins);
+	void append(const GroupElement& S, const GroupElement& C);
+
+	std::size_t size() const;
+	bool empty() const;
+
+	GroupElement get_S(const std::size_t i) const;
+	GroupElement get_C(const std::size_t i) const;
+
+	// Affine encodings of all points, `GroupElement::affine_size` bytes each
+	const unsigned char* S_data() const;
+	const unsigned char* C_data() const;
+
+	// Heap memory owned by the set; a view owns none
+	std::size_t memoryRequired() const;
+
+private:
+	template <typename Coins>
+	void append_coins(const Coins& coins);
+	void detach();
+
+	std::vector<unsigned char> S;
+	std::vector<unsigned char> C;
+
+	// External storage, if this set is a view
+	std::shared_ptr<const void> backing;
+	const unsigned char* S_view;
+	const unsigned char* C_view;
+	std::size_t view_size;
+};
+
+// Positions of coins in a cover set keyed by serial commitment, so that a coin can be located without comparing it against the whole set
+// Keys are affine encodings, which are built for many coins at once with one field inversion per chunk
+class CoverSetIndex {
+public:
+	CoverSetIndex();
+	CoverSetIndex(const std::vector<Coin>& coins);
+	CoverSetIndex(const CoverSet& set);
+
+	// Index coins that were appended to the set; positions continue from the current size
+	void append(const std::vector<Coin>& coins);
+	void append(const CoverSet& set);
+
+	bool find(const GroupElement& S, std::size_t& index) const;
+	std::size_t size() const;
+
+private:
+	typedef std::array<unsigned char, GroupElement::affine_size> Key;
+
+	// Affine coordinates are already uniformly distributed, so a prefix serves as the hash
+	struct KeyHash {
+		std::size_t operator()(const Key& key) const;
+	};
+
+	void insert(const unsigned char* S);
+
+	std::unordered_map<Key, std::size_t, KeyHash> positions;
+	std::size_t size_;
+};
+
+// Access to a cover set in chunks, for provers that should not hold the whole set in memory
+// Inputs sharing a set are proven concurrently, so `read` may be called from several threads at once
+class CoverSetReader {
+public:
+	virtual ~CoverSetReader() {}
+
+	virtual std::size_t size() const = 0;
+
+	// Copy the affine encodings of `count` consecutive points, starting at `start`, into the `S` and `C` buffers
+	virtual void read(const std::size_t start, const std::size_t count, unsigned char* S, unsigned char* C) = 0;
+};
+
+// Reads from a set held in memory or mapped from a file
+class CoverSetMemoryReader : public CoverSetReader {
+public:
+	CoverSetMemoryReader(const CoverSet& set);
+
+	std::size_t size() const override;
+	void read(const std::size_t start, const std::size_t count, unsigned char* S, unsigned char* C) override;
+
+private:
+	const CoverSet& set;
+};
+
+}
+
+#endif
@@ -0,0 +1,266 @@
+#include "cover_set_file.h"
+#include "mapped_file.h"
+#include "../bitcoin/crypto/common.h"
+#include "../bitcoin/crypto/sha256.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+namespace spark {
+
+static const unsigned char COVER_SET_FILE_MAGIC[8] = {'S', 'P', 'K', 'C', 'O', 'V', 'E', 'R'};
+static const std::size_t CHECKSUM_OFFSET = 96;
+
+struct CoverSetFileHeader {
+	std::vector<unsigned char> representation;
+	uint64_t count;
+	uint64_t capacity;
+};
+
+static std::size_t array_bytes(const uint64_t points) {
+	return points*GroupElement::affine_size;
+}
+
+// Encode all header fields except the checksum
+static void encode_header(unsigned char* header, const std::vector<unsigned char>& representation, const uint64_t count, const uint64_t capacity) {
+	if (representation.size() > CoverSetFile::MAX_REPRESENTATION_SIZE) {
+		throw std::invalid_argument("Bad cover set representation size");
+	}
+	memset(header, 0, CoverSetFile::HEADER_SIZE);
+	memcpy(header, COVER_SET_FILE_MAGIC, sizeof(COVER_SET_FILE_MAGIC));
+	WriteLE32(header + 8, CoverSetFile::VERSION);
+	WriteLE32(header + 12, (uint32_t) representation.size());
+	WriteLE64(header + 16, count);
+	WriteLE64(header + 24, capacity);
+	if (!representation.empty()) {
+		memcpy(header + 32, representation.data(), representation.size());
+	}
+}
+
+static CoverSetFileHeader decode_header(const unsigned char* header, const std::size_t file_size) {
+	if (file_size < CoverSetFile::HEADER_SIZE || memcmp(header, COVER_SET_FILE_MAGIC, sizeof(COVER_SET_FILE_MAGIC)) != 0) {
+		throw std::runtime_error("Bad cover set file");
+	}
+	if (ReadLE32(header + 8) != CoverSetFile::VERSION) {
+		throw std::runtime_error("Unsupported cover set file version");
+	}
+
+	CoverSetFileHeader result;
+	uint32_t representation_size = ReadLE32(header + 12);
+	result.count = ReadLE64(header + 16);
+	result.capacity = ReadLE64(header + 24);
+	if (representation_size > CoverSetFile::MAX_REPRESENTATION_SIZE || result.count > result.capacity) {
+		throw std::runtime_error("Bad cover set file");
+	}
+	if (result.capacity > (file_size - CoverSetFile::HEADER_SIZE) / (2*GroupElement::affine_size)) {
+		throw std::runtime_error("Bad cover set file size");
+	}
+	result.representation.assign(header + 32, header + 32 + representation_size);
+	return result;
+}
+
+// The checksum covers the header fields and the used part of both arrays, which may be split between two sources
+static void compute_checksum(
+		const unsigned char* header,
+		const unsigned char* S_old,
+		const unsigned char* C_old,
+		const std::size_t old_size,
+		const unsigned char* S_new,
+		const unsigned char* C_new,
+		const std::size_t new_size,
+		unsigned char* checksum) {
+	CSHA256 hash;
+	hash.Write(header, CHECKSUM_OFFSET);
+	if (old_size > 0) {
+		hash.Write(S_old, array_bytes(old_size));
+	}
+	if (new_size > 0) {
+		hash.Write(S_new, array_bytes(new_size));
+	}
+	if (old_size > 0) {
+		hash.Write(C_old, array_bytes(old_size));
+	}
+	if (new_size > 0) {
+		hash.Write(C_new, array_bytes(new_size));
+	}
+	hash.Finalize(checksum);
+}
+
+// Map and check a file, returning a view of its points
+static CoverSet map_cover_set(const std::string& path, CoverSetFileHeader& header, const bool verify_checksum) {
+	std::shared_ptr<MappedFile> mapped = std::make_shared<MappedFile>(path);
+	header = decode_header(mapped->data, mapped->size);
+
+	const unsigned char* S = mapped->data + CoverSetFile::HEADER_SIZE;
+	const unsigned char* C = S + array_bytes(header.capacity);
+
+	if (verify_checksum) {
+		unsigned char checksum[CSHA256::OUTPUT_SIZE];
+		compute_checksum(mapped->data, S, C, header.count, nullptr, nullptr, 0, checksum);
+		if (memcmp(checksum, mapped->data + CHECKSUM_OFFSET, sizeof(checksum)) != 0) {
+			throw std::runtime_error("Bad cover set file checksum");
+		}
+	}
+
+	return CoverSet::view(mapped, S, C, header.count);
+}
+
+void CoverSetFile::write(
+		const std::string& path,
+		const CoverSet& set,
+		const std::vector<unsigned char>& cover_set_representation,
+		const std::size_t capacity) {
+	const std::size_t size = set.size();
+	const std::size_t reserved = std::max(size, capacity);
+
+	unsigned char header[HEADER_SIZE];
+	encode_header(header, cover_set_representation, size, reserved);
+	compute_checksum(header, set.S_data(), set.C_data(), size, nullptr, nullptr, 0, header + CHECKSUM_OFFSET);
+
+	// Replace the file atomically, which also leaves existing mappings of the old file intact
+	const std::string temporary_path = path + ".tmp";
+	std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		throw std::runtime_error("Unable to create cover set file");
+	}
+	std::vector<char> padding(array_bytes(reserved - size), 0);
+	file.write(reinterpret_cast<const char*>(header), HEADER_SIZE);
+	file.write(reinterpret_cast<const char*>(set.S_data()), array_bytes(size));
+	file.write(padding.data(), padding.size());
+	file.write(reinterpret_cast<const char*>(set.C_data()), array_bytes(size));
+	file.write(padding.data(), padding.size());
+	file.close();
+	if (!file || std::rename(temporary_path.c_str(), path.c_str()) != 0) {
+		std::remove(temporary_path.c_str());
+		throw std::runtime_error("Unable to write cover set file");
+	}
+}
+
+void CoverSetFile::append(
+		const std::string& path,
+		const CoverSet& points,
+		const std::vector<unsigned char>& cover_set_representation) {
+	// The existing points must be intact, since the new checksum covers them
+	CoverSetFileHeader existing_header;
+	CoverSet existing = map_cover_set(path, existing_header, true);
+	const std::size_t old_size = existing.size();
+	const std::size_t new_size = old_size + points.size();
+	const std::size_t capacity = existing_header.capacity;
+
+	// Out of room, so rewrite with geometric growth
+	if (new_size > capacity) {
+		CoverSet combined = existing;
+		combined.reserve(new_size);
+		for (std::size_t i = 0; i < points.size(); i++) {
+			combined.append(points.get_S(i), points.get_C(i));
+		}
+		write(path, combined, cover_set_representation, std::max(new_size, 2*capacity));
+		return;
+	}
+
+	unsigned char header[HEADER_SIZE];
+	encode_header(header, cover_set_representation, new_size, capacity);
+	compute_checksum(
+		header,
+		existing.S_data(), existing.C_data(), old_size,
+		points.S_data(), points.C_data(), points.size(),
+		header + CHECKSUM_OFFSET
+	);
+
+	// Write the points before the header that makes them part of the set
+	std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+	if (!file) {
+		throw std::runtime_error("Unable to open cover set file");
+	}
+	file.seekp(HEADER_SIZE + array_bytes(old_size));
+	file.write(reinterpret_cast<const char*>(points.S_data()), array_bytes(points.size()));
+	file.seekp(HEADER_SIZE + array_bytes(capacity) + array_bytes(old_size));
+	file.write(reinterpret_cast<const char*>(points.C_data()), array_bytes(points.size()));
+	file.flush();
+	file.seekp(0);
+	file.write(reinterpret_cast<const char*>(header), HEADER_SIZE);
+	file.flush();
+	if (!file) {
+		throw std::runtime_error("Unable to write cover set file");
+	}
+}
+
+CoverSet CoverSetFile::read(
+		const std::string& path,
+		std::vector<unsigned char>& cover_set_representation,
+		const bool verify_checksum) {
+	CoverSetFileHeader header;
+	CoverSet result = map_cover_set(path, header, verify_checksum);
+	cover_set_representation = header.representation;
+	return result;
+}
+
+// Read buffer used when verifying a file in chunks
+static const std::size_t CHECKSUM_CHUNK = 1 << 16;
+
+CoverSetFileReader::CoverSetFileReader(const std::string& path, const bool verify_checksum)
+	: file(path, std::ios::binary)
+{
+	if (!this->file) {
+		throw std::runtime_error("Unable to open cover set file");
+	}
+	this->file.seekg(0, std::ios::end);
+	const std::size_t file_size = (std::size_t) this->file.tellg();
+	this->file.seekg(0);
+
+	unsigned char header[CoverSetFile::HEADER_SIZE] = {};
+	this->file.read(reinterpret_cast<char*>(header), std::min(file_size, CoverSetFile::HEADER_SIZE));
+	CoverSetFileHeader decoded = decode_header(header, file_size);
+	this->cover_set_representation = decoded.representation;
+	this->size_ = decoded.count;
+	this->capacity = decoded.capacity;
+
+	if (verify_checksum) {
+		CSHA256 hash;
+		hash.Write(header, CHECKSUM_OFFSET);
+		std::vector<unsigned char> buffer(CHECKSUM_CHUNK);
+		for (std::size_t offset : {CoverSetFile::HEADER_SIZE, CoverSetFile::HEADER_SIZE + array_bytes(this->capacity)}) {
+			this->file.seekg(offset);
+			for (std::size_t remaining = array_bytes(this->size_); remaining > 0; ) {
+				std::size_t bytes = std::min(remaining, buffer.size());
+				this->file.read(reinterpret_cast<char*>(buffer.data()), bytes);
+				hash.Write(buffer.data(), bytes);
+				remaining -= bytes;
+			}
+		}
+
+		unsigned char checksum[CSHA256::OUTPUT_SIZE];
+		hash.Finalize(checksum);
+		if (!this->file || memcmp(checksum, header + CHECKSUM_OFFSET, sizeof(checksum)) != 0) {
+			throw std::runtime_error("Bad cover set file checksum");
+		}
+	}
+}
+
+std::size_t CoverSetFileReader::size() const {
+	return this->size_;
+}
+
+void CoverSetFileReader::read(const std::size_t start, const std::size_t count, unsigned char* S, unsigned char* C) {
+	if (start > this->size_ || count > this->size_ - start) {
+		throw std::out_of_range("Bad cover set range");
+	}
+	std::lock_guard<std::mutex> lock(this->mutex);
+	this->file.seekg(CoverSetFile::HEADER_SIZE + array_bytes(start));
+	this->file.read(reinterpret_cast<char*>(S), array_bytes(count));
+	this->file.seekg(CoverSetFile::HEADER_SIZE + array_bytes(this->capacity) + array_bytes(start));
+	this->file.read(reinterpret_cast<char*>(C), array_bytes(count));
+	if (!this->file) {
+		throw std::runtime_error("Unable to read cover set file");
+	}
+}
+
+const std::vector<unsigned char>& CoverSetFileReader::get_cover_set_representation() const {
+	return this->cover_set_representation;
+}
+
+}
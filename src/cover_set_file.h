@@ -0,0 +1,75 @@
+#ifndef FIRO_SPARK_COVER_SET_FILE_H
+#define FIRO_SPARK_COVER_SET_FILE_H
+#include "cover_set.h"
+#include <fstream>
+#include <mutex>
+#include <string>
+
+namespace spark {
+
+// A versioned on-disk cover set, so that a wallet can keep a set between spends without decompressing and validating its points again
+//
+// Layout (integers are little-endian):
+//   0   magic "SPKCOVER"
+//   8   version (uint32)
+//   12  representation size (uint32)
+//   16  point count (uint64)
+//   24  capacity in points (uint64)
+//   32  cover set representation, zero-padded to MAX_REPRESENTATION_SIZE bytes
+//   96  SHA-256 checksum of bytes 0..95 followed by the first `count` entries of each array
+//   128 serial commitment array, `capacity` affine points
+//   ... value commitment array, `capacity` affine points
+//
+// Reserving capacity keeps both arrays contiguous while the set grows, so appending only writes the new points and the header.
+// The checksum detects corruption and torn writes of a local file; points are not validated again when the file is read
+class CoverSetFile {
+public:
+	static constexpr uint32_t VERSION = 1;
+	static constexpr std::size_t HEADER_SIZE = 128;
+	static constexpr std::size_t MAX_REPRESENTATION_SIZE = 64;
+
+	// Write a new file, atomically replacing any existing one, with room for at least `capacity` points
+	static void write(
+		const std::string& path,
+		const CoverSet& set,
+		const std::vector<unsigned char>& cover_set_representation,
+		const std::size_t capacity = 0
+	);
+
+	// Add points to the end of an existing file and replace its representation; the file is rewritten with more capacity if needed
+	static void append(
+		const std::string& path,
+		const CoverSet& points,
+		const std::vector<unsigned char>& cover_set_representation
+	);
+
+	// Map a file into memory; the returned set views the mapped points without copying them
+	static CoverSet read(
+		const std::string& path,
+		std::vector<unsigned char>& cover_set_representation,
+		const bool verify_checksum = true
+	);
+};
+
+// Reads a cover set file in chunks through ordinary file reads, so that only the requested points are ever resident
+class CoverSetFileReader : public CoverSetReader {
+public:
+	// The checksum is verified with a single bounded-memory pass over the file
+	CoverSetFileReader(const std::string& path, const bool verify_checksum = true);
+
+	std::size_t size() const override;
+	void read(const std::size_t start, const std::size_t count, unsigned char* S, unsigned char* C) override;
+
+	const std::vector<unsigned char>& get_cover_set_representation() const;
+
+private:
+	std::mutex mutex; // guards the read position of `file`
+	std::ifstream file;
+	std::vector<unsigned char> cover_set_representation;
+	std::size_t size_;
+	std::size_t capacity;
+};
+
+}
+
+#endif
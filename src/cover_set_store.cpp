@@ -0,0 +1,87 @@
+#include "cover_set_store.h"
+
+namespace spark {
+
+CoverSetStore::Entry::Entry(const std::shared_ptr<const CoverSetData>& data_, const std::shared_ptr<const CoverSetIndex>& index_)
+    : data(data_)
+    , index(index_)
+{
+    if (this->index) {
+        std::call_once(this->index_flag, []() {});
+    }
+}
+
+CoverSetStore::CoverSetStore() {}
+
+void CoverSetStore::add(const uint64_t id, CoverSetData&& data) {
+    add(id, std::make_shared<const CoverSetData>(std::move(data)));
+}
+
+void CoverSetStore::add(const uint64_t id, const std::shared_ptr<const CoverSetData>& data) {
+    add(id, data, nullptr);
+}
+
+void CoverSetStore::add(const uint64_t id, const std::shared_ptr<const CoverSetData>& data, const std::shared_ptr<const CoverSetIndex>& index) {
+    if (!data) {
+        throw std::invalid_argument("Bad cover set data");
+    }
+    if (index && index->size() != data->cover_set.size()) {
+        throw std::invalid_argument("Bad cover set index size");
+    }
+    this->entries[id] = std::make_shared<const Entry>(data, index);
+}
+
+std::size_t CoverSetStore::count(const uint64_t id) const {
+    return this->entries.count(id);
+}
+
+std::size_t CoverSetStore::size() const {
+    return this->entries.size();
+}
+
+std::vector<uint64_t> CoverSetStore::ids() const {
+    std::vector<uint64_t> result;
+    result.reserve(this->entries.size());
+    for (const auto& item : this->entries) {
+        result.emplace_back(item.first);
+    }
+    return result;
+}
+
+const CoverSetStore::Entry& CoverSetStore::entry(const uint64_t id) const {
+    auto item = this->entries.find(id);
+    if (item == this->entries.end()) {
+        throw std::invalid_argument("Required set is not passed");
+    }
+    return *item->second;
+}
+
+const CoverSetData& CoverSetStore::at(const uint64_t id) const {
+    return *entry(id).data;
+}
+
+std::shared_ptr<const CoverSetData> CoverSetStore::get(const uint64_t id) const {
+    return entry(id).data;
+}
+
+const CoverSetIndex& CoverSetStore::get_index(const uint64_t id) const {
+    const Entry& item = entry(id);
+    std::call_once(item.index_flag, [&item]() {
+        item.index = std::make_shared<const CoverSetIndex>(item.data->cover_set);
+    });
+    return *item.index;
+}
+
+CoverSetStore CoverSetStore::select(const std::set<uint64_t>& ids) const {
+    CoverSetStore result;
+    for (uint64_t id : ids) {
+        auto item = this->entries.find(id);
+        if (item == this->entries.end()) {
+            throw std::invalid_argument("Required set is not passed");
+        }
+        result.entries.emplace(id, item->second);
+    }
+    return result;
+}
+
+}
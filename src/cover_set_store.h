@@ -0,0 +1,64 @@
+#ifndef FIRO_SPARK_COVER_SET_STORE_H
+#define FIRO_SPARK_COVER_SET_STORE_H
+#include "coin.h"
+#include "cover_set.h"
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
+namespace spark {
+
+struct CoverSetData {
+    std::vector<Coin> cover_set; // set of coins used as a cover set for the spend
+    std::vector<unsigned char> cover_set_representation; // a unique representation for the ordered elements of the partial `cover_set` used in the spend
+};
+
+// Cover set data that keeps only the commitments needed for proving (see `CoverSet`)
+struct CompactCoverSetData {
+    CoverSet cover_set;
+    std::vector<unsigned char> cover_set_representation;
+};
+
+// A collection of cover sets shared by reference count rather than copied
+// Sets are immutable once added, so a store is a cheap handle: copying it or selecting part of it never copies coins,
+// and a set stays alive for as long as any store refers to it
+class CoverSetStore {
+public:
+    CoverSetStore();
+
+    // Take ownership of a set; an existing set with the same identifier is replaced in this store only
+    void add(const uint64_t id, CoverSetData&& data);
+    void add(const uint64_t id, const std::shared_ptr<const CoverSetData>& data);
+    // Use an index the caller already maintains for the set, which must cover exactly its coins
+    void add(const uint64_t id, const std::shared_ptr<const CoverSetData>& data, const std::shared_ptr<const CoverSetIndex>& index);
+
+    std::size_t count(const uint64_t id) const;
+    std::size_t size() const;
+    std::vector<uint64_t> ids() const;
+    const CoverSetData& at(const uint64_t id) const;
+    std::shared_ptr<const CoverSetData> get(const uint64_t id) const;
+
+    // Index of a set's coins, built on first use and shared by every store holding the set
+    const CoverSetIndex& get_index(const uint64_t id) const;
+
+    // A store holding only the given sets
+    CoverSetStore select(const std::set<uint64_t>& ids) const;
+
+private:
+    struct Entry {
+        Entry(const std::shared_ptr<const CoverSetData>& data_, const std::shared_ptr<const CoverSetIndex>& index_);
+
+        std::shared_ptr<const CoverSetData> data;
+        mutable std::once_flag index_flag;
+        mutable std::shared_ptr<const CoverSetIndex> index;
+    };
+
+    const Entry& entry(const uint64_t id) const;
+
+    std::unordered_map<uint64_t, std::shared_ptr<const Entry>> entries;
+};
+
+}
+
+#endif
@@ -0,0 +1,102 @@
+#include "generator_tables.h"
+
+namespace spark {
+
+constexpr std::size_t GeneratorTables::range_size;
+constexpr std::size_t GeneratorTables::grootle_size;
+
+GroupElement GeneratorTables::get(const std::string& label) {
+    std::size_t size;
+    const unsigned char* entry = find(label, size);
+    if (!entry || size != 1) {
+        return SparkUtils::hash_generator(label);
+    }
+
+    GroupElement result = read(entry);
+#ifdef SPARK_CHECK_GENERATOR_TABLES
+    if (!(result == SparkUtils::hash_generator(label))) {
+        throw std::runtime_error("Bad embedded generator " + label);
+    }
+#endif
+    return result;
+}
+
+GroupElement GeneratorTables::get(const std::string& label, const std::size_t index) {
+    const std::string indexed_label = label + " " + std::to_string(index);
+
+    std::size_t size;
+    const unsigned char* entries = find(label, size);
+    if (!entries || size == 1 || index >= size) {
+        return SparkUtils::hash_generator(indexed_label);
+    }
+
+    GroupElement result = read(entries + index*GroupElement::affine_size);
+#ifdef SPARK_CHECK_GENERATOR_TABLES
+    if (!(result == SparkUtils::hash_generator(indexed_label))) {
+        throw std::runtime_error("Bad embedded generator " + indexed_label);
+    }
+#endif
+    return result;
+}
+
+bool GeneratorTables::check() {
+    for (const std::string& label : { LABEL_GENERATOR_F, LABEL_GENERATOR_H, LABEL_GENERATOR_U }) {
+        std::size_t size;
+        if (!(read(find(label, size)) == SparkUtils::hash_generator(label))) {
+            return false;
+        }
+    }
+
+    for (const std::string& label : { LABEL_GENERATOR_G_RANGE, LABEL_GENERATOR_H_RANGE, LABEL_GENERATOR_G_GROOTLE, LABEL_GENERATOR_H_GROOTLE }) {
+        std::size_t size;
+        const unsigned char* entries = find(label, size);
+        for (std::size_t i = 0; i < size; i++) {
+            if (!(read(entries + i*GroupElement::affine_size) == SparkUtils::hash_generator(label + " " + std::to_string(i)))) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+const unsigned char* GeneratorTables::find(const std::string& label, std::size_t& size) {
+    size = 1;
+    if (label == LABEL_GENERATOR_F) {
+        return F;
+    }
+    if (label == LABEL_GENERATOR_H) {
+        return H;
+    }
+    if (label == LABEL_GENERATOR_U) {
+        return U;
+    }
+
+    size = range_size;
+    if (label == LABEL_GENERATOR_G_RANGE) {
+        return G_range[0];
+    }
+    if (label == LABEL_GENERATOR_H_RANGE) {
+        return H_range[0];
+    }
+
+    size = grootle_size;
+    if (label == LABEL_GENERATOR_G_GROOTLE) {
+        return G_grootle[0];
+    }
+    if (label == LABEL_GENERATOR_H_GROOTLE) {
+        return H_grootle[0];
+    }
+
+    size = 0;
+    return nullptr;
+}
+
+// The table holds valid points, but reading still checks the encoding, which costs far less than deriving it
+GroupElement GeneratorTables::read(const unsigned char* entry) {
+    GroupElement result;
+    result.deserialize_affine(entry);
+    return result;
+}
+
+}
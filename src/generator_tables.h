@@ -0,0 +1,44 @@
+#ifndef FIRO_SPARK_GENERATOR_TABLES_H
+#define FIRO_SPARK_GENERATOR_TABLES_H
+#include "util.h"
+
+namespace spark {
+
+using namespace secp_primitives;
+
+// Generators derived from their labels by SparkUtils::hash_generator, embedded so that constructing Params
+// does not pay for thousands of hash-to-curve operations.
+// The tables live in generator_tables_data.cpp, which tools/generator_tables.cpp writes from the same labels;
+// each entry is an affine encoding of GroupElement::affine_size bytes.
+// Building with SPARK_CHECK_GENERATOR_TABLES re-derives every generator as it is read and compares the two.
+class GeneratorTables {
+public:
+    // Indexed generators embedded per label, enough for the deployed parameters; any beyond these are derived
+    static constexpr std::size_t range_size = 64*16;
+    static constexpr std::size_t grootle_size = 8*5;
+
+    // The generator for `label`
+    static GroupElement get(const std::string& label);
+    // The generator for `label` followed by " " and `index`, as used for generator vectors
+    static GroupElement get(const std::string& label, const std::size_t index);
+
+    // Re-derive every embedded generator and compare it with its table entry
+    static bool check();
+
+private:
+    // The embedded entries for `label`, with their count; nullptr if the label has no table
+    static const unsigned char* find(const std::string& label, std::size_t& size);
+    static GroupElement read(const unsigned char* entry);
+
+    static const unsigned char F[GroupElement::affine_size];
+    static const unsigned char H[GroupElement::affine_size];
+    static const unsigned char U[GroupElement::affine_size];
+    static const unsigned char G_range[range_size][GroupElement::affine_size];
+    static const unsigned char H_range[range_size][GroupElement::affine_size];
+    static const unsigned char G_grootle[grootle_size][GroupElement::affine_size];
+    static const unsigned char H_grootle[grootle_size][GroupElement::affine_size];
+};
+
+}
+
+#endif
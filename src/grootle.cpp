@@ -1,5 +1,6 @@
 #include "grootle.h"
 #include "transcript.h"
+#include <algorithm>
 
 namespace spark {
 
@@ -13,12 +14,14 @@ Grootle::Grootle(
         const std::vector<GroupElement>& Gi_,
         const std::vector<GroupElement>& Hi_,
         const std::size_t n_,
-        const std::size_t m_)
+        const std::size_t m_,
+        Executor& executor_)
         : H (H_)
         , Gi (Gi_)
         , Hi (Hi_)
         , n (n_)
         , m (m_)
+        , executor (&executor_)
 {
     if (!(n > 1 && m > 1)) {
         throw std::invalid_argument("Bad Grootle size parameters!");
@@ -141,32 +144,263 @@ static void compute_batch_fis(
     }
 }
 
-void Grootle::prove(
+// Coefficients of the convolution polynomials for a range of commitment indexes, grouped by power
+// The final index also accounts for the padded indexes, so its polynomial is precomputed
+class ConvolutionTerms {
+public:
+    ConvolutionTerms(
+            const std::vector<Scalar>& a_,
+            const std::vector<Scalar>& sigma_,
+            const std::vector<Scalar>& last_,
+            const std::size_t size_,
+            const std::size_t n_,
+            const std::size_t m_)
+            : a(a_)
+            , sigma(sigma_)
+            , last(last_)
+            , size(size_)
+            , n(n_)
+            , m(m_)
+    {}
+
+    void columns(const std::size_t start, const std::size_t end, std::vector<std::vector<Scalar>>& P) const {
+        P.resize(m);
+        for (std::size_t j = 0; j < m; j++) {
+            P[j].clear();
+            P[j].reserve(end - start);
+        }
+
+        std::vector<Scalar> coefficients;
+        for (std::size_t i = start; i < end; i++) {
+            if (i == size - 1) {
+                coefficients = last;
+            } else {
+                std::vector<std::size_t> I = decompose(i, n, m);
+                coefficients.clear();
+                coefficients.push_back(a[I[0]]);
+                coefficients.push_back(sigma[I[0]]);
+                for (std::size_t j = 1; j < m; ++j) {
+                    convolve(sigma[j*n + I[j]], a[j*n + I[j]], coefficients);
+                }
+            }
+            for (std::size_t j = 0; j < m; j++) {
+                P[j].emplace_back(coefficients[j]);
+            }
+        }
+    }
+
+    std::size_t get_size() const { return size; }
+    std::size_t get_m() const { return m; }
+
+private:
+    const std::vector<Scalar>& a;
+    const std::vector<Scalar>& sigma;
+    const std::vector<Scalar>& last;
+    const std::size_t size;
+    const std::size_t n;
+    const std::size_t m;
+};
+
+static Scalar sum(const std::vector<Scalar>& P) {
+    Scalar result;
+    for (const Scalar& p : P) {
+        result += p;
+    }
+    return result;
+}
+
+// Commitment sets given as vectors of points
+class VectorCommitments {
+public:
+    VectorCommitments(const std::vector<GroupElement>& S_, const std::vector<GroupElement>& V_)
+            : S(S_)
+            , V(V_)
+    {}
+
+    std::size_t size() const { return S.size(); }
+    bool consistent() const { return S.size() == V.size(); }
+    const GroupElement& get_S(const std::size_t i) const { return S[i]; }
+    const GroupElement& get_V(const std::size_t i) const { return V[i]; }
+
+    void set_offsets(const GroupElement& S1, const GroupElement& V1) {
+        S_offset = S;
+        V_offset = V;
+        GroupElement S1_inverse = S1.inverse();
+        GroupElement V1_inverse = V1.inverse();
+        for (std::size_t k = 0; k < S_offset.size(); k++) {
+            S_offset[k] += S1_inverse;
+            V_offset[k] += V1_inverse;
+        }
+    }
+
+    void multiples(const ConvolutionTerms& terms, std::vector<GroupElement>& S_multiples, std::vector<GroupElement>& V_multiples, Executor& executor) const {
+        std::vector<std::vector<Scalar>> P;
+        terms.columns(0, terms.get_size(), P);
+        for (const std::vector<Scalar>& P_j : P) {
+            S_multiples.emplace_back(secp_primitives::MultiExponent(S_offset, P_j).get_multiple(executor));
+            V_multiples.emplace_back(secp_primitives::MultiExponent(V_offset, P_j).get_multiple(executor));
+        }
+    }
+
+    // Add the bound commitments to the final batch as one aggregate term, computed on the executor
+    void bind(const Scalar& bind_weight, const std::vector<Scalar>& commit_scalars, std::vector<GroupElement>& points, std::vector<Scalar>& scalars, Executor& executor) const {
+        std::vector<GroupElement> bound_points;
+        std::vector<Scalar> bound_scalars;
+        bound_points.reserve(2*S.size());
+        bound_scalars.reserve(2*S.size());
+        for (std::size_t i = 0; i < S.size(); i++) {
+            bound_points.emplace_back(S[i]);
+            bound_scalars.emplace_back(commit_scalars[i]);
+            bound_points.emplace_back(V[i]);
+            bound_scalars.emplace_back(commit_scalars[i]*bind_weight);
+        }
+
+        points.emplace_back(secp_primitives::MultiExponent(bound_points, bound_scalars).get_multiple(executor));
+        scalars.emplace_back(ONE);
+    }
+
+private:
+    const std::vector<GroupElement>& S;
+    const std::vector<GroupElement>& V;
+    std::vector<GroupElement> S_offset;
+    std::vector<GroupElement> V_offset;
+};
+
+// Commitment sets given as affine arrays; the offsets are applied to the multiscalar multiplication results instead of every point
+class CompactCommitments {
+public:
+    CompactCommitments(const CoverSet& set_)
+            : set(set_)
+    {}
+
+    std::size_t size() const { return set.size(); }
+    bool consistent() const { return true; }
+    GroupElement get_S(const std::size_t i) const { return set.get_S(i); }
+    GroupElement get_V(const std::size_t i) const { return set.get_C(i); }
+
+    void set_offsets(const GroupElement& S1, const GroupElement& V1) {
+        S1_inverse = S1.inverse();
+        V1_inverse = V1.inverse();
+    }
+
+    void multiples(const ConvolutionTerms& terms, std::vector<GroupElement>& S_multiples, std::vector<GroupElement>& V_multiples, Executor& executor) const {
+        std::vector<std::vector<Scalar>> P;
+        terms.columns(0, terms.get_size(), P);
+        for (const std::vector<Scalar>& P_j : P) {
+            Scalar P_sum = sum(P_j);
+            S_multiples.emplace_back(secp_primitives::MultiExponent(set.S_data(), P_j).get_multiple(executor) + S1_inverse*P_sum);
+            V_multiples.emplace_back(secp_primitives::MultiExponent(set.C_data(), P_j).get_multiple(executor) + V1_inverse*P_sum);
+        }
+    }
+
+    // Add the bound commitments to the final batch as two aggregate terms
+    void bind(const Scalar& bind_weight, const std::vector<Scalar>& commit_scalars, std::vector<GroupElement>& points, std::vector<Scalar>& scalars, Executor& executor) const {
+        std::vector<Scalar> weighted_scalars;
+        weighted_scalars.reserve(commit_scalars.size());
+        for (const Scalar& scalar : commit_scalars) {
+            weighted_scalars.emplace_back(scalar*bind_weight);
+        }
+
+        points.emplace_back(secp_primitives::MultiExponent(set.S_data(), commit_scalars).get_multiple(executor));
+        scalars.emplace_back(ONE);
+        points.emplace_back(secp_primitives::MultiExponent(set.C_data(), weighted_scalars).get_multiple(executor));
+        scalars.emplace_back(ONE);
+    }
+
+private:
+    const CoverSet& set;
+    GroupElement S1_inverse;
+    GroupElement V1_inverse;
+};
+
+// Commitment sets read in chunks; only one chunk of points and coefficients is held at a time
+class StreamingCommitments {
+public:
+    StreamingCommitments(CoverSetReader& reader_, const std::size_t chunk_size_)
+            : reader(reader_)
+            , chunk_size(chunk_size_)
+    {}
+
+    std::size_t size() const { return reader.size(); }
+    bool consistent() const { return true; }
+    GroupElement get_S(const std::size_t i) const { return read(i, true); }
+    GroupElement get_V(const std::size_t i) const { return read(i, false); }
+
+    void set_offsets(const GroupElement& S1, const GroupElement& V1) {
+        S1_inverse = S1.inverse();
+        V1_inverse = V1.inverse();
+    }
+
+    void multiples(const ConvolutionTerms& terms, std::vector<GroupElement>& S_multiples, std::vector<GroupElement>& V_multiples, Executor& executor) const {
+        const std::size_t m = terms.get_m();
+        S_multiples.assign(m, GroupElement());
+        V_multiples.assign(m, GroupElement());
+        std::vector<Scalar> P_sums(m);
+
+        std::vector<unsigned char> S_chunk(chunk_size*GroupElement::affine_size);
+        std::vector<unsigned char> C_chunk(chunk_size*GroupElement::affine_size);
+        std::vector<std::vector<Scalar>> P;
+        for (std::size_t start = 0; start < size(); start += chunk_size) {
+            const std::size_t end = std::min(size(), start + chunk_size);
+            reader.read(start, end - start, S_chunk.data(), C_chunk.data());
+            terms.columns(start, end, P);
+            for (std::size_t j = 0; j < m; j++) {
+                S_multiples[j] += secp_primitives::MultiExponent(S_chunk.data(), P[j]).get_multiple(executor);
+                V_multiples[j] += secp_primitives::MultiExponent(C_chunk.data(), P[j]).get_multiple(executor);
+                P_sums[j] += sum(P[j]);
+            }
+        }
+
+        for (std::size_t j = 0; j < m; j++) {
+            S_multiples[j] += S1_inverse*P_sums[j];
+            V_multiples[j] += V1_inverse*P_sums[j];
+        }
+    }
+
+private:
+    GroupElement read(const std::size_t i, const bool serial) const {
+        unsigned char S[GroupElement::affine_size];
+        unsigned char C[GroupElement::affine_size];
+        reader.read(i, 1, S, C);
+        GroupElement result;
+        result.deserialize_affine(serial ? S : C);
+        return result;
+    }
+
+    CoverSetReader& reader;
+    const std::size_t chunk_size;
+    GroupElement S1_inverse;
+    GroupElement V1_inverse;
+};
+
+template <typename Commitments>
+void Grootle::prove_commitments(
         const std::size_t l,
         const Scalar& s,
-        const std::vector<GroupElement>& S,
+        Commitments& commitments,
         const GroupElement& S1,
         const Scalar& v,
-        const std::vector<GroupElement>& V,
         const GroupElement& V1,
         const std::vector<unsigned char>& root,
         GrootleProof& proof) {
+    SPARK_TIME_STAGE(GROOTLE_PROVE);
+
     // Check statement validity
     std::size_t N = (std::size_t) pow(n, m); // padded input size
-    std::size_t size = S.size(); // actual input size
+    std::size_t size = commitments.size(); // actual input size
     if (l >= size) {
         throw std::invalid_argument("Bad Grootle secret index!");
     }
-    if (V.size() != S.size()) {
+    if (!commitments.consistent()) {
         throw std::invalid_argument("Bad Grootle input vector sizes!");
     }
     if (size > N || size == 0) {
         throw std::invalid_argument("Bad Grootle size parameter!");
     }
-    if (S[l] + S1.inverse() != H*s) {
+    if (commitments.get_S(l) + S1.inverse() != H*s) {
         throw std::invalid_argument("Bad Grootle proof statement!");
     }
-    if (V[l] + V1.inverse() != H*v) {
+    if (commitments.get_V(l) + V1.inverse() != H*v) {
         throw std::invalid_argument("Bad Grootle proof statement!");
     }
 
@@ -181,12 +415,13 @@ void Grootle::prove(
     transcript.add("S1", S1);
     transcript.add("V1", V1);
 
-    // Compute A
+    // Compute A; the first entry of each row is replaced so that the row sums to zero
     std::vector<Scalar> a;
     a.resize(n*m);
+    RandomGenerator::get().randomize(a);
     for (std::size_t j = 0; j < m; j++) {
+        a[j*n] = ZERO;
         for (std::size_t i = 1; i < n; i++) {
-            a[j*n + i].randomize();
             a[j*n] -= a[j*n + i];
         }
     }
@@ -210,20 +445,7 @@ void Grootle::prove(
     rB.randomize();
     proof.B = vector_commit(Gi, Hi, sigma, c, H, rB);
 
-    // Compute convolution terms
-    std::vector<std::vector<Scalar>> P_i_j;
-    P_i_j.resize(size);
-    for (std::size_t i = 0; i < size - 1; ++i)
-    {
-        std::vector<Scalar>& coefficients = P_i_j[i];
-        std::vector<std::size_t> I = decompose(i, n, m);
-        coefficients.push_back(a[I[0]]);
-        coefficients.push_back(sigma[I[0]]);
-        for (std::size_t j = 1; j < m; ++j) {
-            convolve(sigma[j*n + I[j]], a[j*n + I[j]], coefficients);
-        }
-    }
-
+    // Convolution terms for all but the final index are computed as needed, so the prover never holds the full coefficient matrix
     /*
      * To optimize calculation of sum of all polynomials indices 's' = size-1 through 'n^m-1' we use the
      * fact that sum of all of elements in each row of 'a' array is zero. Computation is done by going
@@ -271,44 +493,30 @@ void Grootle::prove(
             p_i_sum[j + k] += polynomial[k];
     }
 
-    P_i_j[size - 1] = p_i_sum;
+    ConvolutionTerms terms(a, sigma, p_i_sum, size, n, m);
 
     // Perform the commitment offsets
-    std::vector<GroupElement> S_offset(S);
-    std::vector<GroupElement> V_offset(V);
-    GroupElement S1_inverse = S1.inverse();
-    GroupElement V1_inverse = V1.inverse();
-    for (std::size_t k = 0; k < S_offset.size(); k++) {
-        S_offset[k] += S1_inverse;
-        V_offset[k] += V1_inverse;
-    }
+    commitments.set_offsets(S1, V1);
 
     // Generate masks
     std::vector<Scalar> rho_S, rho_V;
     rho_S.resize(m);
     rho_V.resize(m);
-    for (std::size_t j = 0; j < m; j++) {
-        rho_S[j].randomize();
-        rho_V[j].randomize();
-    }
+    RandomGenerator::get().randomize(rho_S);
+    RandomGenerator::get().randomize(rho_V);
+
+    std::vector<GroupElement> S_multiples, V_multiples;
+    commitments.multiples(terms, S_multiples, V_multiples, *this->executor);
 
     proof.X.reserve(m);
     proof.X1.reserve(m);
     for (std::size_t j = 0; j < m; ++j)
     {
-        std::vector<Scalar> P_i;
-        P_i.reserve(size);
-        for (std::size_t i = 0; i < size; ++i){
-            P_i.emplace_back(P_i_j[i][j]);
-        }
-        
         // S
-        secp_primitives::MultiExponent mult_S(S_offset, P_i);
-        proof.X.emplace_back(mult_S.get_multiple() + H*rho_S[j]);
+        proof.X.emplace_back(S_multiples[j] + H*rho_S[j]);
         
         // V
-        secp_primitives::MultiExponent mult_V(V_offset, P_i);
-        proof.X1.emplace_back(mult_V.get_multiple() + H*rho_V[j]);
+        proof.X1.emplace_back(V_multiples[j] + H*rho_V[j]);
     }
 
     // Challenge
@@ -345,33 +553,16 @@ void Grootle::prove(
     proof.zV -= sumV;
 }
 
-// Verify a single proof
-bool Grootle::verify(
-        const std::vector<GroupElement>& S,
-        const GroupElement& S1,
-        const std::vector<GroupElement>& V,
-        const GroupElement& V1,
-        const std::vector<unsigned char>& root,
-        const std::size_t size,
-        const GrootleProof& proof) {
-    std::vector<GroupElement> S1_batch = {S1};
-    std::vector<GroupElement> V1_batch = {V1};
-    std::vector<std::size_t> size_batch = {size};
-    std::vector<std::vector<unsigned char>> root_batch = {root};
-    std::vector<GrootleProof> proof_batch = {proof};
-
-    return verify(S, S1_batch, V, V1_batch, root_batch, size_batch, proof_batch);
-}
-
-// Verify a batch of proofs
-bool Grootle::verify(
-        const std::vector<GroupElement>& S,
+template <typename Commitments>
+bool Grootle::verify_commitments(
+        const Commitments& commitments,
         const std::vector<GroupElement>& S1,
-        const std::vector<GroupElement>& V,
         const std::vector<GroupElement>& V1,
         const std::vector<std::vector<unsigned char>>& roots,
         const std::vector<std::size_t>& sizes,
         const std::vector<GrootleProof>& proofs) {
+    SPARK_TIME_STAGE(GROOTLE_VERIFY);
+
     // Sanity checks
     if (n < 2 || m < 2) {
 //        LogPrintf("Verifier parameters are invalid");
@@ -380,15 +571,16 @@ bool Grootle::verify(
     std::size_t M = proofs.size();
     std::size_t N = (std::size_t)pow(n, m);
 
-    if (S.size() == 0) {
+    const std::size_t commit_size = commitments.size();
+    if (commit_size == 0) {
 //        LogPrintf("Cannot have empty commitment set");
         return false;
     }
-    if (S.size() > N) {
+    if (commit_size > N) {
 //        LogPrintf("Commitment set is too large");
         return false;
     }
-    if (S.size() != V.size()) {
+    if (!commitments.consistent()) {
 //        LogPrintf("Commitment set sizes do not match");
         return false;
     }
@@ -419,20 +611,13 @@ bool Grootle::verify(
     }
 
     // Commitment binding weight; intentionally restricted range for efficiency, but must be nonzero
-    // NOTE: this may initialize with a PRNG, which should be sufficient for this use
-    std::random_device generator;
-    std::uniform_int_distribution<uint16_t> distribution;
-    Scalar bind_weight(ZERO);
-    while (bind_weight == ZERO) {
-        bind_weight = Scalar(distribution(generator));
-    }
-
-    // Bind the commitment lists
-    std::vector<GroupElement> commits;
-    commits.reserve(S.size());
-    for (std::size_t i = 0; i < S.size(); i++) {
-        commits.emplace_back(S[i] + V[i]*bind_weight);
+    uint16_t bind_weight_value = 0;
+    while (bind_weight_value == 0) {
+        unsigned char bytes[2];
+        RandomGenerator::get().fill(bytes, sizeof(bytes));
+        bind_weight_value = uint16_t(bytes[0]) << 8 | bytes[1];
     }
+    Scalar bind_weight((uint64_t) bind_weight_value);
 
     // Final batch multiscalar multiplication
     Scalar H_scalar;
@@ -441,12 +626,12 @@ bool Grootle::verify(
     std::vector<Scalar> commit_scalars;
     Gi_scalars.resize(n*m);
     Hi_scalars.resize(n*m);
-    commit_scalars.resize(commits.size());
+    commit_scalars.resize(commit_size);
 
     // Set up the final batch elements
     std::vector<GroupElement> points;
     std::vector<Scalar> scalars;
-    std::size_t final_size = 1 + 2*m*n + commits.size(); // F, (Gi), (Hi), (commits)
+    std::size_t final_size = 1 + 2*m*n + commit_size; // F, (Gi), (Hi), (commits)
     for (std::size_t t = 0; t < M; t++) {
         final_size += 2 + proofs[t].X.size() + proofs[t].X1.size(); // A, B, (Gs), (Gv)
     }
@@ -455,9 +640,9 @@ bool Grootle::verify(
 
     // Index decomposition, which is common among all proofs
     std::vector<std::vector<std::size_t> > I_;
-    I_.reserve(commits.size());
-    I_.resize(commits.size());
-    for (std::size_t i = 0; i < commits.size(); i++) {
+    I_.reserve(commit_size);
+    I_.resize(commit_size);
+    for (std::size_t i = 0; i < commit_size; i++) {
         I_[i] = decompose(i, n, m);
     }
 
@@ -513,7 +698,7 @@ bool Grootle::verify(
 
         Scalar f_sum;
         Scalar f_i(uint64_t(1));
-        std::vector<Scalar>::iterator ptr = commit_scalars.begin() + commits.size() - size;
+        std::vector<Scalar>::iterator ptr = commit_scalars.begin() + commit_size - size;
         compute_batch_fis(f_sum, f_i, m, f_, w2, ptr, ptr, ptr + size - 1, n);
 
         Scalar pow(uint64_t(1));
@@ -533,7 +718,7 @@ bool Grootle::verify(
         }
 
         f_sum += pow;
-        commit_scalars[commits.size() - 1] += pow * w2;
+        commit_scalars[commit_size - 1] += pow * w2;
 
         // S1, V1
         points.emplace_back(S1[t] + V1[t] * bind_weight);
@@ -557,17 +742,139 @@ bool Grootle::verify(
         points.emplace_back(Hi[i]);
         scalars.emplace_back(Hi_scalars[i]);
     }
-    for (std::size_t i = 0; i < commits.size(); i++) {
-        points.emplace_back(commits[i]);
-        scalars.emplace_back(commit_scalars[i]);
-    }
+
+    // Bind the commitment lists
+    commitments.bind(bind_weight, commit_scalars, points, scalars, *this->executor);
 
     // Verify the batch
     secp_primitives::MultiExponent result(points, scalars);
-    if (result.get_multiple().isInfinity()) {
+    if (result.get_multiple(*this->executor).isInfinity()) {
         return true;
     }
     return false;
 }
 
-}
\ No newline at end of file
+
+void Grootle::prove(
+        const std::size_t l,
+        const Scalar& s,
+        const std::vector<GroupElement>& S,
+        const GroupElement& S1,
+        const Scalar& v,
+        const std::vector<GroupElement>& V,
+        const GroupElement& V1,
+        const std::vector<unsigned char>& root,
+        GrootleProof& proof) {
+    VectorCommitments commitments(S, V);
+    prove_commitments(l, s, commitments, S1, v, V1, root, proof);
+}
+
+void Grootle::prove(
+        const std::size_t l,
+        const Scalar& s,
+        const CoverSet& set,
+        const GroupElement& S1,
+        const Scalar& v,
+        const GroupElement& V1,
+        const std::vector<unsigned char>& root,
+        GrootleProof& proof) {
+    CompactCommitments commitments(set);
+    prove_commitments(l, s, commitments, S1, v, V1, root, proof);
+}
+
+// Memory held while a streaming chunk of `chunk_size` commitments is processed: both affine point buffers,
+// the m columns of coefficients, and one multiscalar multiplication at a time with its copies and scratch space
+static std::size_t streaming_chunk_bytes(const std::size_t chunk_size, const std::size_t m, const Executor& executor) {
+    return chunk_size*2*GroupElement::affine_size
+        + chunk_size*m*(sizeof(Scalar) + Scalar::allocated_size())
+        + secp_primitives::MultiExponent::memory_required(chunk_size, executor);
+}
+
+// The largest chunk that fits in `memory_limit`, but at least one commitment
+static std::size_t streaming_chunk_size(const std::size_t size, const std::size_t m, const std::size_t memory_limit, const Executor& executor) {
+    std::size_t low = 1;
+    std::size_t high = std::max<std::size_t>(size, 1);
+    while (low < high) {
+        const std::size_t middle = low + (high - low + 1) / 2;
+        if (streaming_chunk_bytes(middle, m, executor) <= memory_limit) {
+            low = middle;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return low;
+}
+
+void Grootle::prove(
+        const std::size_t l,
+        const Scalar& s,
+        CoverSetReader& reader,
+        const GroupElement& S1,
+        const Scalar& v,
+        const GroupElement& V1,
+        const std::vector<unsigned char>& root,
+        GrootleProof& proof,
+        const std::size_t memory_limit) {
+    StreamingCommitments commitments(reader, streaming_chunk_size(reader.size(), m, memory_limit, *executor));
+    prove_commitments(l, s, commitments, S1, v, V1, root, proof);
+}
+
+// Verify a single proof
+bool Grootle::verify(
+        const std::vector<GroupElement>& S,
+        const GroupElement& S1,
+        const std::vector<GroupElement>& V,
+        const GroupElement& V1,
+        const std::vector<unsigned char>& root,
+        const std::size_t size,
+        const GrootleProof& proof) {
+    std::vector<GroupElement> S1_batch = {S1};
+    std::vector<GroupElement> V1_batch = {V1};
+    std::vector<std::size_t> size_batch = {size};
+    std::vector<std::vector<unsigned char>> root_batch = {root};
+    std::vector<GrootleProof> proof_batch = {proof};
+
+    return verify(S, S1_batch, V, V1_batch, root_batch, size_batch, proof_batch);
+}
+
+// Verify a single proof against a compact cover set
+bool Grootle::verify(
+        const CoverSet& set,
+        const GroupElement& S1,
+        const GroupElement& V1,
+        const std::vector<unsigned char>& root,
+        const std::size_t size,
+        const GrootleProof& proof) {
+    std::vector<GroupElement> S1_batch = {S1};
+    std::vector<GroupElement> V1_batch = {V1};
+    std::vector<std::size_t> size_batch = {size};
+    std::vector<std::vector<unsigned char>> root_batch = {root};
+    std::vector<GrootleProof> proof_batch = {proof};
+
+    return verify(set, S1_batch, V1_batch, root_batch, size_batch, proof_batch);
+}
+
+// Verify a batch of proofs
+bool Grootle::verify(
+        const std::vector<GroupElement>& S,
+        const std::vector<GroupElement>& S1,
+        const std::vector<GroupElement>& V,
+        const std::vector<GroupElement>& V1,
+        const std::vector<std::vector<unsigned char>>& roots,
+        const std::vector<std::size_t>& sizes,
+        const std::vector<GrootleProof>& proofs) {
+    return verify_commitments(VectorCommitments(S, V), S1, V1, roots, sizes, proofs);
+}
+
+// Verify a batch of proofs against a compact cover set
+bool Grootle::verify(
+        const CoverSet& set,
+        const std::vector<GroupElement>& S1,
+        const std::vector<GroupElement>& V1,
+        const std::vector<std::vector<unsigned char>>& roots,
+        const std::vector<std::size_t>& sizes,
+        const std::vector<GrootleProof>& proofs) {
+    return verify_commitments(CompactCommitments(set), S1, V1, roots, sizes, proofs);
+}
+
+}
@@ -2,8 +2,8 @@
 #define FIRO_LIBSPARK_GROOTLE_H
 
 #include "grootle_proof.h"
+#include "cover_set.h"
 #include "../secp256k1/include/MultiExponent.h"
-#include <random>
 #include "util.h"
 
 namespace spark {
@@ -16,7 +16,8 @@ public:
         const std::vector<GroupElement>& Gi,
         const std::vector<GroupElement>& Hi,
         const std::size_t n,
-        const std::size_t m
+        const std::size_t m,
+        Executor& executor = Executor::get_default()
     );
 
     void prove(const std::size_t l,
@@ -43,12 +44,67 @@ public:
         const std::vector<std::size_t>& sizes,
         const std::vector<GrootleProof>& proofs); // batch of proofs
 
+    // Variants taking a compact cover set, whose value commitments play the role of `V`
+    void prove(const std::size_t l,
+        const Scalar& s,
+        const CoverSet& set,
+        const GroupElement& S1,
+        const Scalar& v,
+        const GroupElement& V1,
+        const std::vector<unsigned char>& root,
+        GrootleProof& proof);
+    bool verify(const CoverSet& set,
+        const GroupElement& S1,
+        const GroupElement& V1,
+        const std::vector<unsigned char>& root,
+        const std::size_t size,
+        const GrootleProof& proof); // single proof
+    bool verify(const CoverSet& set,
+        const std::vector<GroupElement>& S1,
+        const std::vector<GroupElement>& V1,
+        const std::vector<std::vector<unsigned char>>& roots,
+        const std::vector<std::size_t>& sizes,
+        const std::vector<GrootleProof>& proofs); // batch of proofs
+
+    // Streaming variant that reads the cover set in chunks, so its memory use does not grow with the set size.
+    // `memory_limit` bounds in bytes the memory held for a chunk: its points, coefficients and multiscalar multiplication scratch space.
+    // Smaller chunks mean smaller, less efficient multiscalar multiplications
+    void prove(const std::size_t l,
+        const Scalar& s,
+        CoverSetReader& reader,
+        const GroupElement& S1,
+        const Scalar& v,
+        const GroupElement& V1,
+        const std::vector<unsigned char>& root,
+        GrootleProof& proof,
+        const std::size_t memory_limit = DEFAULT_STREAMING_MEMORY_LIMIT);
+
+    static constexpr std::size_t DEFAULT_STREAMING_MEMORY_LIMIT = 1 << 20;
+
 private:
+    template <typename Commitments>
+    void prove_commitments(const std::size_t l,
+        const Scalar& s,
+        Commitments& commitments,
+        const GroupElement& S1,
+        const Scalar& v,
+        const GroupElement& V1,
+        const std::vector<unsigned char>& root,
+        GrootleProof& proof);
+    template <typename Commitments>
+    bool verify_commitments(const Commitments& commitments,
+        const std::vector<GroupElement>& S1,
+        const std::vector<GroupElement>& V1,
+        const std::vector<std::vector<unsigned char>>& roots,
+        const std::vector<std::size_t>& sizes,
+        const std::vector<GrootleProof>& proofs);
+
     GroupElement H;
     std::vector<GroupElement> Gi;
     std::vector<GroupElement> Hi;
     std::size_t n;
     std::size_t m;
+    Executor* executor; // splits the large multiscalar multiplications
 };
 
 }
@@ -16,9 +16,26 @@ public:
         return 2*GroupElement::memoryRequired() + 2*m*GroupElement::memoryRequired() + m*(n-1)*Scalar::memoryRequired() + 3*Scalar::memoryRequired();
     }
 
+    // Unlike memoryRequired(n, m), this includes the length prefixes of the serialized vectors
+    static inline std::size_t serializedSize(std::size_t n, std::size_t m) {
+        return 2*GroupElement::memoryRequired() + 2*(GetSizeOfCompactSize(m) + m*GroupElement::memoryRequired()) + GetSizeOfCompactSize(m*(n-1)) + m*(n-1)*Scalar::memoryRequired() + 3*Scalar::memoryRequired();
+    }
+
     ADD_SERIALIZE_METHODS;
     template <typename Stream, typename Operation>
     inline void SerializationOp(Stream& s, Operation ser_action) {
+        // Read the points first and decompress them together, unless an enclosing object already batches them
+        if (ser_action.ForRead() && !GroupElement::lazy_deserialization()) {
+            {
+                GroupElement::LazyDeserialization lazy;
+                SerializationOp(s, ser_action);
+            }
+            std::vector<GroupElement*> points;
+            getPoints(points);
+            GroupElement::decompress_all(points);
+            return;
+        }
+
         READWRITE(A);
         READWRITE(B);
         READWRITE(X);
@@ -29,6 +46,15 @@ public:
         READWRITE(zV);
     }
 
+    void getPoints(std::vector<GroupElement*>& points) {
+        points.emplace_back(&A);
+        points.emplace_back(&B);
+        for (GroupElement& point : X)
+            points.emplace_back(&point);
+        for (GroupElement& point : X1)
+            points.emplace_back(&point);
+    }
+
 public:
     GroupElement A;
     GroupElement B;
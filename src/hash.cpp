@@ -11,12 +11,15 @@ Hash::Hash(const std::string label) {
 
 	// Write the protocol and mode information
 	std::vector<unsigned char> protocol(LABEL_PROTOCOL.begin(), LABEL_PROTOCOL.end());
+	SPARK_COUNT(HASH_BYTES, protocol.size());
 	EVP_DigestUpdate(this->ctx, protocol.data(), protocol.size());
+	SPARK_COUNT(HASH_BYTES, sizeof(HASH_MODE_FUNCTION));
 	EVP_DigestUpdate(this->ctx, &HASH_MODE_FUNCTION, sizeof(HASH_MODE_FUNCTION));
 
 	// Include the label with size
 	include_size(label.size());
 	std::vector<unsigned char> label_bytes(label.begin(), label.end());
+	SPARK_COUNT(HASH_BYTES, label_bytes.size());
 	EVP_DigestUpdate(this->ctx, label_bytes.data(), label_bytes.size());
 }
 
@@ -28,6 +31,7 @@ Hash::~Hash() {
 // Include serialized data in the hash function
 void Hash::include(CDataStream& data) {
 	include_size(data.size());
+	SPARK_COUNT(HASH_BYTES, data.size());
 	EVP_DigestUpdate(this->ctx, reinterpret_cast<unsigned char *>(data.data()), data.size());
 }
 
@@ -38,6 +42,7 @@ std::vector<unsigned char> Hash::finalize() {
     result.resize(EVP_MD_size(EVP_sha512()));
 
     unsigned int TEMP;
+    SPARK_COUNT(HASH_FINALIZATIONS, 1);
     EVP_DigestFinal_ex(this->ctx, result.data(), &TEMP);
 
     return result;
@@ -67,11 +72,13 @@ Scalar Hash::finalize_scalar() {
         EVP_MD_CTX_copy_ex(state_counter, this->ctx);
 
         // Embed the counter
+        SPARK_COUNT(HASH_BYTES, sizeof(counter));
         EVP_DigestUpdate(state_counter, &counter, sizeof(counter));
 
         // Finalize the hash with a temporary state
         EVP_MD_CTX_copy_ex(state_finalize, state_counter);
         unsigned int TEMP; // We already know the digest length!
+        SPARK_COUNT(HASH_FINALIZATIONS, 1);
         EVP_DigestFinal_ex(state_finalize, hash.data(), &TEMP);
 
         // Check for scalar validity
@@ -116,11 +123,13 @@ GroupElement Hash::finalize_group() {
         EVP_MD_CTX_copy_ex(state_counter, this->ctx);
 
         // Embed the counter
+        SPARK_COUNT(HASH_BYTES, sizeof(counter));
         EVP_DigestUpdate(state_counter, &counter, sizeof(counter));
 
         // Finalize the hash with a temporary state
         EVP_MD_CTX_copy_ex(state_finalize, state_counter);
         unsigned int TEMP; // We already know the digest length!
+        SPARK_COUNT(HASH_FINALIZATIONS, 1);
         EVP_DigestFinal_ex(state_finalize, hash.data(), &TEMP);
 
         // Assemble the serialized input:
@@ -154,6 +163,7 @@ GroupElement Hash::finalize_group() {
 void Hash::include_size(std::size_t size) {
 	CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
 	stream << (uint64_t)size;
+	SPARK_COUNT(HASH_BYTES, stream.size());
 	EVP_DigestUpdate(this->ctx, reinterpret_cast<unsigned char *>(stream.data()), stream.size());
 }
 
@@ -0,0 +1,81 @@
+#include "input_proof_cache.h"
+
+namespace spark {
+
+InputProofCache::InputProofCache(const Params* params)
+    : params(params)
+{}
+
+InputProofCache::Key InputProofCache::key(const uint64_t cover_set_id, const GroupElement& T) {
+    std::vector<unsigned char> tag(GroupElement::serialize_size);
+    T.serialize(tag.data());
+    return Key(cover_set_id, tag);
+}
+
+void InputProofCache::add(const InputProof& input_proof) {
+    Key input_key = key(input_proof.cover_set_id, input_proof.T);
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->proofs[input_key] = input_proof;
+}
+
+bool InputProofCache::find(const InputCoinData& input, const std::vector<unsigned char>& cover_set_representation, InputProof& input_proof) {
+    Key input_key = key(input.cover_set_id, input.T);
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto item = this->proofs.find(input_key);
+    if (item == this->proofs.end()) {
+        return false;
+    }
+    if (item->second.cover_set_representation != cover_set_representation) {
+        this->proofs.erase(item);
+        return false;
+    }
+
+    input_proof = item->second;
+    return true;
+}
+
+template <typename CoverSetDataType>
+InputProof InputProofCache::get_or_prove(const FullViewKey& full_view_key, const InputCoinData& input, const CoverSetDataType& cover_set_data) {
+    InputProof input_proof;
+    if (find(input, cover_set_data.cover_set_representation, input_proof) && input_proof.cover_set_size == cover_set_data.cover_set.size()) {
+        return input_proof;
+    }
+
+    input_proof = SpendTransaction::prove_input(this->params, full_view_key, input, cover_set_data);
+    add(input_proof);
+    return input_proof;
+}
+
+InputProof InputProofCache::get(const FullViewKey& full_view_key, const InputCoinData& input, const CoverSetData& cover_set_data) {
+    return get_or_prove(full_view_key, input, cover_set_data);
+}
+
+InputProof InputProofCache::get(const FullViewKey& full_view_key, const InputCoinData& input, const CompactCoverSetData& cover_set_data) {
+    return get_or_prove(full_view_key, input, cover_set_data);
+}
+
+void InputProofCache::invalidate(const uint64_t cover_set_id) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto begin = this->proofs.lower_bound(Key(cover_set_id, std::vector<unsigned char>()));
+    auto end = begin;
+    while (end != this->proofs.end() && end->first.first == cover_set_id) {
+        ++end;
+    }
+    this->proofs.erase(begin, end);
+}
+
+void InputProofCache::erase(const InputCoinData& input) {
+    Key input_key = key(input.cover_set_id, input.T);
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->proofs.erase(input_key);
+}
+
+std::size_t InputProofCache::size() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->proofs.size();
+}
+
+}
@@ -0,0 +1,47 @@
+#ifndef FIRO_SPARK_INPUT_PROOF_CACHE_H
+#define FIRO_SPARK_INPUT_PROOF_CACHE_H
+#include "spend_transaction.h"
+#include <map>
+#include <mutex>
+
+namespace spark {
+
+// Input proofs kept between spends, e.g. generated in the background for the coins a wallet is likely to spend next
+// A proof is only returned while its cover set has the representation it was proven against; stale proofs are dropped
+// The cache is safe to share between threads, and proofs are generated outside its lock
+class InputProofCache {
+public:
+    InputProofCache(const Params* params);
+
+    void add(const InputProof& input_proof);
+
+    // Look up a proof for the input against the given representation of its cover set
+    bool find(const InputCoinData& input, const std::vector<unsigned char>& cover_set_representation, InputProof& input_proof);
+
+    // The cached proof, or a new one that is kept for next time
+    InputProof get(const FullViewKey& full_view_key, const InputCoinData& input, const CoverSetData& cover_set_data);
+    InputProof get(const FullViewKey& full_view_key, const InputCoinData& input, const CompactCoverSetData& cover_set_data);
+
+    // Drop all proofs against a cover set, e.g. when it grows
+    void invalidate(const uint64_t cover_set_id);
+    // Drop the proof for an input, e.g. once it is spent
+    void erase(const InputCoinData& input);
+
+    std::size_t size() const;
+
+private:
+    typedef std::pair<uint64_t, std::vector<unsigned char>> Key; // cover set identifier and serialized tag
+
+    static Key key(const uint64_t cover_set_id, const GroupElement& T);
+
+    template <typename CoverSetDataType>
+    InputProof get_or_prove(const FullViewKey& full_view_key, const InputCoinData& input, const CoverSetDataType& cover_set_data);
+
+    const Params* params;
+    mutable std::mutex mutex;
+    std::map<Key, InputProof> proofs;
+};
+
+}
+
+#endif
@@ -9,12 +9,15 @@ KDF::KDF(const std::string label, std::size_t derived_key_size) {
 
 	// Write the protocol and mode information
 	std::vector<unsigned char> protocol(LABEL_PROTOCOL.begin(), LABEL_PROTOCOL.end());
+	SPARK_COUNT(HASH_BYTES, protocol.size());
 	EVP_DigestUpdate(this->ctx, protocol.data(), protocol.size());
+	SPARK_COUNT(HASH_BYTES, sizeof(HASH_MODE_KDF));
 	EVP_DigestUpdate(this->ctx, &HASH_MODE_KDF, sizeof(HASH_MODE_KDF));
 
 	// Include the label with size
 	include_size(label.size());
 	std::vector<unsigned char> label_bytes(label.begin(), label.end());
+	SPARK_COUNT(HASH_BYTES, label_bytes.size());
 	EVP_DigestUpdate(this->ctx, label_bytes.data(), label_bytes.size());
 
 	// Embed and set the derived key size
@@ -33,6 +36,7 @@ KDF::~KDF() {
 // Include serialized data in the KDF
 void KDF::include(CDataStream& data) {
 	include_size(data.size());
+	SPARK_COUNT(HASH_BYTES, data.size());
 	EVP_DigestUpdate(this->ctx, reinterpret_cast<unsigned char *>(data.data()), data.size());
 }
 
@@ -42,6 +46,7 @@ std::vector<unsigned char> KDF::finalize() {
 	result.resize(EVP_MD_size(EVP_sha512()));
 
 	unsigned int TEMP;
+	SPARK_COUNT(HASH_FINALIZATIONS, 1);
 	EVP_DigestFinal_ex(this->ctx, result.data(), &TEMP);
 	result.resize(this->derived_key_size);
 
@@ -52,6 +57,7 @@ std::vector<unsigned char> KDF::finalize() {
 void KDF::include_size(std::size_t size) {
 	CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
 	stream << (uint64_t)size;
+	SPARK_COUNT(HASH_BYTES, stream.size());
 	EVP_DigestUpdate(this->ctx, reinterpret_cast<unsigned char *>(stream.data()), stream.size());
 }
 
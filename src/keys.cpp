@@ -7,9 +7,10 @@ using namespace secp_primitives;
 
 SpendKey::SpendKey(const Params* params) {
 	this->params = params;
-	this->s1.randomize();
-	this->s2.randomize();
-	this->r.randomize();
+	// Long-term secrets come straight from the operating system rather than the per-thread generator
+	RandomGenerator::randomize_from_system(this->s1);
+	RandomGenerator::randomize_from_system(this->s2);
+	RandomGenerator::randomize_from_system(this->r);
 }
 
 SpendKey::SpendKey(const Params* params, const Scalar& r_) {
@@ -78,8 +79,8 @@ FullViewKey::FullViewKey(const SpendKey& spend_key) {
 	this->params = spend_key.get_params();
 	this->s1 = spend_key.get_s1();
 	this->s2 = spend_key.get_s2();
-	this->D = this->params->get_G()*spend_key.get_r();
-	this->P2 = this->params->get_F()*this->s2 + this->D;
+	this->D = this->params->get_G_table().multiply(spend_key.get_r());
+	this->P2 = this->params->get_F_table().multiply(this->s2) + this->D;
 }
 
 const Params* FullViewKey::get_params() const {
@@ -102,6 +103,7 @@ const GroupElement& FullViewKey::get_P2() const {
 	return this->P2;
 }
 
+// These keys have no s1 yet, so they have no diversifier key either; assign a derived key before using diversifiers
 IncomingViewKey::IncomingViewKey() {}
 
 IncomingViewKey::IncomingViewKey(const Params* params) {
@@ -112,6 +114,28 @@ IncomingViewKey::IncomingViewKey(const FullViewKey& full_view_key) {
 	this->params = full_view_key.get_params();
 	this->s1 = full_view_key.get_s1();
 	this->P2 = full_view_key.get_P2();
+	set_diversifier_key();
+}
+
+// Derive the diversifier key and expand its AES key schedules
+void IncomingViewKey::set_diversifier_key() {
+	std::vector<unsigned char> key = SparkUtils::kdf_diversifier(this->s1);
+	this->diversifier_encryptor = std::make_shared<const AES256Encrypt>(key.data());
+	this->diversifier_decryptor = std::make_shared<const AES256Decrypt>(key.data());
+}
+
+const AES256Encrypt& IncomingViewKey::get_diversifier_encryptor() const {
+	if (!this->diversifier_encryptor) {
+		throw std::runtime_error("Incoming view key has no diversifier key");
+	}
+	return *this->diversifier_encryptor;
+}
+
+const AES256Decrypt& IncomingViewKey::get_diversifier_decryptor() const {
+	if (!this->diversifier_decryptor) {
+		throw std::runtime_error("Incoming view key has no diversifier key");
+	}
+	return *this->diversifier_decryptor;
 }
 
 const Params* IncomingViewKey::get_params() const {
@@ -133,12 +157,23 @@ uint64_t IncomingViewKey::get_diversifier(const std::vector<unsigned char>& d) c
 	}
 
 	// Decrypt the diversifier; this is NOT AUTHENTICATED and MUST be externally checked for validity against a claimed address
-	std::vector<unsigned char> key = SparkUtils::kdf_diversifier(this->s1);
-	uint64_t i = SparkUtils::diversifier_decrypt(key, d);
+	uint64_t i = SparkUtils::diversifier_decrypt(get_diversifier_decryptor(), d);
 
 	return i;
 }
 
+std::vector<uint64_t> IncomingViewKey::get_diversifiers(const std::vector<std::vector<unsigned char>>& d) const {
+	return SparkUtils::diversifier_decrypt(get_diversifier_decryptor(), d);
+}
+
+std::vector<unsigned char> IncomingViewKey::encrypt_diversifier(const uint64_t i) const {
+	return SparkUtils::diversifier_encrypt(get_diversifier_encryptor(), i);
+}
+
+std::vector<std::vector<unsigned char>> IncomingViewKey::encrypt_diversifiers(const uint64_t i, const std::size_t count) const {
+	return SparkUtils::diversifier_encrypt(get_diversifier_encryptor(), i, count);
+}
+
 Address::Address() {}
 
 Address::Address(const Params* params) {
@@ -147,11 +182,31 @@ Address::Address(const Params* params) {
 
 Address::Address(const IncomingViewKey& incoming_view_key, const uint64_t i) {
 	// Encrypt the diversifier
-	std::vector<unsigned char> key = SparkUtils::kdf_diversifier(incoming_view_key.get_s1());
 	this->params = incoming_view_key.get_params();
-	this->d = SparkUtils::diversifier_encrypt(key, i);
+	this->d = incoming_view_key.encrypt_diversifier(i);
+	set_public_keys(incoming_view_key, i);
+}
+
+// Derive the public keys for the encrypted diversifier `d` of index `i`
+void Address::set_public_keys(const IncomingViewKey& incoming_view_key, const uint64_t i) {
 	this->Q1 = SparkUtils::hash_div(this->d)*incoming_view_key.get_s1();
-	this->Q2 = this->params->get_F()*SparkUtils::hash_Q2(incoming_view_key.get_s1(), i) + incoming_view_key.get_P2();
+	this->Q2 = this->params->get_F_table().multiply(SparkUtils::hash_Q2(incoming_view_key.get_s1(), i)) + incoming_view_key.get_P2();
+}
+
+std::vector<Address> Address::derive_addresses(const IncomingViewKey& incoming_view_key, const uint64_t i, const std::size_t count) {
+	const Params* params = incoming_view_key.get_params();
+	std::vector<std::vector<unsigned char>> d = incoming_view_key.encrypt_diversifiers(i, count);
+
+	std::vector<Address> result;
+	result.reserve(count);
+	for (std::size_t j = 0; j < count; j++) {
+		Address address(params);
+		address.d = std::move(d[j]);
+		address.set_public_keys(incoming_view_key, i + j);
+		result.emplace_back(std::move(address));
+	}
+
+	return result;
 }
 
 const Params* Address::get_params() const {
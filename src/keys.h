@@ -62,11 +62,22 @@ public:
 	const Scalar& get_s1() const;
 	const GroupElement& get_P2() const;
 	uint64_t get_diversifier(const std::vector<unsigned char>& d) const;
+	std::vector<uint64_t> get_diversifiers(const std::vector<std::vector<unsigned char>>& d) const;
+	std::vector<unsigned char> encrypt_diversifier(const uint64_t i) const;
+	std::vector<std::vector<unsigned char>> encrypt_diversifiers(const uint64_t i, const std::size_t count) const;
 
 private:
+	void set_diversifier_key();
+	const AES256Encrypt& get_diversifier_encryptor() const;
+	const AES256Decrypt& get_diversifier_decryptor() const;
+
 	const Params* params;
 	Scalar s1;
 	GroupElement P2;
+
+	// Diversifier key schedules, derived once from s1 and shared between copies
+	std::shared_ptr<const AES256Encrypt> diversifier_encryptor;
+	std::shared_ptr<const AES256Decrypt> diversifier_decryptor;
 };
 
 class Address {
@@ -74,6 +85,10 @@ public:
     Address();
 	Address(const Params* params);
 	Address(const IncomingViewKey& incoming_view_key, const uint64_t i);
+
+	// Derive the addresses for diversifiers i, i + 1, ..., i + count - 1
+	static std::vector<Address> derive_addresses(const IncomingViewKey& incoming_view_key, const uint64_t i, const std::size_t count);
+
 	const Params* get_params() const;
 	const std::vector<unsigned char>& get_d() const;
 	const GroupElement& get_Q1() const;
@@ -87,6 +102,7 @@ private:
 	std::vector<unsigned char> d;
 	GroupElement Q1, Q2;
 
+	void set_public_keys(const IncomingViewKey& incoming_view_key, const uint64_t i);
 	static std::string get_checksum(const std::string data);
 };
 
@@ -0,0 +1,58 @@
+#include "mapped_file.h"
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace spark {
+
+MappedFile::MappedFile(const std::string& path) : data(nullptr), size(0) {
+#ifndef WIN32
+	mapping = nullptr;
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		throw std::runtime_error("Unable to open file");
+	}
+	struct stat info;
+	if (fstat(fd, &info) != 0) {
+		close(fd);
+		throw std::runtime_error("Unable to open file");
+	}
+	size = (std::size_t) info.st_size;
+	if (size > 0) {
+		void* mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+		if (mapped == MAP_FAILED) {
+			close(fd);
+			throw std::runtime_error("Unable to map file");
+		}
+		mapping = mapped;
+		data = static_cast<const unsigned char*>(mapped);
+	}
+	close(fd);
+#else
+	std::ifstream stream(path, std::ios::binary);
+	if (!stream) {
+		throw std::runtime_error("Unable to open file");
+	}
+	buffer.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	size = buffer.size();
+	data = reinterpret_cast<const unsigned char*>(buffer.data());
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifndef WIN32
+	if (mapping != nullptr) {
+		munmap(mapping, size);
+	}
+#endif
+}
+
+}
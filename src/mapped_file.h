@@ -0,0 +1,32 @@
+#ifndef FIRO_SPARK_MAPPED_FILE_H
+#define FIRO_SPARK_MAPPED_FILE_H
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace spark {
+
+// A read-only view of a whole file, mapped where the platform allows it and read into memory elsewhere.
+// Throws std::runtime_error if the file cannot be opened or mapped
+class MappedFile {
+public:
+	MappedFile(const std::string& path);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	const unsigned char* data;
+	std::size_t size;
+
+private:
+#ifndef WIN32
+	void* mapping;
+#else
+	std::vector<char> buffer;
+#endif
+};
+
+}
+
+#endif
@@ -90,16 +90,29 @@ void MintTransaction::setMintTransaction(std::vector<CDataStream>& serializedCoi
     bool first = true;
     coins.reserve(serializedCoins.size());
     size_t i = 0;
-    for (auto& stream : serializedCoins) {
-        Coin coin(params);
-        stream >> coin;
-        coins.push_back(coin);
-        i++;
-        if (first) {
-            stream >> value_proof;
-            first = false;
+    {
+        // Read every point first, then decompress them together
+        GroupElement::LazyDeserialization lazy;
+        for (auto& stream : serializedCoins) {
+            coins.emplace_back(params);
+            stream >> coins.back();
+            i++;
+            if (first) {
+                stream >> value_proof;
+                first = false;
+            }
         }
     }
+
+    std::vector<GroupElement*> points;
+    points.reserve(3 * coins.size() + 1);
+    for (Coin& coin : coins) {
+        points.emplace_back(&coin.S);
+        points.emplace_back(&coin.K);
+        points.emplace_back(&coin.C);
+    }
+    points.emplace_back(&value_proof.A);
+    GroupElement::decompress_all(points);
 }
 
 void MintTransaction::getCoins(std::vector<Coin>& coins_) {
@@ -1,64 +1,122 @@
 #include "params.h"
 //#include "chainparams.h"
 #include "util.h"
+#include "generator_tables.h"
+#include "params_cache.h"
 
 namespace spark {
 
-    CCriticalSection Params::cs_instance;
-    std::unique_ptr<Params> Params::instance;
+    CCriticalSection Params::cs_registry;
+    std::map<Params::Key, std::unique_ptr<Params::Entry>> Params::registry;
+    std::string Params::cache_directory;
+    unsigned int Params::cache_window_bits = FixedBaseTable::default_window_bits;
 
-// Protocol parameters for deployment
-Params const* Params::get_default() {
-    if (instance) {
-        return instance.get();
-    } else {
-        LOCK(cs_instance);
-        if (instance) {
-            return instance.get();
+const std::size_t Params::default_table_memory = 3*FixedBaseTable::memoryRequired(FixedBaseTable::default_window_bits);
+
+void Params::set_cache(const std::string& directory, const std::size_t table_memory) {
+    LOCK(cs_registry);
+    cache_directory = directory;
+    cache_window_bits = FixedBaseTable::window_bits_for(table_memory / 3);
+}
+
+Params const* Params::get_instance(
+    const std::size_t memo_bytes,
+    const std::size_t max_M_range,
+    const std::size_t n_grootle,
+    const std::size_t m_grootle
+) {
+    Entry* entry;
+    std::string directory;
+    unsigned int window_bits;
+    {
+        LOCK(cs_registry);
+        std::unique_ptr<Entry>& slot = registry[Key(memo_bytes, max_M_range, n_grootle, m_grootle)];
+        if (!slot) {
+            slot.reset(new Entry());
         }
+        entry = slot.get();
+        directory = cache_directory;
+        window_bits = cache_window_bits;
+    }
 
-        std::size_t memo_bytes = 32;
-        std::size_t max_M_range = 16;
-        std::size_t n_grootle = 8;
-        std::size_t m_grootle = 5;
+    const Params* params = entry->published.load(std::memory_order_acquire);
+    if (params) {
+        return params;
+    }
 
-        instance.reset(new Params(memo_bytes, max_M_range, n_grootle, m_grootle));
-        return instance.get();
+    // Build outside the registry lock, so that other parameter sets are not held up
+    LOCK(entry->cs_build);
+    if (!entry->params) {
+        if (directory.empty()) {
+            entry->params.reset(new Params(memo_bytes, max_M_range, n_grootle, m_grootle, window_bits));
+        } else {
+            std::string path = directory + "/spark_params_" + std::to_string(memo_bytes) + "_" + std::to_string(max_M_range)
+                + "_" + std::to_string(n_grootle) + "_" + std::to_string(m_grootle) + "_" + std::to_string(window_bits) + ".bin";
+            entry->params = ParamsCache::load_or_build(path, memo_bytes, max_M_range, n_grootle, m_grootle, window_bits);
+        }
+        entry->published.store(entry->params.get(), std::memory_order_release);
     }
+    return entry->params.get();
+}
+
+// Remembers the entry for one of the fixed parameter sets, so that later calls skip the registry
+Params const* Params::get_cached(
+    std::atomic<const Params*>& cached,
+    const std::size_t memo_bytes,
+    const std::size_t max_M_range,
+    const std::size_t n_grootle,
+    const std::size_t m_grootle
+) {
+    const Params* params = cached.load(std::memory_order_acquire);
+    if (!params) {
+        params = get_instance(memo_bytes, max_M_range, n_grootle, m_grootle);
+        cached.store(params, std::memory_order_release);
+    }
+    return params;
+}
+
+// Protocol parameters for deployment
+Params const* Params::get_default() {
+    static std::atomic<const Params*> cached(nullptr);
+
+    std::size_t memo_bytes = 32;
+    std::size_t max_M_range = 16;
+    std::size_t n_grootle = 8;
+    std::size_t m_grootle = 5;
+
+    return get_cached(cached, memo_bytes, max_M_range, n_grootle, m_grootle);
 }
 
 // Protocol parameters for testing
 Params const* Params::get_test() {
-    if (instance) {
-        return instance.get();
-    } else {
-        LOCK(cs_instance);
-        if (instance) {
-            return instance.get();
-        }
+    static std::atomic<const Params*> cached(nullptr);
 
-        std::size_t memo_bytes = 32;
-        std::size_t max_M_range = 16;
-        std::size_t n_grootle = 2;
-        std::size_t m_grootle = 4;
+    std::size_t memo_bytes = 32;
+    std::size_t max_M_range = 16;
+    std::size_t n_grootle = 2;
+    std::size_t m_grootle = 4;
 
-        instance.reset(new Params(memo_bytes, max_M_range, n_grootle, m_grootle));
-        return instance.get();
-    }
+    return get_cached(cached, memo_bytes, max_M_range, n_grootle, m_grootle);
 }
 
+Params::Params() {}
+
 Params::Params(
     const std::size_t memo_bytes,
     const std::size_t max_M_range,
     const std::size_t n_grootle,
-    const std::size_t m_grootle
+    const std::size_t m_grootle,
+    const unsigned int window_bits
 )
 {
-    // Global generators
-    this->F = SparkUtils::hash_generator(LABEL_GENERATOR_F);
+    // Global generators, read from the embedded tables rather than derived
+    this->F = GeneratorTables::get(LABEL_GENERATOR_F);
     this->G.set_base_g();
-    this->H = SparkUtils::hash_generator(LABEL_GENERATOR_H);
-    this->U = SparkUtils::hash_generator(LABEL_GENERATOR_U);
+    this->H = GeneratorTables::get(LABEL_GENERATOR_H);
+    this->U = GeneratorTables::get(LABEL_GENERATOR_U);
+    this->F_table.reset(new FixedBaseTable(this->F, window_bits));
+    this->G_table.reset(new FixedBaseTable(this->G, window_bits));
+    this->H_table.reset(new FixedBaseTable(this->H, window_bits));
 
     // Coin parameters
     this->memo_bytes = memo_bytes;
@@ -68,8 +126,8 @@ Params::Params(
     this->G_range.resize(64*max_M_range);
     this->H_range.resize(64*max_M_range);
     for (std::size_t i = 0; i < 64*max_M_range; i++) {
-        this->G_range[i] = SparkUtils::hash_generator(LABEL_GENERATOR_G_RANGE + " " + std::to_string(i));
-        this->H_range[i] = SparkUtils::hash_generator(LABEL_GENERATOR_H_RANGE + " " + std::to_string(i));
+        this->G_range[i] = GeneratorTables::get(LABEL_GENERATOR_G_RANGE, i);
+        this->H_range[i] = GeneratorTables::get(LABEL_GENERATOR_H_RANGE, i);
     }
 
     // One-of-many parameters
@@ -81,8 +139,8 @@ Params::Params(
     this->G_grootle.resize(n_grootle * m_grootle);
     this->H_grootle.resize(n_grootle * m_grootle);
     for (std::size_t i = 0; i < n_grootle * m_grootle; i++) {
-        this->G_grootle[i] = SparkUtils::hash_generator(LABEL_GENERATOR_G_GROOTLE + " " + std::to_string(i));
-        this->H_grootle[i] = SparkUtils::hash_generator(LABEL_GENERATOR_H_GROOTLE + " " + std::to_string(i));
+        this->G_grootle[i] = GeneratorTables::get(LABEL_GENERATOR_G_GROOTLE, i);
+        this->H_grootle[i] = GeneratorTables::get(LABEL_GENERATOR_H_GROOTLE, i);
     }
 }
 
@@ -102,6 +160,18 @@ const GroupElement& Params::get_U() const {
     return this->U;
 }
 
+const FixedBaseTable& Params::get_F_table() const {
+    return *this->F_table;
+}
+
+const FixedBaseTable& Params::get_G_table() const {
+    return *this->G_table;
+}
+
+const FixedBaseTable& Params::get_H_table() const {
+    return *this->H_table;
+}
+
 const std::size_t Params::get_memo_bytes() const {
     return this->memo_bytes;
 }
@@ -3,8 +3,12 @@
 
 #include "../secp256k1/include/Scalar.h"
 #include "../secp256k1/include/GroupElement.h"
+#include "../secp256k1/include/FixedBaseTable.h"
 #include "../bitcoin/serialize.h"
 #include "../bitcoin/sync.h"
+#include <atomic>
+#include <map>
+#include <tuple>
 
 using namespace secp_primitives;
 
@@ -20,6 +24,11 @@ public:
     const GroupElement& get_H() const;
     const GroupElement& get_U() const;
 
+    // Precomputed multiples of F, G and H, for repeated multiplication by the same generator
+    const FixedBaseTable& get_F_table() const;
+    const FixedBaseTable& get_G_table() const;
+    const FixedBaseTable& get_H_table() const;
+
     const std::size_t get_memo_bytes() const;
 
     std::size_t get_max_M_range() const;
@@ -31,23 +40,66 @@ public:
     const std::vector<GroupElement>& get_G_grootle() const;
     const std::vector<GroupElement>& get_H_grootle() const;
 
+    // Parameters for any (memo_bytes, max_M_range, n_grootle, m_grootle), built on first use and kept for the life of
+    // the process, so that several parameter sets can be used side by side. Safe to call from any thread
+    static Params const* get_instance(
+        const std::size_t memo_bytes,
+        const std::size_t max_M_range,
+        const std::size_t n_grootle,
+        const std::size_t m_grootle
+    );
+
+    // Parameters not yet constructed are loaded from precomputation files in `directory`, one per parameter set,
+    // which are built and saved if they are missing or stale; see ParamsCache. `table_memory` bounds the total size
+    // of the fixed-base tables, trading memory for faster multiplication by F, G and H
+    static void set_cache(const std::string& directory, const std::size_t table_memory = default_table_memory);
+
+    static const std::size_t default_table_memory;
+
 private:
+    friend class ParamsCache;
+
+    Params();
     Params(
         const std::size_t memo_bytes,
         const std::size_t max_M_range,
         const std::size_t n_grootle,
-        const std::size_t m_grootle
+        const std::size_t m_grootle,
+        const unsigned int window_bits = FixedBaseTable::default_window_bits
     );
 
 private:
-    static CCriticalSection cs_instance;
-    static std::unique_ptr<Params> instance;
+    // One registry entry per parameter set, built by the first caller while later ones for the same set wait.
+    // Entries are never removed, and a built one is published through an atomic pointer so that lookups after the
+    // first only take the registry lock
+    struct Entry {
+        CCriticalSection cs_build;
+        std::unique_ptr<Params> params;
+        std::atomic<const Params*> published{nullptr};
+    };
+    typedef std::tuple<std::size_t, std::size_t, std::size_t, std::size_t> Key;
+
+    static Params const* get_cached(
+        std::atomic<const Params*>& cached,
+        const std::size_t memo_bytes,
+        const std::size_t max_M_range,
+        const std::size_t n_grootle,
+        const std::size_t m_grootle
+    );
+
+    static CCriticalSection cs_registry;
+    static std::map<Key, std::unique_ptr<Entry>> registry;
+    static std::string cache_directory;
+    static unsigned int cache_window_bits;
 
     // Global generators
     GroupElement F;
     GroupElement G;
     GroupElement H;
     GroupElement U;
+    // Holds the mapped precomputation file the tables were loaded from, if any
+    std::shared_ptr<const void> storage;
+    std::unique_ptr<FixedBaseTable> F_table, G_table, H_table;
 
     // Coin parameters
     std::size_t memo_bytes;
@@ -0,0 +1,227 @@
+#include "params_cache.h"
+#include "generator_tables.h"
+#include "mapped_file.h"
+#include "../bitcoin/crypto/common.h"
+#include "../bitcoin/crypto/sha256.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace spark {
+
+namespace {
+
+const char MAGIC[8] = { 'S', 'P', 'A', 'R', 'K', 'P', 'R', 'M' };
+
+// Header layout, little-endian: magic, version, window bits, the four parameters, generator count, table size,
+// fingerprint and checksum
+const std::size_t OFFSET_VERSION = 8;
+const std::size_t OFFSET_WINDOW_BITS = 12;
+const std::size_t OFFSET_PARAMETERS = 16;
+const std::size_t OFFSET_GENERATORS = 48;
+const std::size_t OFFSET_TABLE_SIZE = 56;
+const std::size_t OFFSET_FINGERPRINT = 64;
+const std::size_t OFFSET_CHECKSUM = 96;
+const std::size_t HEADER_SIZE = 128;
+
+std::size_t generator_count(const std::size_t max_M_range, const std::size_t n_grootle, const std::size_t m_grootle) {
+    return 3 + 2*64*max_M_range + 2*n_grootle*m_grootle;
+}
+
+std::vector<unsigned char> checksum(const unsigned char* data, const std::size_t size) {
+    std::vector<unsigned char> result(CSHA256::OUTPUT_SIZE);
+    CSHA256().Write(data, size).Finalize(result.data());
+    return result;
+}
+
+// Reads `count` generators, returning the position after them
+const unsigned char* read_generators(const unsigned char* data, const std::size_t count, std::vector<GroupElement>& generators) {
+    generators.resize(count);
+    for (std::size_t i = 0; i < count; i++) {
+        data = generators[i].deserialize_affine(data);
+    }
+    return data;
+}
+
+}
+
+std::vector<unsigned char> ParamsCache::fingerprint(
+    const std::size_t memo_bytes,
+    const std::size_t max_M_range,
+    const std::size_t n_grootle,
+    const std::size_t m_grootle,
+    const unsigned int window_bits
+) {
+    // Covers the request, the table layout of this platform and the generators the tables are built on
+    unsigned char fields[48];
+    WriteLE32(fields, VERSION);
+    WriteLE32(fields + 4, window_bits);
+    WriteLE64(fields + 8, memo_bytes);
+    WriteLE64(fields + 16, max_M_range);
+    WriteLE64(fields + 24, n_grootle);
+    WriteLE64(fields + 32, m_grootle);
+    WriteLE64(fields + 40, FixedBaseTable::memoryRequired(window_bits));
+
+    GroupElement G;
+    G.set_base_g();
+    std::vector<unsigned char> bases(3*GroupElement::affine_size);
+    GroupElement::serialize_affine({ GeneratorTables::get(LABEL_GENERATOR_F), G, GeneratorTables::get(LABEL_GENERATOR_H) }, bases.data());
+
+    // Tables are stored in their native layout, so a file from another platform or field representation is stale
+    std::vector<unsigned char> layout = FixedBaseTable::layout_tag();
+
+    std::vector<unsigned char> result(CSHA256::OUTPUT_SIZE);
+    CSHA256().Write(fields, sizeof(fields)).Write(bases.data(), bases.size()).Write(layout.data(), layout.size()).Finalize(result.data());
+    return result;
+}
+
+std::unique_ptr<Params> ParamsCache::load_or_build(
+    const std::string& path,
+    const std::size_t memo_bytes,
+    const std::size_t max_M_range,
+    const std::size_t n_grootle,
+    const std::size_t m_grootle,
+    const unsigned int window_bits
+) {
+    std::unique_ptr<Params> params = load(path, memo_bytes, max_M_range, n_grootle, m_grootle, window_bits);
+    if (!params) {
+        params.reset(new Params(memo_bytes, max_M_range, n_grootle, m_grootle, window_bits));
+        save(*params, path);
+    }
+    return params;
+}
+
+std::unique_ptr<Params> ParamsCache::load(
+    const std::string& path,
+    const std::size_t memo_bytes,
+    const std::size_t max_M_range,
+    const std::size_t n_grootle,
+    const std::size_t m_grootle,
+    const unsigned int window_bits
+) {
+    if (n_grootle < 2 || m_grootle < 3) {
+        throw std::invalid_argument("Bad Grootle parameteres");
+    }
+
+    std::shared_ptr<MappedFile> file;
+    try {
+        file = std::make_shared<MappedFile>(path);
+    } catch (const std::runtime_error&) {
+        return nullptr;
+    }
+    if (file->size < HEADER_SIZE) {
+        return nullptr;
+    }
+    const unsigned char* header = file->data;
+
+    // Check the header against the request before reading anything else
+    const std::size_t generators = generator_count(max_M_range, n_grootle, m_grootle);
+    const std::size_t table_size = FixedBaseTable::memoryRequired(window_bits);
+    if (memcmp(header, MAGIC, sizeof(MAGIC)) != 0
+            || ReadLE32(header + OFFSET_VERSION) != VERSION
+            || ReadLE32(header + OFFSET_WINDOW_BITS) != window_bits
+            || ReadLE64(header + OFFSET_PARAMETERS) != memo_bytes
+            || ReadLE64(header + OFFSET_PARAMETERS + 8) != max_M_range
+            || ReadLE64(header + OFFSET_PARAMETERS + 16) != n_grootle
+            || ReadLE64(header + OFFSET_PARAMETERS + 24) != m_grootle
+            || ReadLE64(header + OFFSET_GENERATORS) != generators
+            || ReadLE64(header + OFFSET_TABLE_SIZE) != table_size
+            || file->size != HEADER_SIZE + generators*GroupElement::affine_size + 3*table_size) {
+        return nullptr;
+    }
+    if (memcmp(header + OFFSET_FINGERPRINT, fingerprint(memo_bytes, max_M_range, n_grootle, m_grootle, window_bits).data(), CSHA256::OUTPUT_SIZE) != 0
+            || memcmp(header + OFFSET_CHECKSUM, checksum(header + HEADER_SIZE, file->size - HEADER_SIZE).data(), CSHA256::OUTPUT_SIZE) != 0) {
+        return nullptr;
+    }
+
+    std::unique_ptr<Params> params(new Params());
+    try {
+        const unsigned char* data = header + HEADER_SIZE;
+        data = params->F.deserialize_affine(data);
+        params->G.set_base_g();
+        data = params->H.deserialize_affine(data);
+        data = params->U.deserialize_affine(data);
+
+        params->memo_bytes = memo_bytes;
+        params->max_M_range = max_M_range;
+        data = read_generators(data, 64*max_M_range, params->G_range);
+        data = read_generators(data, 64*max_M_range, params->H_range);
+        params->n_grootle = n_grootle;
+        params->m_grootle = m_grootle;
+        data = read_generators(data, n_grootle*m_grootle, params->G_grootle);
+        data = read_generators(data, n_grootle*m_grootle, params->H_grootle);
+
+        // The tables are used in place, so the mapping lives as long as the parameters
+        params->storage = file;
+        params->F_table.reset(new FixedBaseTable(params->F, window_bits, data));
+        params->G_table.reset(new FixedBaseTable(params->G, window_bits, data + table_size));
+        params->H_table.reset(new FixedBaseTable(params->H, window_bits, data + 2*table_size));
+    } catch (const std::invalid_argument&) {
+        return nullptr;
+    }
+
+    return params;
+}
+
+bool ParamsCache::save(const Params& params, const std::string& path) {
+    const std::size_t max_M_range = params.get_max_M_range();
+    const std::size_t n_grootle = params.get_n_grootle();
+    const std::size_t m_grootle = params.get_m_grootle();
+    const unsigned int window_bits = params.get_F_table().get_window_bits();
+    const std::size_t generators = generator_count(max_M_range, n_grootle, m_grootle);
+    const std::size_t table_size = FixedBaseTable::memoryRequired(window_bits);
+
+    std::vector<unsigned char> file(HEADER_SIZE + generators*GroupElement::affine_size + 3*table_size);
+    unsigned char* header = file.data();
+    memcpy(header, MAGIC, sizeof(MAGIC));
+    WriteLE32(header + OFFSET_VERSION, VERSION);
+    WriteLE32(header + OFFSET_WINDOW_BITS, window_bits);
+    WriteLE64(header + OFFSET_PARAMETERS, params.get_memo_bytes());
+    WriteLE64(header + OFFSET_PARAMETERS + 8, max_M_range);
+    WriteLE64(header + OFFSET_PARAMETERS + 16, n_grootle);
+    WriteLE64(header + OFFSET_PARAMETERS + 24, m_grootle);
+    WriteLE64(header + OFFSET_GENERATORS, generators);
+    WriteLE64(header + OFFSET_TABLE_SIZE, table_size);
+
+    std::vector<GroupElement> points = { params.get_F(), params.get_H(), params.get_U() };
+    for (const std::vector<GroupElement>* vector : { &params.get_G_range(), &params.get_H_range(), &params.get_G_grootle(), &params.get_H_grootle() }) {
+        points.insert(points.end(), vector->begin(), vector->end());
+    }
+    unsigned char* data = header + HEADER_SIZE;
+    GroupElement::serialize_affine(points, data);
+    data += generators*GroupElement::affine_size;
+    for (const FixedBaseTable* table : { &params.get_F_table(), &params.get_G_table(), &params.get_H_table() }) {
+        memcpy(data, table->data(), table_size);
+        data += table_size;
+    }
+
+    std::vector<unsigned char> hash = fingerprint(params.get_memo_bytes(), max_M_range, n_grootle, m_grootle, window_bits);
+    memcpy(header + OFFSET_FINGERPRINT, hash.data(), hash.size());
+    hash = checksum(header + HEADER_SIZE, file.size() - HEADER_SIZE);
+    memcpy(header + OFFSET_CHECKSUM, hash.data(), hash.size());
+
+    // Write a temporary file and rename it, so that readers never see a partial file
+#ifndef WIN32
+    const std::string temporary = path + ".tmp" + std::to_string(getpid());
+#else
+    const std::string temporary = path + ".tmp";
+#endif
+    {
+        std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+        stream.write(reinterpret_cast<const char*>(file.data()), file.size());
+        if (!stream.flush()) {
+            stream.close();
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,52 @@
+#ifndef FIRO_SPARK_PARAMS_CACHE_H
+#define FIRO_SPARK_PARAMS_CACHE_H
+#include "params.h"
+
+namespace spark {
+
+// Precomputed parameters saved to a file, so that later processes map it instead of building them again.
+// The file holds a header, every generator in affine form and the fixed-base tables of F, G and H in their native
+// layout, which are used straight from the mapping.
+// The header records a format version, a fingerprint of the parameters, table size and table layout the file was
+// built for, and a checksum of everything after it; a file that does not match the request is stale and gets rebuilt.
+class ParamsCache {
+public:
+    static const uint32_t VERSION = 1;
+
+    // Parameters from the file at `path`, or built and saved there if it is missing, stale or damaged.
+    // Failing to save is not an error, since the parameters are still usable
+    static std::unique_ptr<Params> load_or_build(
+        const std::string& path,
+        const std::size_t memo_bytes,
+        const std::size_t max_M_range,
+        const std::size_t n_grootle,
+        const std::size_t m_grootle,
+        const unsigned int window_bits
+    );
+
+    // Parameters from the file at `path`, or nullptr if it is missing, stale or damaged
+    static std::unique_ptr<Params> load(
+        const std::string& path,
+        const std::size_t memo_bytes,
+        const std::size_t max_M_range,
+        const std::size_t n_grootle,
+        const std::size_t m_grootle,
+        const unsigned int window_bits
+    );
+
+    // Replaces the file at `path` atomically; returns false if it could not be written
+    static bool save(const Params& params, const std::string& path);
+
+private:
+    static std::vector<unsigned char> fingerprint(
+        const std::size_t memo_bytes,
+        const std::size_t max_M_range,
+        const std::size_t n_grootle,
+        const std::size_t m_grootle,
+        const unsigned int window_bits
+    );
+};
+
+}
+
+#endif
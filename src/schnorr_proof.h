@@ -11,6 +11,10 @@ public:
         return Scalar::memoryRequired() + GroupElement::memoryRequired();
     }
 
+    static inline std::size_t serializedSize() {
+        return Scalar::memoryRequired() + GroupElement::memoryRequired();
+    }
+
     ADD_SERIALIZE_METHODS;
     template <typename Stream, typename Operation>
     inline void SerializationOp(Stream& s, Operation ser_action) {
@@ -4,6 +4,8 @@
 //#include <iostream>
 
 #define SPARK_VALUE_SPEND_LIMIT_PER_TRANSACTION     (10000 * COIN)
+// Mint scripts shorter than this cannot hold a coin
+#define SPARK_MINT_SCRIPT_MIN_SIZE                  213
 
 
 spark::SpendKey createSpendKey(const SpendKeyData& data) {
@@ -30,16 +32,6 @@ spark::IncomingViewKey createIncomingViewKey(const spark::FullViewKey& fullViewK
     return spark::IncomingViewKey(fullViewKey);
 }
 
-template <typename Iterator>
-static uint64_t CalculateSparkCoinsBalance(Iterator begin, Iterator end)
-{
-    uint64_t balance = 0;
-    for (auto start = begin; start != end; ++start) {
-        balance += start->v;
-    }
-    return balance;
-}
-
 std::vector<CRecipient> createSparkMintRecipients(
                         const std::vector<spark::MintedCoinData>& outputs,
                         const std::vector<unsigned char>& serial_context,
@@ -74,106 +66,26 @@ std::vector<CRecipient> createSparkMintRecipients(
 bool GetCoinsToSpend(
         CAmount required,
         std::vector<CSparkMintMeta>& coinsToSpend_out,
-        std::list<CSparkMintMeta> coins,
+        const std::list<CSparkMintMeta>& coins,
         int64_t& changeToMint)
 {
-    CAmount availableBalance = CalculateSparkCoinsBalance(coins.begin(), coins.end());
-
-    if (required > availableBalance) {
-        throw std::runtime_error("Insufficient funds !");
-    }
-
-    // sort by biggest amount. if it is same amount we will prefer the older block
-    auto comparer = [](const CSparkMintMeta& a, const CSparkMintMeta& b) -> bool {
-        return a.v != b.v ? a.v > b.v : a.nHeight < b.nHeight;
-    };
-    coins.sort(comparer);
-
-    CAmount spend_val(0);
-
-    std::list<CSparkMintMeta> coinsToSpend;
-    while (spend_val < required) {
-        if (coins.empty())
-            break;
-
-        CSparkMintMeta choosen;
-        CAmount need = required - spend_val;
-
-        auto itr = coins.begin();
-        if (need >= itr->v) {
-            choosen = *itr;
-            coins.erase(itr);
-        } else {
-            for (auto coinIt = coins.rbegin(); coinIt != coins.rend(); coinIt++) {
-                auto nextItr = coinIt;
-                nextItr++;
-
-                if (coinIt->v >= need && (nextItr == coins.rend() || nextItr->v != coinIt->v)) {
-                    choosen = *coinIt;
-                    coins.erase(std::next(coinIt).base());
-                    break;
-                }
-            }
-        }
-
-        spend_val += choosen.v;
-        coinsToSpend.push_back(choosen);
-    }
-
-    // sort by group id ay ascending order. it is mandatory for creting proper joinsplit
-    auto idComparer = [](const CSparkMintMeta& a, const CSparkMintMeta& b) -> bool {
-        return a.nId < b.nId;
-    };
-    coinsToSpend.sort(idComparer);
-
-    changeToMint = spend_val - required;
-    coinsToSpend_out.insert(coinsToSpend_out.begin(), coinsToSpend.begin(), coinsToSpend.end());
-
-    return true;
+    return SparkCoinSelector(coins).get_coins_to_spend(required, coinsToSpend_out, changeToMint);
 }
 
 std::pair<CAmount, std::vector<CSparkMintMeta>> SelectSparkCoins(
         CAmount required,
         bool subtractFeeFromAmount,
-        std::list<CSparkMintMeta> coins,
+        const std::list<CSparkMintMeta>& coins,
         std::size_t mintNum) {
-    CFeeRate fRate;
-
-    CAmount fee;
-    unsigned size;
-    int64_t changeToMint = 0; // this value can be negative, that means we need to spend remaining part of required value with another transaction (nMaxInputPerTransaction exceeded)
-
-    std::vector<CSparkMintMeta> spendCoins;
-    for (fee = fRate.GetFeePerK();;) {
-        CAmount currentRequired = required;
-
-        if (!subtractFeeFromAmount)
-            currentRequired += fee;
-        spendCoins.clear();
-        if (!GetCoinsToSpend(currentRequired, spendCoins, coins, changeToMint)) {
-            throw std::invalid_argument("Unable to select cons for spend");
-        }
-
-        // 924 is constant part, mainly Schnorr and Range proofs, 2535 is for each grootle proof/aux data
-        // 213 for each private output, 144 other parts of tx,
-        size = 924 + 2535 * (spendCoins.size()) + 213 * mintNum + 144; //TODO (levon) take in account also utxoNum
-        CAmount feeNeeded = size;
-
-        if (fee >= feeNeeded) {
-            break;
-        }
-
-        fee = feeNeeded;
-
-        if (subtractFeeFromAmount)
-            break;
-    }
-
-    if (changeToMint < 0)
-        throw std::invalid_argument("Unable to select cons for spend");
-
-    return std::make_pair(fee, spendCoins);
+    return SparkCoinSelector(coins).select(required, subtractFeeFromAmount, mintNum);
+}
 
+std::pair<CAmount, std::vector<CSparkMintMeta>> SelectSparkCoins(
+        CAmount required,
+        bool subtractFeeFromAmount,
+        const SparkCoinSelector& coins,
+        std::size_t mintNum) {
+    return coins.select(required, subtractFeeFromAmount, mintNum);
 }
 
 
@@ -187,19 +99,65 @@ bool getIndex(const spark::Coin& coin, const std::vector<spark::Coin>& anonymity
     return false;
 }
 
+// Look the coin up by serial commitment, and confirm the match against the set itself
+bool getIndex(const spark::Coin& coin, const std::vector<spark::Coin>& anonymity_set, const spark::CoverSetIndex& cover_set_index, size_t& index) {
+    std::size_t position;
+    if (cover_set_index.size() == anonymity_set.size() && cover_set_index.find(coin.S, position) && anonymity_set[position] == coin) {
+        index = position;
+        return true;
+    }
+    return getIndex(coin, anonymity_set, index);
+}
+
+void createSparkSpendTransaction(
+        const spark::SpendKey& spendKey,
+        const spark::FullViewKey& fullViewKey,
+        const spark::IncomingViewKey& incomingViewKey,
+        const std::vector<std::pair<CAmount, bool>>& recipients,
+        const std::vector<std::pair<spark::OutputCoinData, bool>>& privateRecipients,
+        const std::list<CSparkMintMeta>& coins,
+        const std::unordered_map<uint64_t, spark::CoverSetData>& cover_set_data_all,
+        const std::map<uint64_t, uint256>& idAndBlockHashes_all,
+        const uint256& txHashSig,
+        CAmount &fee,
+        std::vector<uint8_t>& serializedSpend,
+        std::vector<std::vector<unsigned char>>& outputScripts,
+        secp_primitives::Executor& executor) {
+    // The sets only need to outlive this call, so the store refers to them without taking ownership
+    spark::CoverSetStore cover_sets;
+    for (const auto& set : cover_set_data_all)
+        cover_sets.add(set.first, std::shared_ptr<const spark::CoverSetData>(&set.second, [](const spark::CoverSetData*) {}));
+
+    createSparkSpendTransaction(
+            spendKey,
+            fullViewKey,
+            incomingViewKey,
+            recipients,
+            privateRecipients,
+            coins,
+            cover_sets,
+            idAndBlockHashes_all,
+            txHashSig,
+            fee,
+            serializedSpend,
+            outputScripts,
+            executor);
+}
+
 void createSparkSpendTransaction(
         const spark::SpendKey& spendKey,
         const spark::FullViewKey& fullViewKey,
         const spark::IncomingViewKey& incomingViewKey,
         const std::vector<std::pair<CAmount, bool>>& recipients,
         const std::vector<std::pair<spark::OutputCoinData, bool>>& privateRecipients,
-        std::list<CSparkMintMeta> coins,
-        const std::unordered_map<uint64_t, spark::CoverSetData> cover_set_data_all,
+        const std::list<CSparkMintMeta>& coins,
+        const spark::CoverSetStore& cover_sets,
         const std::map<uint64_t, uint256>& idAndBlockHashes_all,
         const uint256& txHashSig,
         CAmount &fee,
         std::vector<uint8_t>& serializedSpend,
-        std::vector<std::vector<unsigned char>>& outputScripts) {
+        std::vector<std::vector<unsigned char>>& outputScripts,
+        secp_primitives::Executor& executor) {
 
     if (recipients.empty() && privateRecipients.empty()) {
         throw std::runtime_error("Either recipients or newMints has to be nonempty.");
@@ -331,22 +289,29 @@ void createSparkSpendTransaction(
     // We will write this into cover set representation, with anonymity set hash
     uint256 sig = txHashSig;
 
-    std::vector<spark::InputCoinData> inputs;
+    // Select the sets the inputs need, sharing rather than copying them
+    std::set<uint64_t> groupIds;
     std::map<uint64_t, uint256> idAndBlockHashes;
-    std::unordered_map<uint64_t, spark::CoverSetData> cover_set_data;
     for (auto& coin : estimated.second) {
         uint64_t groupId = coin.nId;
-        if (cover_set_data.count(groupId) == 0) {
-            if (!(cover_set_data_all.count(groupId) > 0 && idAndBlockHashes.count(groupId) > 0 ))
-                throw std::runtime_error("No such coin in set in input data");
-            cover_set_data[groupId] = cover_set_data_all.at(groupId);
-            idAndBlockHashes[groupId] = idAndBlockHashes.at(groupId);
-        }
+        if (!(cover_sets.count(groupId) > 0 && idAndBlockHashes_all.count(groupId) > 0))
+            throw std::runtime_error("No such coin in set in input data");
+        groupIds.insert(groupId);
+        idAndBlockHashes[groupId] = idAndBlockHashes_all.at(groupId);
+    }
+    spark::CoverSetStore cover_set_data = cover_sets.select(groupIds);
+
+    std::vector<spark::InputCoinData> inputs;
+    for (auto& coin : estimated.second) {
+        uint64_t groupId = coin.nId;
 
         spark::InputCoinData inputCoinData;
         inputCoinData.cover_set_id = groupId;
+        const std::vector<spark::Coin>& cover_set = cover_set_data.at(groupId).cover_set;
+        const spark::CoverSetIndex& cover_set_index = cover_set_data.get_index(groupId);
+
         std::size_t index = 0;
-        if (!getIndex(coin.coin, cover_set_data[groupId].cover_set, index))
+        if (!getIndex(coin.coin, cover_set, cover_set_index, index))
             throw std::runtime_error("No such coin in set");
         inputCoinData.index = index;
         inputCoinData.v = coin.v;
@@ -365,7 +330,7 @@ void createSparkSpendTransaction(
         inputs.push_back(inputCoinData);
     }
 
-    spark::SpendTransaction spendTransaction(params, fullViewKey, spendKey, inputs, cover_set_data, fee, transparentOut, privOutputs);
+    spark::SpendTransaction spendTransaction(params, fullViewKey, spendKey, inputs, cover_set_data, fee, transparentOut, privOutputs, executor);
     spendTransaction.setBlockHashes(idAndBlockHashes);
     CDataStream serialized(SER_NETWORK, PROTOCOL_VERSION);
     serialized << spendTransaction;
@@ -405,17 +370,38 @@ spark::IdentifiedCoinData identifyCoin(spark::Coin coin, const spark::IncomingVi
 void getSparkSpendScripts(const spark::FullViewKey& fullViewKey,
                           const spark::SpendKey& spendKey,
                           const std::vector<spark::InputCoinData>& inputs,
-                          const std::unordered_map<uint64_t, spark::CoverSetData> cover_set_data,
+                          const std::unordered_map<uint64_t, spark::CoverSetData>& cover_set_data,
                           const std::map<uint64_t, uint256>& idAndBlockHashes,
                           CAmount fee,
                           uint64_t transparentOut,
                           const std::vector<spark::OutputCoinData>& privOutputs,
-                          std::vector<uint8_t>& inputScript, std::vector<std::vector<unsigned char>>& outputScripts)
+                          std::vector<uint8_t>& inputScript, std::vector<std::vector<unsigned char>>& outputScripts,
+                          secp_primitives::Executor& executor)
+{
+    // The sets only need to outlive this call, so the store refers to them without taking ownership
+    spark::CoverSetStore cover_sets;
+    for (const auto& set : cover_set_data)
+        cover_sets.add(set.first, std::shared_ptr<const spark::CoverSetData>(&set.second, [](const spark::CoverSetData*) {}));
+
+    getSparkSpendScripts(fullViewKey, spendKey, inputs, cover_sets, idAndBlockHashes, fee, transparentOut, privOutputs, inputScript, outputScripts, executor);
+}
+
+template <typename CoverSetDataType>
+static void makeSparkSpendScripts(const spark::FullViewKey& fullViewKey,
+                                  const spark::SpendKey& spendKey,
+                                  const std::vector<spark::InputCoinData>& inputs,
+                                  const CoverSetDataType& cover_set_data,
+                                  const std::map<uint64_t, uint256>& idAndBlockHashes,
+                                  CAmount fee,
+                                  uint64_t transparentOut,
+                                  const std::vector<spark::OutputCoinData>& privOutputs,
+                                  std::vector<uint8_t>& inputScript, std::vector<std::vector<unsigned char>>& outputScripts,
+                                  secp_primitives::Executor& executor)
 {
     inputScript.clear();
     outputScripts.clear();
     const auto* params = spark::Params::get_default();
-    spark::SpendTransaction spendTransaction(params, fullViewKey, spendKey, inputs, cover_set_data, fee, transparentOut, privOutputs);
+    spark::SpendTransaction spendTransaction(params, fullViewKey, spendKey, inputs, cover_set_data, fee, transparentOut, privOutputs, executor);
     spendTransaction.setBlockHashes(idAndBlockHashes);
     CDataStream serialized(SER_NETWORK, PROTOCOL_VERSION);
     serialized << spendTransaction;
@@ -433,6 +419,34 @@ void getSparkSpendScripts(const spark::FullViewKey& fullViewKey,
     }
 }
 
+void getSparkSpendScripts(const spark::FullViewKey& fullViewKey,
+                          const spark::SpendKey& spendKey,
+                          const std::vector<spark::InputCoinData>& inputs,
+                          const spark::CoverSetStore& cover_set_data,
+                          const std::map<uint64_t, uint256>& idAndBlockHashes,
+                          CAmount fee,
+                          uint64_t transparentOut,
+                          const std::vector<spark::OutputCoinData>& privOutputs,
+                          std::vector<uint8_t>& inputScript, std::vector<std::vector<unsigned char>>& outputScripts,
+                          secp_primitives::Executor& executor)
+{
+    makeSparkSpendScripts(fullViewKey, spendKey, inputs, cover_set_data, idAndBlockHashes, fee, transparentOut, privOutputs, inputScript, outputScripts, executor);
+}
+
+void getSparkSpendScripts(const spark::FullViewKey& fullViewKey,
+                          const spark::SpendKey& spendKey,
+                          const std::vector<spark::InputCoinData>& inputs,
+                          const std::unordered_map<uint64_t, spark::StreamingCoverSetData>& cover_set_data,
+                          const std::map<uint64_t, uint256>& idAndBlockHashes,
+                          CAmount fee,
+                          uint64_t transparentOut,
+                          const std::vector<spark::OutputCoinData>& privOutputs,
+                          std::vector<uint8_t>& inputScript, std::vector<std::vector<unsigned char>>& outputScripts,
+                          secp_primitives::Executor& executor)
+{
+    makeSparkSpendScripts(fullViewKey, spendKey, inputs, cover_set_data, idAndBlockHashes, fee, transparentOut, privOutputs, inputScript, outputScripts, executor);
+}
+
 void ParseSparkMintTransaction(const std::vector<CScript>& scripts, spark::MintTransaction& mintTransaction)
 {
     std::vector<CDataStream> serializedCoins;
@@ -440,19 +454,14 @@ void ParseSparkMintTransaction(const std::vector<CScript>& scripts, spark::MintT
         if (!script.IsSparkMint())
             throw std::invalid_argument("Script is not a Spark mint");
 
-        std::vector<unsigned char> serialized(script.begin() + 1, script.end());
         size_t size = spark::Coin::memoryRequired() + 8; // 8 is the size of uint64_t
-        if (serialized.size() < size) {
+        if (script.size() - 1 < size) {
             throw std::invalid_argument("Script is not a valid Spark mint");
         }
 
-        CDataStream stream(
-                std::vector<unsigned char>(serialized.begin(), serialized.end()),
-                SER_NETWORK,
-                PROTOCOL_VERSION
-        );
-
-        serializedCoins.push_back(stream);
+        // Copy the serialized coin straight out of the script
+        const char* serialized = reinterpret_cast<const char *>(&script[0]);
+        serializedCoins.emplace_back(serialized + 1, serialized + script.size(), SER_NETWORK, PROTOCOL_VERSION);
     }
     try {
         mintTransaction.setMintTransaction(serializedCoins);
@@ -466,16 +475,13 @@ void ParseSparkMintCoin(const CScript& script, spark::Coin& txCoin)
     if (!script.IsSparkMint() && !script.IsSparkSMint())
         throw std::invalid_argument("Script is not a Spark mint");
 
-    if (script.size() < 213) {
+    if (script.size() < SPARK_MINT_SCRIPT_MIN_SIZE) {
         throw std::invalid_argument("Script is not a valid Spark Mint");
     }
 
-    std::vector<unsigned char> serialized(script.begin() + 1, script.end());
-    CDataStream stream(
-            std::vector<unsigned char>(serialized.begin(), serialized.end()),
-            SER_NETWORK,
-            PROTOCOL_VERSION
-    );
+    // Copy the serialized coin straight out of the script
+    const char* serialized = reinterpret_cast<const char *>(&script[0]);
+    CDataStream stream(serialized + 1, serialized + script.size(), SER_NETWORK, PROTOCOL_VERSION);
 
     try {
         stream >> txCoin;
@@ -484,6 +490,22 @@ void ParseSparkMintCoin(const CScript& script, spark::Coin& txCoin)
     }
 }
 
+spark::CoinView ParseSparkMintCoinView(const CScript& script, const spark::Params* params)
+{
+    if (!script.IsSparkMint() && !script.IsSparkSMint())
+        throw std::invalid_argument("Script is not a Spark mint");
+
+    if (script.size() < SPARK_MINT_SCRIPT_MIN_SIZE) {
+        throw std::invalid_argument("Script is not a valid Spark Mint");
+    }
+
+    try {
+        return spark::CoinView(params, &script[1], script.size() - 1);
+    } catch (...) {
+        throw std::invalid_argument("Unable to deserialize Spark mint");
+    }
+}
+
 CSparkMintMeta getMetadata(const spark::Coin& coin, const spark::IncomingViewKey& incoming_view_key) {
     CSparkMintMeta meta;
     spark::IdentifiedCoinData identifiedCoinData;
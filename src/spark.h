@@ -6,29 +6,61 @@
 #include "../src/coin.h"
 #include "../src/mint_transaction.h"
 #include "../src/spend_transaction.h"
+#include "../src/coin_selector.h"
 #include <list>
 
-std::pair<CAmount, std::vector<CSparkMintMeta>> SelectSparkCoins(CAmount required, bool subtractFeeFromAmount, std::list<CSparkMintMeta> coins, std::size_t mintNum);
+std::pair<CAmount, std::vector<CSparkMintMeta>> SelectSparkCoins(CAmount required, bool subtractFeeFromAmount, const std::list<CSparkMintMeta>& coins, std::size_t mintNum);
+
+// Same, over a coin index the wallet keeps between selections
+std::pair<CAmount, std::vector<CSparkMintMeta>> SelectSparkCoins(CAmount required, bool subtractFeeFromAmount, const SparkCoinSelector& coins, std::size_t mintNum);
 
 bool GetCoinsToSpend(
         CAmount required,
         std::vector<CSparkMintMeta>& coinsToSpend_out,
-        std::list<CSparkMintMeta> coins,
+        const std::list<CSparkMintMeta>& coins,
         int64_t& changeToMint);
 
 
 void getSparkSpendScripts(const spark::FullViewKey& fullViewKey,
                           const spark::SpendKey& spendKey,
                           const std::vector<spark::InputCoinData>& inputs,
-                          const std::unordered_map<uint64_t, spark::CoverSetData> cover_set_data,
+                          const std::unordered_map<uint64_t, spark::CoverSetData>& cover_set_data,
+                          const std::map<uint64_t, uint256>& idAndBlockHashes,
+                          CAmount fee,
+                          uint64_t transparentOut,
+                          const std::vector<spark::OutputCoinData>& privOutputs,
+                          std::vector<uint8_t>& inputScript, std::vector<std::vector<unsigned char>>& outputScripts,
+                          secp_primitives::Executor& executor = secp_primitives::Executor::get_default());
+
+// Same, with cover sets shared through a store rather than copied
+void getSparkSpendScripts(const spark::FullViewKey& fullViewKey,
+                          const spark::SpendKey& spendKey,
+                          const std::vector<spark::InputCoinData>& inputs,
+                          const spark::CoverSetStore& cover_set_data,
+                          const std::map<uint64_t, uint256>& idAndBlockHashes,
+                          CAmount fee,
+                          uint64_t transparentOut,
+                          const std::vector<spark::OutputCoinData>& privOutputs,
+                          std::vector<uint8_t>& inputScript, std::vector<std::vector<unsigned char>>& outputScripts,
+                          secp_primitives::Executor& executor = secp_primitives::Executor::get_default());
+
+// Same, with each cover set read in chunks while proving rather than held in memory
+void getSparkSpendScripts(const spark::FullViewKey& fullViewKey,
+                          const spark::SpendKey& spendKey,
+                          const std::vector<spark::InputCoinData>& inputs,
+                          const std::unordered_map<uint64_t, spark::StreamingCoverSetData>& cover_set_data,
                           const std::map<uint64_t, uint256>& idAndBlockHashes,
                           CAmount fee,
                           uint64_t transparentOut,
                           const std::vector<spark::OutputCoinData>& privOutputs,
-                          std::vector<uint8_t>& inputScript, std::vector<std::vector<unsigned char>>& outputScripts);
+                          std::vector<uint8_t>& inputScript, std::vector<std::vector<unsigned char>>& outputScripts,
+                          secp_primitives::Executor& executor = secp_primitives::Executor::get_default());
 
 
 void ParseSparkMintTransaction(const std::vector<CScript>& scripts, spark::MintTransaction& mintTransaction);
 void ParseSparkMintCoin(const CScript& script, spark::Coin& txCoin);
 
+// Parse a mint script without copying it; the view borrows the script bytes, so the script must outlive it
+spark::CoinView ParseSparkMintCoinView(const CScript& script, const spark::Params* params = spark::Params::get_default());
+
 #endif //FIRO_LIBSPARK_SPARK_H
@@ -1,5 +1,8 @@
 #include "spend_transaction.h"
 
+#include <algorithm>
+#include <functional>
+
 namespace spark {
 
 // Generate a spend transaction that consumes existing coins and generates new ones
@@ -8,6 +11,131 @@ SpendTransaction::SpendTransaction(
     this->params = params;
 }
 
+// Prove membership in a cover set given as full coins
+static void prove_membership(
+	Grootle& grootle,
+	const std::size_t l,
+	const Scalar& s,
+	const std::vector<Coin>& cover_set,
+	const GroupElement& S1,
+	const Scalar& v,
+	const GroupElement& C1,
+	const std::vector<unsigned char>& root,
+	GrootleProof& proof
+) {
+	std::vector<GroupElement> S, C;
+	S.reserve(cover_set.size());
+	C.reserve(cover_set.size());
+	for (std::size_t i = 0; i < cover_set.size(); i++) {
+		S.emplace_back(cover_set[i].S);
+		C.emplace_back(cover_set[i].C);
+	}
+	grootle.prove(l, s, S, S1, v, C, C1, root, proof);
+}
+
+// Prove membership in a compact cover set
+static void prove_membership(
+	Grootle& grootle,
+	const std::size_t l,
+	const Scalar& s,
+	const CoverSet& cover_set,
+	const GroupElement& S1,
+	const Scalar& v,
+	const GroupElement& C1,
+	const std::vector<unsigned char>& root,
+	GrootleProof& proof
+) {
+	grootle.prove(l, s, cover_set, S1, v, C1, root, proof);
+}
+
+static std::size_t cover_set_size(const CoverSetData& cover_set_data) {
+	return cover_set_data.cover_set.size();
+}
+
+static std::size_t cover_set_size(const CompactCoverSetData& cover_set_data) {
+	return cover_set_data.cover_set.size();
+}
+
+static std::size_t cover_set_size(const StreamingCoverSetData& cover_set_data) {
+	return cover_set_data.reader->size();
+}
+
+static void prove_membership(
+	Grootle& grootle,
+	const std::size_t l,
+	const Scalar& s,
+	const CoverSetData& cover_set_data,
+	const GroupElement& S1,
+	const Scalar& v,
+	const GroupElement& C1,
+	const std::vector<unsigned char>& root,
+	GrootleProof& proof
+) {
+	prove_membership(grootle, l, s, cover_set_data.cover_set, S1, v, C1, root, proof);
+}
+
+static void prove_membership(
+	Grootle& grootle,
+	const std::size_t l,
+	const Scalar& s,
+	const CompactCoverSetData& cover_set_data,
+	const GroupElement& S1,
+	const Scalar& v,
+	const GroupElement& C1,
+	const std::vector<unsigned char>& root,
+	GrootleProof& proof
+) {
+	prove_membership(grootle, l, s, cover_set_data.cover_set, S1, v, C1, root, proof);
+}
+
+// Prove membership in a cover set read in chunks
+static void prove_membership(
+	Grootle& grootle,
+	const std::size_t l,
+	const Scalar& s,
+	const StreamingCoverSetData& cover_set_data,
+	const GroupElement& S1,
+	const Scalar& v,
+	const GroupElement& C1,
+	const std::vector<unsigned char>& root,
+	GrootleProof& proof
+) {
+	grootle.prove(l, s, *cover_set_data.reader, S1, v, C1, root, proof, cover_set_data.memory_limit);
+}
+
+// Verify a batch of membership proofs sharing a cover set given as full coins
+static bool verify_membership(
+	Grootle& grootle,
+	const std::vector<Coin>& cover_set,
+	const std::vector<GroupElement>& S1,
+	const std::vector<GroupElement>& V1,
+	const std::vector<std::vector<unsigned char>>& cover_set_representations,
+	const std::vector<std::size_t>& sizes,
+	const std::vector<GrootleProof>& proofs
+) {
+	std::vector<GroupElement> S, V;
+	S.reserve(cover_set.size());
+	V.reserve(cover_set.size());
+	for (std::size_t i = 0; i < cover_set.size(); i++) {
+		S.emplace_back(cover_set[i].S);
+		V.emplace_back(cover_set[i].C);
+	}
+	return grootle.verify(S, S1, V, V1, cover_set_representations, sizes, proofs);
+}
+
+// Verify a batch of membership proofs sharing a compact cover set
+static bool verify_membership(
+	Grootle& grootle,
+	const CoverSet& cover_set,
+	const std::vector<GroupElement>& S1,
+	const std::vector<GroupElement>& V1,
+	const std::vector<std::vector<unsigned char>>& cover_set_representations,
+	const std::vector<std::size_t>& sizes,
+	const std::vector<GrootleProof>& proofs
+) {
+	return grootle.verify(cover_set, S1, V1, cover_set_representations, sizes, proofs);
+}
+
 SpendTransaction::SpendTransaction(
 	const Params* params,
 	const FullViewKey& full_view_key,
@@ -16,97 +144,297 @@ SpendTransaction::SpendTransaction(
     const std::unordered_map<uint64_t, CoverSetData>& cover_set_data,
 	const uint64_t f,
     const uint64_t vout,
+	const std::vector<OutputCoinData>& outputs,
+	Executor& executor
+) {
+	this->params = params;
+	generate(full_view_key, spend_key, inputs, cover_set_data, f, vout, outputs, executor);
+}
+
+SpendTransaction::SpendTransaction(
+	const Params* params,
+	const FullViewKey& full_view_key,
+	const SpendKey& spend_key,
+	const std::vector<InputCoinData>& inputs,
+    const std::unordered_map<uint64_t, CompactCoverSetData>& cover_set_data,
+	const uint64_t f,
+    const uint64_t vout,
+	const std::vector<OutputCoinData>& outputs,
+	Executor& executor
+) {
+	this->params = params;
+	generate(full_view_key, spend_key, inputs, cover_set_data, f, vout, outputs, executor);
+}
+
+SpendTransaction::SpendTransaction(
+	const Params* params,
+	const FullViewKey& full_view_key,
+	const SpendKey& spend_key,
+	const std::vector<InputCoinData>& inputs,
+    const std::unordered_map<uint64_t, StreamingCoverSetData>& cover_set_data,
+	const uint64_t f,
+    const uint64_t vout,
+	const std::vector<OutputCoinData>& outputs,
+	Executor& executor
+) {
+	this->params = params;
+	generate(full_view_key, spend_key, inputs, cover_set_data, f, vout, outputs, executor);
+}
+
+SpendTransaction::SpendTransaction(
+	const Params* params,
+	const FullViewKey& full_view_key,
+	const SpendKey& spend_key,
+	const std::vector<InputCoinData>& inputs,
+    const CoverSetStore& cover_set_data,
+	const uint64_t f,
+    const uint64_t vout,
+	const std::vector<OutputCoinData>& outputs,
+	Executor& executor
+) {
+	this->params = params;
+	generate(full_view_key, spend_key, inputs, cover_set_data, f, vout, outputs, executor);
+}
+
+SpendTransaction::SpendTransaction(
+	const Params* params,
+	const FullViewKey& full_view_key,
+	const SpendKey& spend_key,
+	const std::vector<InputCoinData>& inputs,
+	const std::vector<InputProof>& input_proofs,
+	const uint64_t f,
+	const uint64_t vout,
 	const std::vector<OutputCoinData>& outputs
 ) {
 	this->params = params;
 
-	// Size parameters
-	const std::size_t w = inputs.size(); // number of consumed coins
-	const std::size_t t = outputs.size(); // number of generated coins
+	// Only the sets used by the inputs are bound, so the verifier must be given exactly these sets
+	for (const InputProof& input_proof : input_proofs) {
+		if (this->cover_set_sizes.count(input_proof.cover_set_id) > 0 && (
+				this->cover_set_sizes[input_proof.cover_set_id] != input_proof.cover_set_size ||
+				this->cover_set_representations[input_proof.cover_set_id] != input_proof.cover_set_representation)) {
+			throw std::invalid_argument("Input proofs use different versions of a cover set");
+		}
+		this->cover_set_sizes[input_proof.cover_set_id] = input_proof.cover_set_size;
+		this->cover_set_representations[input_proof.cover_set_id] = input_proof.cover_set_representation;
+	}
+
+	attach_inputs(inputs, input_proofs);
+	attach_outputs(full_view_key, inputs, f, vout, outputs);
+	bind(full_view_key, spend_key, inputs);
+}
+
+// Prove an input against a cover set given as full coins, compact commitments or a reader
+template <typename CoverSetDataType>
+static InputProof prove_input_with(
+	const Params* params,
+	const FullViewKey& full_view_key,
+	const InputCoinData& input,
+	const CoverSetDataType& cover_set_data,
+	Executor& executor
+) {
 	const std::size_t N = (std::size_t) std::pow(params->get_n_grootle(), params->get_m_grootle()); // size of cover sets
+	const std::size_t size = cover_set_size(cover_set_data);
+	if (size > N)
+		throw std::invalid_argument("Wrong set size");
 
-	// Prepare input-related vectors
-	this->cover_set_ids.reserve(w); // cover set data and metadata
-    this->setCoverSets(cover_set_data);
-	this->S1.reserve(w); // serial commitment offsets
-	this->C1.reserve(w); // value commitment offsets
-	this->grootle_proofs.reserve(w); // Grootle one-of-many proofs
-	this->T.reserve(w); // linking tags
+	InputProof result;
+	result.cover_set_id = input.cover_set_id;
+	result.cover_set_size = size;
+	result.cover_set_representation = cover_set_data.cover_set_representation;
 
-	this->f = f; // fee
-    this->vout = vout; // transparent output value
+	// Serial commitment offset
+	result.S1 = params->get_F_table().multiply(input.s)
+		+ params->get_H().inverse()*SparkUtils::hash_ser1(input.s, full_view_key.get_D())
+		+ full_view_key.get_D();
 
-	// Prepare Chaum vectors
-	std::vector<Scalar> chaum_x, chaum_y, chaum_z;
+	// Value commitment offset
+	result.C1 = params->get_G_table().multiply(Scalar(input.v))
+		+ params->get_H_table().multiply(SparkUtils::hash_val1(input.s, full_view_key.get_D()));
 
-	// Prepare output vector
-	this->out_coins.reserve(t); // coins
-	std::vector<Scalar> k; // nonces
+	// Tag
+	result.T = input.T;
 
-	// Prepare inputs
+	// Grootle proof
 	Grootle grootle(
-		this->params->get_H(),
-		this->params->get_G_grootle(),
-		this->params->get_H_grootle(),
-		this->params->get_n_grootle(),
-		this->params->get_m_grootle()
+		params->get_H(),
+		params->get_G_grootle(),
+		params->get_H_grootle(),
+		params->get_n_grootle(),
+		params->get_m_grootle(),
+		executor
 	);
-	for (std::size_t u = 0; u < w; u++) {
-		// Parse out cover set data for this spend
-        uint64_t set_id = inputs[u].cover_set_id;
-		this->cover_set_ids.emplace_back(set_id);
-        if (cover_set_data.count(set_id) == 0)
+	prove_membership(
+		grootle,
+		input.index,
+		SparkUtils::hash_ser1(input.s, full_view_key.get_D()),
+		cover_set_data,
+		result.S1,
+		SparkUtils::hash_val(input.k) - SparkUtils::hash_val1(input.s, full_view_key.get_D()),
+		result.C1,
+		result.cover_set_representation,
+		result.proof
+	);
+
+	return result;
+}
+
+InputProof SpendTransaction::prove_input(
+	const Params* params,
+	const FullViewKey& full_view_key,
+	const InputCoinData& input,
+	const CoverSetData& cover_set_data,
+	Executor& executor
+) {
+	return prove_input_with(params, full_view_key, input, cover_set_data, executor);
+}
+
+InputProof SpendTransaction::prove_input(
+	const Params* params,
+	const FullViewKey& full_view_key,
+	const InputCoinData& input,
+	const CompactCoverSetData& cover_set_data,
+	Executor& executor
+) {
+	return prove_input_with(params, full_view_key, input, cover_set_data, executor);
+}
+
+InputProof SpendTransaction::prove_input(
+	const Params* params,
+	const FullViewKey& full_view_key,
+	const InputCoinData& input,
+	const StreamingCoverSetData& cover_set_data,
+	Executor& executor
+) {
+	return prove_input_with(params, full_view_key, input, cover_set_data, executor);
+}
+
+// The input proofs and the output range proof are independent, so they are generated concurrently
+// The balance and Chaum proofs need all of them, and are generated after they join
+template <typename CoverSetDataMap>
+void SpendTransaction::generate(
+	const FullViewKey& full_view_key,
+	const SpendKey& spend_key,
+	const std::vector<InputCoinData>& inputs,
+	const CoverSetDataMap& cover_set_data,
+	const uint64_t f,
+	const uint64_t vout,
+	const std::vector<OutputCoinData>& outputs,
+	Executor& executor
+) {
+    this->setCoverSets(cover_set_data);
+	this->f = f; // fee
+    this->vout = vout; // transparent output value
+
+	for (const InputCoinData& input : inputs) {
+        if (cover_set_data.count(input.cover_set_id) == 0)
             throw std::invalid_argument("Required set is not passed");
+	}
 
-        const auto& cover_set = cover_set_data.at(set_id).cover_set;
-        std::size_t set_size = cover_set.size();
-        if (set_size > N)
-            throw std::invalid_argument("Wrong set size");
-
-        std::vector<GroupElement> S, C;
-		S.reserve(set_size);
-		C.reserve(set_size);
-		for (std::size_t i = 0; i < set_size; i++) {
-			S.emplace_back(cover_set[i].S);
-			C.emplace_back(cover_set[i].C);
-		}
+	// The range proof covers every output, so it is usually the longest task and goes first
+	std::vector<InputProof> input_proofs(inputs.size());
+	std::vector<Scalar> k; // nonces
+	std::vector<std::function<void()>> tasks;
+	tasks.emplace_back([this, &inputs, &outputs, &k]() {
+		generate_outputs(inputs, outputs, k);
+	});
+	for (std::size_t u = 0; u < inputs.size(); u++) {
+		tasks.emplace_back([this, &full_view_key, &inputs, &cover_set_data, &input_proofs, &executor, u]() {
+			input_proofs[u] = prove_input(this->params, full_view_key, inputs[u], cover_set_data.at(inputs[u].cover_set_id), executor);
+		});
+	}
+	executor.run(tasks);
 
-		// Serial commitment offset
-		this->S1.emplace_back(
-			this->params->get_F()*inputs[u].s
-			+ this->params->get_H().inverse()*SparkUtils::hash_ser1(inputs[u].s, full_view_key.get_D())
-			+ full_view_key.get_D()
-		);
+	attach_inputs(inputs, input_proofs);
+	prove_balance(full_view_key, inputs, k);
+	bind(full_view_key, spend_key, inputs);
+}
 
-		// Value commitment offset
-		this->C1.emplace_back(
-			this->params->get_G()*Scalar(inputs[u].v)
-			+ this->params->get_H()*SparkUtils::hash_val1(inputs[u].s, full_view_key.get_D())
-		);
+// Decompress the points deferred by `SerializationOp` in one batch
+void SpendTransaction::decompressPoints() {
+	std::vector<GroupElement*> points;
+	for (GroupElement& point : this->S1)
+		points.emplace_back(&point);
+	for (GroupElement& point : this->C1)
+		points.emplace_back(&point);
+	for (GroupElement& point : this->T)
+		points.emplace_back(&point);
+	for (GrootleProof& proof : this->grootle_proofs)
+		proof.getPoints(points);
+	points.emplace_back(&this->chaum_proof.A1);
+	for (GroupElement& point : this->chaum_proof.A2)
+		points.emplace_back(&point);
+	points.emplace_back(&this->balance_proof.A);
+	points.emplace_back(&this->range_proof.A);
+	points.emplace_back(&this->range_proof.A1);
+	points.emplace_back(&this->range_proof.B);
+	for (GroupElement& point : this->range_proof.L)
+		points.emplace_back(&point);
+	for (GroupElement& point : this->range_proof.R)
+		points.emplace_back(&point);
+	GroupElement::decompress_all(points);
+}
 
-		// Tags
-		this->T.emplace_back(inputs[u].T);
-
-		// Grootle proof
-		this->grootle_proofs.emplace_back();
-		std::size_t l = inputs[u].index;
-		grootle.prove(
-			l,
-			SparkUtils::hash_ser1(inputs[u].s, full_view_key.get_D()),
-			S,
-			this->S1.back(),
-			SparkUtils::hash_val(inputs[u].k) - SparkUtils::hash_val1(inputs[u].s, full_view_key.get_D()),
-			C,
-			this->C1.back(),
-			this->cover_set_representations[set_id],
-			this->grootle_proofs.back()
-		);
+// First stage: take the input proofs, which must match the inputs and the cover sets of this transaction
+void SpendTransaction::attach_inputs(
+	const std::vector<InputCoinData>& inputs,
+	const std::vector<InputProof>& input_proofs
+) {
+	const std::size_t w = inputs.size(); // number of consumed coins
+	if (input_proofs.size() != w)
+		throw std::invalid_argument("Bad number of input proofs");
 
-		// Chaum data
-		chaum_x.emplace_back(inputs[u].s);
-		chaum_y.emplace_back(spend_key.get_r());
-		chaum_z.emplace_back(SparkUtils::hash_ser1(inputs[u].s, full_view_key.get_D()).negate());
+	this->cover_set_ids.reserve(w); // cover set data and metadata
+	this->S1.reserve(w); // serial commitment offsets
+	this->C1.reserve(w); // value commitment offsets
+	this->grootle_proofs.reserve(w); // Grootle one-of-many proofs
+	this->T.reserve(w); // linking tags
+
+	for (std::size_t u = 0; u < w; u++) {
+		const InputProof& input_proof = input_proofs[u];
+		uint64_t set_id = inputs[u].cover_set_id;
+		if (input_proof.cover_set_id != set_id || input_proof.T != inputs[u].T)
+			throw std::invalid_argument("Input proof does not match input");
+		if (this->cover_set_sizes.count(set_id) == 0 ||
+				this->cover_set_sizes[set_id] != input_proof.cover_set_size ||
+				this->cover_set_representations[set_id] != input_proof.cover_set_representation)
+			throw std::invalid_argument("Input proof is for another version of the cover set");
+
+		this->cover_set_ids.emplace_back(set_id);
+		this->S1.emplace_back(input_proof.S1);
+		this->C1.emplace_back(input_proof.C1);
+		this->T.emplace_back(input_proof.T);
+		this->grootle_proofs.emplace_back(input_proof.proof);
 	}
+}
+
+// Second stage: generate the output coins, and the range and balance proofs
+void SpendTransaction::attach_outputs(
+	const FullViewKey& full_view_key,
+	const std::vector<InputCoinData>& inputs,
+	const uint64_t f,
+	const uint64_t vout,
+	const std::vector<OutputCoinData>& outputs
+) {
+	this->f = f; // fee
+    this->vout = vout; // transparent output value
+
+	std::vector<Scalar> k; // nonces
+	generate_outputs(inputs, outputs, k);
+	prove_balance(full_view_key, inputs, k);
+}
+
+// Output coins and their range proof only depend on the input tags, so they can be generated alongside the input proofs
+void SpendTransaction::generate_outputs(
+	const std::vector<InputCoinData>& inputs,
+	const std::vector<OutputCoinData>& outputs,
+	std::vector<Scalar>& k
+) {
+	const std::size_t t = outputs.size(); // number of generated coins
+
+	// Prepare output vector
+	this->out_coins.reserve(t); // coins
+	k.reserve(t); // nonces
 
 	// Generate output coins and prepare range proof vectors
 	std::vector<Scalar> range_v;
@@ -114,8 +442,13 @@ SpendTransaction::SpendTransaction(
 	std::vector<GroupElement> range_C;
 
 	// Serial context for all outputs is the set of linking tags for this transaction, which must always be in a fixed order
+	std::vector<GroupElement> tags;
+	tags.reserve(inputs.size());
+	for (const InputCoinData& input : inputs) {
+		tags.emplace_back(input.T);
+	}
     CDataStream serial_context(SER_NETWORK, PROTOCOL_VERSION);
-	serial_context << this->T;
+	serial_context << tags;
 
 	for (std::size_t j = 0; j < t; j++) {
 		// Nonce
@@ -154,25 +487,46 @@ SpendTransaction::SpendTransaction(
 		range_C,
 		this->range_proof
 	);
+}
 
-	// Generate the balance proof
+// The balance proof needs the input value commitment offsets, the output coins and the fee
+void SpendTransaction::prove_balance(
+	const FullViewKey& full_view_key,
+	const std::vector<InputCoinData>& inputs,
+	const std::vector<Scalar>& k
+) {
 	Schnorr schnorr(this->params->get_H());
 	GroupElement balance_statement;
 	Scalar balance_witness;
-	for (std::size_t u = 0; u < w; u++) {
+	for (std::size_t u = 0; u < inputs.size(); u++) {
 		balance_statement += this->C1[u];
 		balance_witness += SparkUtils::hash_val1(inputs[u].s, full_view_key.get_D());
 	}
-	for (std::size_t j = 0; j < t; j++) {
+	for (std::size_t j = 0; j < this->out_coins.size(); j++) {
 		balance_statement += this->out_coins[j].C.inverse();
 		balance_witness -= SparkUtils::hash_val(k[j]);
 	}
-	balance_statement += (this->params->get_G()*Scalar(f + vout)).inverse();
+	balance_statement += this->params->get_G_table().multiply(Scalar(this->f + this->vout)).inverse();
 	schnorr.prove(
 		balance_witness,
 		balance_statement,
 		this->balance_proof
 	);
+}
+
+// Final stage: authorize the transaction with a Chaum proof over the binding hash
+void SpendTransaction::bind(
+	const FullViewKey& full_view_key,
+	const SpendKey& spend_key,
+	const std::vector<InputCoinData>& inputs
+) {
+	// Prepare Chaum vectors
+	std::vector<Scalar> chaum_x, chaum_y, chaum_z;
+	for (std::size_t u = 0; u < inputs.size(); u++) {
+		chaum_x.emplace_back(inputs[u].s);
+		chaum_y.emplace_back(spend_key.get_r());
+		chaum_z.emplace_back(SparkUtils::hash_ser1(inputs[u].s, full_view_key.get_D()).negate());
+	}
 
 	// Compute the binding hash
 	Scalar mu = hash_bind(
@@ -184,7 +538,7 @@ SpendTransaction::SpendTransaction(
 			this->range_proof
 		),
 		this->out_coins,
-		this->f + vout
+		this->f + this->vout
 	);
 
 	// Compute the authorizing Chaum proof
@@ -229,13 +583,82 @@ bool SpendTransaction::verify(
 	return verify(transaction.params, transactions, cover_sets);
 }
 
+bool SpendTransaction::verify(
+        const SpendTransaction& transaction,
+        const std::unordered_map<uint64_t, CoverSet>& cover_sets) {
+	std::vector<SpendTransaction> transactions = { transaction };
+	return verify(transaction.params, transactions, cover_sets);
+}
+
+bool SpendTransaction::verify(
+        const SpendTransaction& transaction,
+        const CoverSetStore& cover_sets) {
+	std::vector<SpendTransaction> transactions = { transaction };
+	return verify(transaction.params, transactions, cover_sets);
+}
+
+bool SpendTransaction::verify(
+        const Params* params,
+        const std::vector<SpendTransaction>& transactions,
+        const std::unordered_map<uint64_t, std::vector<Coin>>& cover_sets,
+        Executor& executor) {
+	return verify_cover_sets(params, transactions, cover_sets, executor);
+}
+
+bool SpendTransaction::verify(
+        const Params* params,
+        const std::vector<SpendTransaction>& transactions,
+        const std::unordered_map<uint64_t, CoverSet>& cover_sets,
+        Executor& executor) {
+	return verify_cover_sets(params, transactions, cover_sets, executor);
+}
+
+bool SpendTransaction::verify(
+        const Params* params,
+        const std::vector<SpendTransaction>& transactions,
+        const CoverSetStore& cover_sets,
+        Executor& executor) {
+	return verify_cover_sets(params, transactions, cover_sets, executor);
+}
+
+// Uniform access to the cover sets passed for verification
+template <typename CoverSetType>
+static std::size_t largest_cover_set(const std::unordered_map<uint64_t, CoverSetType>& cover_sets) {
+	std::size_t result = 0;
+	for (const auto& set : cover_sets) {
+		result = std::max(result, set.second.size());
+	}
+	return result;
+}
+
+static std::size_t largest_cover_set(const CoverSetStore& cover_sets) {
+	std::size_t result = 0;
+	for (uint64_t id : cover_sets.ids()) {
+		result = std::max(result, cover_sets.at(id).cover_set.size());
+	}
+	return result;
+}
+
+template <typename CoverSetType>
+static const CoverSetType& cover_set_at(const std::unordered_map<uint64_t, CoverSetType>& cover_sets, const uint64_t id) {
+	return cover_sets.at(id);
+}
+
+static const std::vector<Coin>& cover_set_at(const CoverSetStore& cover_sets, const uint64_t id) {
+	return cover_sets.at(id).cover_set;
+}
+
 // Determine if a set of spend transactions is collectively valid
 // NOTE: This assumes that the relationship between a `cover_set_id` and the provided `cover_set` is already valid and canonical!
 // NOTE: This assumes that validity criteria relating to chain context have been externally checked!
-bool SpendTransaction::verify(
+template <typename CoverSetMap>
+bool SpendTransaction::verify_cover_sets(
         const Params* params,
         const std::vector<SpendTransaction>& transactions,
-        const std::unordered_map<uint64_t, std::vector<Coin>>& cover_sets) {
+        const CoverSetMap& cover_sets,
+        Executor& executor) {
+	SPARK_TIME_STAGE(SPEND_VERIFY);
+
 	// The idea here is to perform batching as broadly as possible
 	// - Grootle proofs can be batched if they share a (partial) cover set
 	// - Range proofs can always be batched arbitrarily
@@ -273,10 +696,8 @@ bool SpendTransaction::verify(
 		}
 
 		// Cover set semantics
-		for (const auto& set : cover_sets) {
-			if (set.second.size() > N) {
-				throw std::invalid_argument("Bad spend transaction semantics");
-			}
+		if (largest_cover_set(cover_sets) > N) {
+			throw std::invalid_argument("Bad spend transaction semantics");
 		}
 
 		// Store range proof with commitments
@@ -305,71 +726,79 @@ bool SpendTransaction::verify(
 		);
 
 		// Verify the authorizing Chaum-Pedersen proof
-		Chaum chaum(
-			tx.params->get_F(),
-			tx.params->get_G(),
-			tx.params->get_H(),
-			tx.params->get_U()
-		);
-		if (!chaum.verify(mu, tx.S1, tx.T, tx.chaum_proof)) {
-			return false;
+		{
+			SPARK_TIME_STAGE(SPEND_VERIFY_CHAUM);
+			Chaum chaum(
+				tx.params->get_F(),
+				tx.params->get_G(),
+				tx.params->get_H(),
+				tx.params->get_U()
+			);
+			if (!chaum.verify(mu, tx.S1, tx.T, tx.chaum_proof)) {
+				return false;
+			}
 		}
 
 		// Verify the balance proof
-		Schnorr schnorr(tx.params->get_H());
-		GroupElement balance_statement;
-		for (std::size_t u = 0; u < w; u++) {
-			balance_statement += tx.C1[u];
-		}
-		for (std::size_t j = 0; j < t; j++) {
-			balance_statement += tx.out_coins[j].C.inverse();
-		}
-        balance_statement += (tx.params->get_G()*Scalar(tx.f + tx.vout)).inverse();
-        
-		if(!schnorr.verify(
-			balance_statement,
-			tx.balance_proof
-		)) {
-			return false;
+		{
+			SPARK_TIME_STAGE(SPEND_VERIFY_BALANCE);
+			Schnorr schnorr(tx.params->get_H());
+			GroupElement balance_statement;
+			for (std::size_t u = 0; u < w; u++) {
+				balance_statement += tx.C1[u];
+			}
+			for (std::size_t j = 0; j < t; j++) {
+				balance_statement += tx.out_coins[j].C.inverse();
+			}
+			balance_statement += tx.params->get_G_table().multiply(Scalar(tx.f + tx.vout)).inverse();
+
+			if(!schnorr.verify(
+				balance_statement,
+				tx.balance_proof
+			)) {
+				return false;
+			}
 		}
 	}
 
 	// Verify all range proofs in a batch
-	BPPlus range(
-		params->get_G(),
-		params->get_H(),
-		params->get_G_range(),
-		params->get_H_range(),
-		64
-	);
-	if (!range.verify(range_proofs_C, range_proofs)) {
-		return false;
+	{
+		SPARK_TIME_STAGE(SPEND_VERIFY_RANGE);
+		BPPlus range(
+			params->get_G(),
+			params->get_H(),
+			params->get_G_range(),
+			params->get_H_range(),
+			64,
+			executor
+		);
+		if (!range.verify(range_proofs_C, range_proofs)) {
+			return false;
+		}
 	}
 
 	// Verify all Grootle proofs in batches (based on cover set)
 	// TODO: Finish this
+	SPARK_TIME_STAGE(SPEND_VERIFY_MEMBERSHIP);
 	Grootle grootle(
 		params->get_H(),
 		params->get_G_grootle(),
 		params->get_H_grootle(),
 		params->get_n_grootle(),
-		params->get_m_grootle()
+		params->get_m_grootle(),
+		executor
 	);
 	for (auto grootle_bucket : grootle_buckets) {
 		std::size_t cover_set_id = grootle_bucket.first;
 		std::vector<std::pair<std::size_t, std::size_t>> proof_indexes = grootle_bucket.second;
 
 		// Build the proof statement and metadata vectors from these proofs
-		std::vector<GroupElement> S, S1, V, V1;
+		std::vector<GroupElement> S1, V1;
 		std::vector<std::vector<unsigned char>> cover_set_representations;
 		std::vector<std::size_t> sizes;
 		std::vector<GrootleProof> proofs;
 
-        std::size_t full_cover_set_size = cover_sets.at(cover_set_id).size();
-        for (std::size_t i = 0; i < full_cover_set_size; i++) {
-            S.emplace_back(cover_sets.at(cover_set_id)[i].S);
-            V.emplace_back(cover_sets.at(cover_set_id)[i].C);
-        }
+        const auto& cover_set = cover_set_at(cover_sets, cover_set_id);
 
 		for (auto proof_index : proof_indexes) {
             const auto& tx = transactions[proof_index.first];
@@ -393,7 +822,7 @@ bool SpendTransaction::verify(
 		}
 
 		// Verify the batch
-		if (!grootle.verify(S, S1, V, V1, cover_set_representations, sizes, proofs)) {
+		if (!verify_membership(grootle, cover_set, S1, V1, cover_set_representations, sizes, proofs)) {
             return false;
         }
 	}
@@ -402,6 +831,23 @@ bool SpendTransaction::verify(
 	return true;
 }
 
+// Follows the serialization order of the transaction fields
+std::size_t SpendTransaction::estimate_serialized_size(const Params* params, const std::size_t w, const std::size_t t, const std::size_t sets) {
+	const std::size_t n = params->get_n_grootle();
+	const std::size_t m = params->get_m_grootle();
+
+	std::size_t size = GetSizeOfCompactSize(w) + w*sizeof(uint64_t); // cover set ids
+	size += GetSizeOfCompactSize(sets) + sets*(sizeof(uint64_t) + sizeof(uint256)); // block hashes
+	size += sizeof(uint64_t); // fee
+	size += 3*(GetSizeOfCompactSize(w) + w*GroupElement::memoryRequired()); // S1, C1, T
+	size += GetSizeOfCompactSize(w) + w*GrootleProof::serializedSize(n, m);
+	size += ChaumProof::serializedSize(w);
+	size += SchnorrProof::serializedSize();
+	size += BPPlusProof::serializedSize(64, t);
+
+	return size;
+}
+
 // Hash function H_bind_inner
 // This function pre-hashes auxiliary data that makes things easier for a limited signer who cannot process the data directly
 // Its value is then used as part of the binding hash, which a limited signer can verify as part of the signing process
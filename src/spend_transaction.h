@@ -7,6 +7,7 @@
 #include "grootle.h"
 #include "bpplus.h"
 #include "chaum.h"
+#include "cover_set_store.h"
 
 namespace spark {
 
@@ -25,9 +26,24 @@ struct InputCoinData {
 	Scalar k; // nonce
 };
 
-struct CoverSetData {
-    std::vector<Coin> cover_set; // set of coins used as a cover set for the spend
-    std::vector<unsigned char> cover_set_representation; // a unique representation for the ordered elements of the partial `cover_set` used in the spend
+// An input's offsets, tag and membership proof, which depend only on the coin, its cover set and the set's representation
+// These can be proven before the outputs are known, but are stale once the representation changes
+struct InputProof {
+	uint64_t cover_set_id;
+	std::size_t cover_set_size;
+	std::vector<unsigned char> cover_set_representation;
+	GroupElement S1; // serial commitment offset
+	GroupElement C1; // value commitment offset
+	GroupElement T; // tag
+	GrootleProof proof;
+};
+
+// A cover set read in chunks while proving, so that provers need not hold the whole set in memory
+// `memory_limit` bounds the memory held for a chunk of each input proof (see `Grootle::prove`)
+struct StreamingCoverSetData {
+	std::shared_ptr<CoverSetReader> reader;
+	std::vector<unsigned char> cover_set_representation;
+	std::size_t memory_limit = Grootle::DEFAULT_STREAMING_MEMORY_LIMIT;
 };
 
 struct OutputCoinData {
@@ -41,6 +57,7 @@ public:
     SpendTransaction(
             const Params* params);
 
+	// Inputs are proven on the executor, concurrently with the range proof
 	SpendTransaction(
 		const Params* params,
 		const FullViewKey& full_view_key,
@@ -49,17 +66,80 @@ public:
         const std::unordered_map<uint64_t, CoverSetData>& cover_set_data,
 		const uint64_t f,
         const uint64_t vout,
+		const std::vector<OutputCoinData>& outputs,
+		Executor& executor = Executor::get_default()
+	);
+
+	SpendTransaction(
+		const Params* params,
+		const FullViewKey& full_view_key,
+		const SpendKey& spend_key,
+		const std::vector<InputCoinData>& inputs,
+        const std::unordered_map<uint64_t, CompactCoverSetData>& cover_set_data,
+		const uint64_t f,
+        const uint64_t vout,
+		const std::vector<OutputCoinData>& outputs,
+		Executor& executor = Executor::get_default()
+	);
+
+	SpendTransaction(
+		const Params* params,
+		const FullViewKey& full_view_key,
+		const SpendKey& spend_key,
+		const std::vector<InputCoinData>& inputs,
+        const std::unordered_map<uint64_t, StreamingCoverSetData>& cover_set_data,
+		const uint64_t f,
+        const uint64_t vout,
+		const std::vector<OutputCoinData>& outputs,
+		Executor& executor = Executor::get_default()
+	);
+
+	SpendTransaction(
+		const Params* params,
+		const FullViewKey& full_view_key,
+		const SpendKey& spend_key,
+		const std::vector<InputCoinData>& inputs,
+        const CoverSetStore& cover_set_data,
+		const uint64_t f,
+        const uint64_t vout,
+		const std::vector<OutputCoinData>& outputs,
+		Executor& executor = Executor::get_default()
+	);
+
+	// Build a spend from input proofs generated in advance, one for each input in order
+	// Only the cover sets used by the inputs are bound to the transaction
+	SpendTransaction(
+		const Params* params,
+		const FullViewKey& full_view_key,
+		const SpendKey& spend_key,
+		const std::vector<InputCoinData>& inputs,
+		const std::vector<InputProof>& input_proofs,
+		const uint64_t f,
+		const uint64_t vout,
 		const std::vector<OutputCoinData>& outputs
 	);
 
+	static InputProof prove_input(const Params* params, const FullViewKey& full_view_key, const InputCoinData& input, const CoverSetData& cover_set_data, Executor& executor = Executor::get_default());
+	static InputProof prove_input(const Params* params, const FullViewKey& full_view_key, const InputCoinData& input, const CompactCoverSetData& cover_set_data, Executor& executor = Executor::get_default());
+	static InputProof prove_input(const Params* params, const FullViewKey& full_view_key, const InputCoinData& input, const StreamingCoverSetData& cover_set_data, Executor& executor = Executor::get_default());
+
 	uint64_t getFee();
     const std::vector<GroupElement>& getUsedLTags() const;
     const std::vector<Coin>& getOutCoins();
     const std::vector<uint64_t>& getCoinGroupIds();
 
-	static bool verify(const Params* params, const std::vector<SpendTransaction>& transactions, const std::unordered_map<uint64_t, std::vector<Coin>>& cover_sets);
+	// Batch verification splits its largest multiscalar multiplications between the executor's threads
+	static bool verify(const Params* params, const std::vector<SpendTransaction>& transactions, const std::unordered_map<uint64_t, std::vector<Coin>>& cover_sets, Executor& executor = Executor::get_default());
 	static bool verify(const SpendTransaction& transaction, const std::unordered_map<uint64_t, std::vector<Coin>>& cover_sets);
+	static bool verify(const Params* params, const std::vector<SpendTransaction>& transactions, const std::unordered_map<uint64_t, CoverSet>& cover_sets, Executor& executor = Executor::get_default());
+	static bool verify(const SpendTransaction& transaction, const std::unordered_map<uint64_t, CoverSet>& cover_sets);
+	static bool verify(const Params* params, const std::vector<SpendTransaction>& transactions, const CoverSetStore& cover_sets, Executor& executor = Executor::get_default());
+	static bool verify(const SpendTransaction& transaction, const CoverSetStore& cover_sets);
     
+	// Exact serialized size of a spend with `w` inputs from `sets` distinct cover sets and `t` outputs
+	// Output coins are not part of the serialized spend; see Coin::serializedSize
+	static std::size_t estimate_serialized_size(const Params* params, const std::size_t w, const std::size_t t, const std::size_t sets);
+
 	std::vector<unsigned char> hash_bind_inner(
 		const std::unordered_map<uint64_t, std::vector<unsigned char>>& cover_set_representations,
         const std::vector<GroupElement>& C1,
@@ -77,16 +157,17 @@ public:
     template <typename Stream, typename Operation>
     void SerializationOp(Stream& s, Operation ser_action)
     {
-        READWRITE(cover_set_ids);
-        READWRITE(set_id_blockHash);
-        READWRITE(f);
-        READWRITE(S1);
-        READWRITE(C1);
-        READWRITE(T);
-        READWRITE(grootle_proofs);
-        READWRITE(chaum_proof);
-        READWRITE(balance_proof);
-        READWRITE(range_proof);
+        SPARK_TIME_STAGE(SPEND_SERIALIZATION);
+        if (ser_action.ForRead()) {
+            // Read every point first, then decompress them together
+            {
+                GroupElement::LazyDeserialization lazy;
+                SerializationFields(s, ser_action);
+            }
+            decompressPoints();
+        } else {
+            SerializationFields(s, ser_action);
+        }
     }
 
     void setOutCoins(const std::vector<Coin>& out_coins_) {
@@ -100,6 +181,28 @@ public:
         }
     }
 
+    void setCoverSets(const std::unordered_map<uint64_t, CompactCoverSetData>& cover_set_data) {
+        for (const auto& data : cover_set_data) {
+            this->cover_set_sizes[data.first] = data.second.cover_set.size();
+            this->cover_set_representations[data.first] = data.second.cover_set_representation;
+        }
+    }
+
+    void setCoverSets(const std::unordered_map<uint64_t, StreamingCoverSetData>& cover_set_data) {
+        for (const auto& data : cover_set_data) {
+            this->cover_set_sizes[data.first] = data.second.reader->size();
+            this->cover_set_representations[data.first] = data.second.cover_set_representation;
+        }
+    }
+
+    void setCoverSets(const CoverSetStore& cover_set_data) {
+        for (uint64_t id : cover_set_data.ids()) {
+            const CoverSetData& data = cover_set_data.at(id);
+            this->cover_set_sizes[id] = data.cover_set.size();
+            this->cover_set_representations[id] = data.cover_set_representation;
+        }
+    }
+
     void setVout(const uint64_t& vout_) {
         this->vout = vout_;
     }
@@ -108,6 +211,61 @@ public:
 
     const std::map<uint64_t, uint256>& getBlockHashes();
 private:
+    template <typename Stream, typename Operation>
+    void SerializationFields(Stream& s, Operation ser_action)
+    {
+        READWRITE(cover_set_ids);
+        READWRITE(set_id_blockHash);
+        READWRITE(f);
+        READWRITE(S1);
+        READWRITE(C1);
+        READWRITE(T);
+        READWRITE(grootle_proofs);
+        READWRITE(chaum_proof);
+        READWRITE(balance_proof);
+        READWRITE(range_proof);
+    }
+	void decompressPoints();
+	template <typename CoverSetDataMap>
+	void generate(
+		const FullViewKey& full_view_key,
+		const SpendKey& spend_key,
+		const std::vector<InputCoinData>& inputs,
+		const CoverSetDataMap& cover_set_data,
+		const uint64_t f,
+		const uint64_t vout,
+		const std::vector<OutputCoinData>& outputs,
+		Executor& executor
+	);
+	void attach_inputs(
+		const std::vector<InputCoinData>& inputs,
+		const std::vector<InputProof>& input_proofs
+	);
+	void attach_outputs(
+		const FullViewKey& full_view_key,
+		const std::vector<InputCoinData>& inputs,
+		const uint64_t f,
+		const uint64_t vout,
+		const std::vector<OutputCoinData>& outputs
+	);
+	void generate_outputs(
+		const std::vector<InputCoinData>& inputs,
+		const std::vector<OutputCoinData>& outputs,
+		std::vector<Scalar>& k
+	);
+	void prove_balance(
+		const FullViewKey& full_view_key,
+		const std::vector<InputCoinData>& inputs,
+		const std::vector<Scalar>& k
+	);
+	void bind(
+		const FullViewKey& full_view_key,
+		const SpendKey& spend_key,
+		const std::vector<InputCoinData>& inputs
+	);
+	template <typename CoverSetMap>
+	static bool verify_cover_sets(const Params* params, const std::vector<SpendTransaction>& transactions, const CoverSetMap& cover_sets, Executor& executor);
+
 	const Params* params;
     // We need to construct and pass this data before running verification
 	std::unordered_map<uint64_t, std::size_t> cover_set_sizes;
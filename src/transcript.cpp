@@ -18,7 +18,9 @@ Transcript::Transcript(const std::string domain) {
 
     // Write the protocol and mode information
     std::vector<unsigned char> protocol(LABEL_PROTOCOL.begin(), LABEL_PROTOCOL.end());
+    SPARK_COUNT(HASH_BYTES, protocol.size());
     EVP_DigestUpdate(this->ctx, protocol.data(), protocol.size());
+    SPARK_COUNT(HASH_BYTES, sizeof(HASH_MODE_TRANSCRIPT));
     EVP_DigestUpdate(this->ctx, &HASH_MODE_TRANSCRIPT, sizeof(HASH_MODE_TRANSCRIPT));
 
     // Domain separator
@@ -122,11 +124,13 @@ Scalar Transcript::challenge(const std::string label) {
         EVP_MD_CTX_copy_ex(state_counter, this->ctx);
 
         // Embed the counter
+        SPARK_COUNT(HASH_BYTES, sizeof(counter));
         EVP_DigestUpdate(state_counter, &counter, sizeof(counter));
 
         // Finalize the hash with a temporary state
         EVP_MD_CTX_copy_ex(state_finalize, state_counter);
         unsigned int TEMP; // We already know the digest length!
+        SPARK_COUNT(HASH_FINALIZATIONS, 1);
         EVP_DigestFinal_ex(state_finalize, hash.data(), &TEMP);
 
         // Check for scalar validity
@@ -151,11 +155,13 @@ void Transcript::size(const std::size_t size_) {
     std::vector<unsigned char> size_data;
     size_data.resize(SCALAR_ENCODING);
     size_scalar.serialize(size_data.data());
+    SPARK_COUNT(HASH_BYTES, size_data.size());
     EVP_DigestUpdate(this->ctx, size_data.data(), size_data.size());
 }
 
 // Include a flag
 void Transcript::include_flag(const unsigned char flag) {
+    SPARK_COUNT(HASH_BYTES, sizeof(flag));
     EVP_DigestUpdate(this->ctx, &flag, sizeof(flag));
 }
 
@@ -171,6 +177,7 @@ void Transcript::include_data(const std::vector<unsigned char>& data) {
     size(data.size());
 
     // Include data
+    SPARK_COUNT(HASH_BYTES, data.size());
     EVP_DigestUpdate(this->ctx, data.data(), data.size());
 }
 
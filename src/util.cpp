@@ -1,4 +1,5 @@
 #include "util.h"
+#include "../bitcoin/crypto/common.h"
 
 namespace spark {
 
@@ -55,6 +56,80 @@ uint64_t SparkUtils::diversifier_decrypt(const std::vector<unsigned char>& key,
     return i;
 }
 
+// Encrypt a diversifier using an expanded AES-256 key
+// With a zero IV and a diversifier shorter than one block, padded CBC encryption is a single block operation
+std::vector<unsigned char> SparkUtils::diversifier_encrypt(const AES256Encrypt& aes, const uint64_t i) {
+    // Serialize and pad the diversifier
+    unsigned char plaintext[AES_BLOCKSIZE];
+    WriteLE64(plaintext, i);
+    memset(plaintext + sizeof(uint64_t), AES_BLOCKSIZE - sizeof(uint64_t), AES_BLOCKSIZE - sizeof(uint64_t));
+
+    std::vector<unsigned char> ciphertext;
+    ciphertext.resize(AES_BLOCKSIZE);
+    aes.Encrypt(ciphertext.data(), plaintext);
+
+    return ciphertext;
+}
+
+// Decrypt a diversifier using an expanded AES-256 key
+uint64_t SparkUtils::diversifier_decrypt(const AES256Decrypt& aes, const std::vector<unsigned char>& d) {
+    // Assert proper size
+    if (d.size() != AES_BLOCKSIZE) {
+        throw std::invalid_argument("Bad encrypted diversifier");
+    }
+
+    unsigned char plaintext[AES_BLOCKSIZE];
+    aes.Decrypt(plaintext, d.data());
+
+    // Deserialize the diversifier
+    return ReadLE64(plaintext);
+}
+
+// Encrypt consecutive diversifiers with one multi-block AES call
+std::vector<std::vector<unsigned char>> SparkUtils::diversifier_encrypt(const AES256Encrypt& aes, const uint64_t i, const std::size_t count) {
+    // Serialize and pad every diversifier
+    std::vector<unsigned char> plaintext(count * AES_BLOCKSIZE, AES_BLOCKSIZE - sizeof(uint64_t));
+    for (std::size_t j = 0; j < count; j++) {
+        WriteLE64(plaintext.data() + j * AES_BLOCKSIZE, i + j);
+    }
+
+    std::vector<unsigned char> ciphertext(count * AES_BLOCKSIZE);
+    aes.Encrypt(ciphertext.data(), plaintext.data(), count);
+
+    std::vector<std::vector<unsigned char>> result;
+    result.reserve(count);
+    for (std::size_t j = 0; j < count; j++) {
+        result.emplace_back(ciphertext.begin() + j * AES_BLOCKSIZE, ciphertext.begin() + (j + 1) * AES_BLOCKSIZE);
+    }
+
+    return result;
+}
+
+// Decrypt a list of diversifiers with one multi-block AES call
+std::vector<uint64_t> SparkUtils::diversifier_decrypt(const AES256Decrypt& aes, const std::vector<std::vector<unsigned char>>& d) {
+    // Assert proper sizes and gather the blocks
+    std::vector<unsigned char> ciphertext;
+    ciphertext.reserve(d.size() * AES_BLOCKSIZE);
+    for (const auto& d_ : d) {
+        if (d_.size() != AES_BLOCKSIZE) {
+            throw std::invalid_argument("Bad encrypted diversifier");
+        }
+        ciphertext.insert(ciphertext.end(), d_.begin(), d_.end());
+    }
+
+    std::vector<unsigned char> plaintext(ciphertext.size());
+    aes.Decrypt(plaintext.data(), ciphertext.data(), d.size());
+
+    // Deserialize the diversifiers
+    std::vector<uint64_t> result;
+    result.reserve(d.size());
+    for (std::size_t j = 0; j < d.size(); j++) {
+        result.emplace_back(ReadLE64(plaintext.data() + j * AES_BLOCKSIZE));
+    }
+
+    return result;
+}
+
 // Produce a uniformly-sampled group element from a label
 GroupElement SparkUtils::hash_generator(const std::string label) {
 	const int GROUP_ENCODING = 34;
@@ -165,6 +240,20 @@ std::vector<unsigned char> SparkUtils::commit_aead(const GroupElement& K_der) {
     return kdf.finalize();
 }
 
+// Derive both the ChaCha20 key and its commitment, serializing the prekey only once
+void SparkUtils::kdf_commit_aead(const GroupElement& K_der, std::vector<unsigned char>& key, std::vector<unsigned char>& key_commitment) {
+    CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+    stream << K_der;
+
+    KDF kdf(LABEL_KDF_AEAD, AEAD_KEY_SIZE);
+    kdf.include(stream);
+    key = kdf.finalize();
+
+    KDF commit(LABEL_COMMIT_AEAD, AEAD_COMMIT_SIZE);
+    commit.include(stream);
+    key_commitment = commit.finalize();
+}
+
 // Hash-to-group function H_div
 GroupElement SparkUtils::hash_div(const std::vector<unsigned char>& d) {
     Hash hash(LABEL_HASH_DIV);
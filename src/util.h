@@ -2,6 +2,8 @@
 #define FIRO_SPARK_UTIL_H
 #include "../secp256k1/include/Scalar.h"
 #include "../secp256k1/include/GroupElement.h"
+#include "../secp256k1/include/Instrumentation.h"
+#include "../secp256k1/include/RandomGenerator.h"
 #include "../bitcoin/crypto/aes.h"
 #include "../bitcoin/streams.h"
 #include "kdf.h"
@@ -91,10 +93,19 @@ public:
     static std::vector<unsigned char> kdf_diversifier(const Scalar& s1);
     static std::vector<unsigned char> kdf_aead(const GroupElement& K_der);
     static std::vector<unsigned char> commit_aead(const GroupElement& K_der);
+    static void kdf_commit_aead(const GroupElement& K_der, std::vector<unsigned char>& key, std::vector<unsigned char>& key_commitment);
 
     // Diversifier encryption/decryption
     static std::vector<unsigned char> diversifier_encrypt(const std::vector<unsigned char>& key, const uint64_t i);
     static uint64_t diversifier_decrypt(const std::vector<unsigned char>& key, const std::vector<unsigned char>& d);
+
+    // Diversifier encryption/decryption with an already-expanded AES key schedule
+    static std::vector<unsigned char> diversifier_encrypt(const AES256Encrypt& aes, const uint64_t i);
+    static uint64_t diversifier_decrypt(const AES256Decrypt& aes, const std::vector<unsigned char>& d);
+
+    // Batch versions for diversifiers i, i + 1, ..., i + count - 1 and for a list of encrypted diversifiers
+    static std::vector<std::vector<unsigned char>> diversifier_encrypt(const AES256Encrypt& aes, const uint64_t i, const std::size_t count);
+    static std::vector<uint64_t> diversifier_decrypt(const AES256Decrypt& aes, const std::vector<std::vector<unsigned char>>& d);
 };
 
 }
@@ -124,6 +124,57 @@ BOOST_AUTO_TEST_CASE(evil_network)
     BOOST_CHECK_THROW(decoded.decode(encoded), std::invalid_argument);
 }
 
+// Check that batch derivation matches individual derivation
+BOOST_AUTO_TEST_CASE(derive_addresses)
+{
+    // Parameters
+    const Params* params;
+    params = Params::get_test();
+
+    // Generate keys
+    SpendKey spend_key(params);
+    FullViewKey full_view_key(spend_key);
+    IncomingViewKey incoming_view_key(full_view_key);
+
+    // Derive a range of addresses
+    const uint64_t i = 12345;
+    const std::size_t count = 8;
+    std::vector<Address> addresses = Address::derive_addresses(incoming_view_key, i, count);
+    BOOST_CHECK_EQUAL(addresses.size(), count);
+
+    for (std::size_t j = 0; j < count; j++) {
+        Address address(incoming_view_key, i + j);
+
+        BOOST_CHECK_EQUAL_COLLECTIONS(address.get_d().begin(), address.get_d().end(), addresses[j].get_d().begin(), addresses[j].get_d().end());
+        BOOST_CHECK_EQUAL(address.get_Q1(), addresses[j].get_Q1());
+        BOOST_CHECK_EQUAL(address.get_Q2(), addresses[j].get_Q2());
+
+        // Check the precomputed F multiple against a direct multiplication
+        BOOST_CHECK_EQUAL(addresses[j].get_Q2(), params->get_F()*SparkUtils::hash_Q2(incoming_view_key.get_s1(), i + j) + incoming_view_key.get_P2());
+
+        // Check the diversifier against the uncached key derivation
+        std::vector<unsigned char> key = SparkUtils::kdf_diversifier(incoming_view_key.get_s1());
+        BOOST_CHECK(addresses[j].get_d() == SparkUtils::diversifier_encrypt(key, i + j));
+    }
+
+    // Recover the diversifiers in a batch
+    std::vector<std::vector<unsigned char>> d;
+    for (const Address& address : addresses) {
+        d.emplace_back(address.get_d());
+    }
+    std::vector<uint64_t> diversifiers = incoming_view_key.get_diversifiers(d);
+    for (std::size_t j = 0; j < count; j++) {
+        BOOST_CHECK_EQUAL(diversifiers[j], i + j);
+    }
+
+    // A key without s1 has no diversifier key until a derived key is assigned to it
+    IncomingViewKey empty_key(params);
+    BOOST_CHECK_THROW(empty_key.encrypt_diversifier(i), std::runtime_error);
+    BOOST_CHECK_THROW(empty_key.get_diversifier(d[0]), std::runtime_error);
+    empty_key = incoming_view_key;
+    BOOST_CHECK_EQUAL(empty_key.get_diversifier(d[0]), i);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
@@ -147,6 +147,90 @@ BOOST_AUTO_TEST_CASE(bad_key_commitment)
     BOOST_CHECK_THROW(ser = AEAD::decrypt_and_verify(prekey, "Associated data", data), std::runtime_error);
 }
 
+BOOST_AUTO_TEST_CASE(engine)
+{
+    AEADEngine engine("Associated data");
+
+    // Key
+    GroupElement prekey;
+    prekey.randomize();
+
+    // Serialize and encrypt a message
+    int message = 12345;
+    CDataStream ser(SER_NETWORK, PROTOCOL_VERSION);
+    ser << message;
+    AEADEncryptedData data = engine.encrypt(prekey, ser);
+
+    // The engine must be interchangeable with the one-shot interface
+    BOOST_CHECK(data.ciphertext == AEAD::encrypt(prekey, "Associated data", ser).ciphertext);
+    CDataStream result = AEAD::decrypt_and_verify(prekey, "Associated data", data);
+    int message_;
+    result >> message_;
+    BOOST_CHECK_EQUAL(message_, message);
+
+    // Decrypt into a reused stream
+    result << 1;
+    engine.decrypt_and_verify(prekey, data, result);
+    result >> message_;
+    BOOST_CHECK_EQUAL(message_, message);
+    BOOST_CHECK(result.empty());
+
+    // Decrypt into a raw buffer
+    std::vector<unsigned char> plaintext(data.ciphertext.size());
+    BOOST_CHECK(engine.decrypt(prekey, data, plaintext.data()));
+    BOOST_CHECK(std::equal(plaintext.begin(), plaintext.end(), ser.begin()));
+
+    // A different label must fail
+    AEADEngine evil_engine("Evil data");
+    BOOST_CHECK(!evil_engine.decrypt(prekey, data, plaintext.data()));
+    BOOST_CHECK_THROW(evil_engine.decrypt_and_verify(prekey, data, result), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(batch)
+{
+    AEADEngine engine("Associated data");
+    const std::size_t N = 5;
+
+    // Encrypt a message under each key
+    std::vector<GroupElement> prekeys(N);
+    std::vector<AEADEncryptedData> data(N);
+    for (std::size_t i = 0; i < N; i++) {
+        prekeys[i].randomize();
+        CDataStream ser(SER_NETWORK, PROTOCOL_VERSION);
+        ser << (int)i;
+        data[i] = engine.encrypt(prekeys[i], ser);
+    }
+
+    // Corrupt one tag and use the wrong key for another
+    data[1].tag[0] ^= 1;
+    prekeys[3].randomize();
+
+    std::vector<const AEADEncryptedData*> data_pointers;
+    for (const AEADEncryptedData& item : data) {
+        data_pointers.emplace_back(&item);
+    }
+
+    std::vector<CDataStream> results;
+    std::vector<bool> valid = engine.decrypt(prekeys, data_pointers, results);
+    BOOST_CHECK_EQUAL(valid.size(), N);
+    BOOST_CHECK_EQUAL(results.size(), N);
+    for (std::size_t i = 0; i < N; i++) {
+        if (i == 1 || i == 3) {
+            BOOST_CHECK(!valid[i]);
+            BOOST_CHECK(results[i].empty());
+        } else {
+            BOOST_CHECK(valid[i]);
+            int message_;
+            results[i] >> message_;
+            BOOST_CHECK_EQUAL(message_, (int)i);
+        }
+    }
+
+    // Mismatched batch sizes
+    prekeys.pop_back();
+    BOOST_CHECK_THROW(engine.decrypt(prekeys, data_pointers, results), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
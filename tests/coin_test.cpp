@@ -120,6 +120,61 @@ BOOST_AUTO_TEST_CASE(spend_identify_recover)
     );
     BOOST_CHECK_EQUAL(r_data.T*r_data.s + full_view_key.get_D(), params->get_U());
 }
+BOOST_AUTO_TEST_CASE(coin_view)
+{
+    // Parameters
+    const Params* params;
+    params = Params::get_default();
+
+    const uint64_t i = 12345;
+    const uint64_t v = 86;
+    const std::string memo = "Spam and eggs";
+    const std::vector<unsigned char> serial_context = random_char_vector();
+
+    // Generate keys
+    SpendKey spend_key(params);
+    FullViewKey full_view_key(spend_key);
+    IncomingViewKey incoming_view_key(full_view_key);
+    IncomingViewKey evil_incoming_view_key((FullViewKey(SpendKey(params))));
+
+    // Generate address
+    Address address(incoming_view_key, i);
+
+    for (char type : { COIN_TYPE_MINT, COIN_TYPE_SPEND }) {
+        // Generate and serialize a coin
+        Scalar k;
+        k.randomize();
+        Coin coin(params, type, k, address, v, memo, serial_context);
+        CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+        stream << coin;
+        std::vector<unsigned char> serialized(stream.begin(), stream.end());
+
+        // Parse in place
+        CoinView view(params, serialized.data(), serialized.size());
+        BOOST_CHECK_EQUAL(view.size(), serialized.size());
+        BOOST_CHECK_EQUAL(view.get_type(), type);
+        BOOST_CHECK(view.get_K() == coin.K);
+        BOOST_CHECK(view.to_coin(serial_context) == coin);
+        if (type == COIN_TYPE_MINT) {
+            BOOST_CHECK_EQUAL(view.get_v(), v);
+        }
+
+        // Identify coin
+        IdentifiedCoinData i_data;
+        BOOST_CHECK(view.identify(incoming_view_key, serial_context, i_data));
+        BOOST_CHECK_EQUAL(i_data.i, i);
+        BOOST_CHECK_EQUAL(i_data.v, v);
+        BOOST_CHECK_EQUAL(i_data.k, k);
+
+        // Wrong key or serial context
+        BOOST_CHECK(!view.identify(evil_incoming_view_key, serial_context, i_data));
+        BOOST_CHECK(!view.identify(incoming_view_key, random_char_vector(), i_data));
+
+        // Truncated data
+        BOOST_CHECK_THROW(CoinView(params, serialized.data(), serialized.size() - 1), std::invalid_argument);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
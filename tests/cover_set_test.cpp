@@ -0,0 +1,302 @@
+#include "../src/cover_set_file.h"
+#include "../src/coin.h"
+#include "../src/cover_set_store.h"
+#include "../src/grootle.h"
+
+#include <fstream>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+namespace spark {
+
+static std::vector<GroupElement> random_group_vector(const std::size_t n) {
+    std::vector<GroupElement> result;
+    result.resize(n);
+    for (std::size_t i = 0; i < n; i++) {
+        result[i].randomize();
+    }
+    return result;
+}
+
+static CoverSet random_cover_set(const std::size_t n) {
+    CoverSet result;
+    for (std::size_t i = 0; i < n; i++) {
+        result.append(random_group_vector(1)[0], random_group_vector(1)[0]);
+    }
+    return result;
+}
+
+static bool same_points(const CoverSet& a, const CoverSet& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.size(); i++) {
+        if (a.get_S(i) != b.get_S(i) || a.get_C(i) != b.get_C(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+class SparkTest {
+public:
+    SparkTest() {
+        char name[] = "/tmp/spark_cover_set_XXXXXX";
+        int fd = mkstemp(name);
+        if (fd >= 0) {
+            close(fd);
+        }
+        path = name;
+    }
+
+    ~SparkTest() {
+        unlink(path.c_str());
+    }
+
+    std::string path;
+};
+
+BOOST_FIXTURE_TEST_SUITE(spark_cover_set_tests, SparkTest)
+
+BOOST_AUTO_TEST_CASE(write_read)
+{
+    CoverSet set = random_cover_set(10);
+    std::vector<unsigned char> representation = random_group_vector(1)[0].getvch();
+    CoverSetFile::write(path, set, representation);
+
+    std::vector<unsigned char> representation_;
+    CoverSet set_ = CoverSetFile::read(path, representation_);
+    BOOST_CHECK(representation_ == representation);
+    BOOST_CHECK(same_points(set, set_));
+
+    // The points are used in place
+    BOOST_CHECK_EQUAL(set_.memoryRequired(), 0);
+
+    // Empty sets are allowed
+    CoverSetFile::write(path, CoverSet(), {});
+    BOOST_CHECK(CoverSetFile::read(path, representation_).empty());
+    BOOST_CHECK(representation_.empty());
+}
+
+BOOST_AUTO_TEST_CASE(append)
+{
+    CoverSet set = random_cover_set(4);
+    CoverSetFile::write(path, set, {1}, 6);
+
+    // In place, and then past the reserved capacity
+    CoverSet more = random_cover_set(2);
+    CoverSet even_more = random_cover_set(5);
+    CoverSetFile::append(path, more, {2});
+    std::vector<unsigned char> representation;
+    CoverSet in_place = CoverSetFile::read(path, representation);
+    CoverSetFile::append(path, even_more, {3});
+    CoverSet grown = CoverSetFile::read(path, representation);
+    BOOST_CHECK(representation == std::vector<unsigned char>({3}));
+
+    CoverSet expected = set;
+    for (std::size_t i = 0; i < more.size(); i++) {
+        expected.append(more.get_S(i), more.get_C(i));
+    }
+    BOOST_CHECK(same_points(in_place, expected));
+    for (std::size_t i = 0; i < even_more.size(); i++) {
+        expected.append(even_more.get_S(i), even_more.get_C(i));
+    }
+    BOOST_CHECK(same_points(grown, expected));
+
+    // Earlier views are unaffected by the rewrite
+    BOOST_CHECK_EQUAL(in_place.size(), 6);
+
+    // Appending to a view copies it first
+    in_place.append(even_more.get_S(0), even_more.get_C(0));
+    BOOST_CHECK_EQUAL(in_place.size(), 7);
+    BOOST_CHECK(in_place.get_S(6) == even_more.get_S(0));
+}
+
+BOOST_AUTO_TEST_CASE(corruption)
+{
+    CoverSet set = random_cover_set(3);
+    CoverSetFile::write(path, set, {1, 2, 3});
+
+    // Flip a bit in the last value commitment
+    {
+        const std::streamoff offset = CoverSetFile::HEADER_SIZE + 6*GroupElement::affine_size - 1;
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekg(offset);
+        char byte = file.get();
+        file.seekp(offset);
+        file.put(byte ^ 1);
+    }
+    std::vector<unsigned char> representation;
+    BOOST_CHECK_THROW(CoverSetFile::read(path, representation), std::runtime_error);
+    BOOST_CHECK_NO_THROW(CoverSetFile::read(path, representation, false));
+    BOOST_CHECK_THROW(CoverSetFile::append(path, set, {}), std::runtime_error);
+
+    // Truncated and foreign files
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << "not a cover set";
+    }
+    BOOST_CHECK_THROW(CoverSetFile::read(path, representation), std::runtime_error);
+    BOOST_CHECK_THROW(CoverSetFile::read(path + ".missing", representation), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(prove)
+{
+    const std::size_t n = 4;
+    const std::size_t m = 2;
+
+    GroupElement H;
+    H.randomize();
+    Grootle grootle(H, random_group_vector(n*m), random_group_vector(n*m), n, m);
+
+    // Commitments with one opening to zero against the offsets
+    std::vector<GroupElement> S = random_group_vector(10);
+    std::vector<GroupElement> V = random_group_vector(10);
+    const std::size_t l = 7;
+    Scalar s, v;
+    s.randomize();
+    v.randomize();
+    GroupElement S1 = S[l];
+    GroupElement V1 = V[l];
+    S[l] += H*s;
+    V[l] += H*v;
+
+    CoverSet set;
+    for (std::size_t i = 0; i < S.size(); i++) {
+        set.append(S[i], V[i]);
+    }
+    CoverSetFile::write(path, set, {});
+
+    std::vector<unsigned char> representation;
+    CoverSet mapped = CoverSetFile::read(path, representation);
+    std::vector<unsigned char> root = {1, 2, 3};
+    GrootleProof proof;
+    grootle.prove(l, s, mapped, S1, v, V1, root, proof);
+    BOOST_CHECK(grootle.verify(mapped, S1, V1, root, mapped.size(), proof));
+    BOOST_CHECK(grootle.verify(S, S1, V, V1, root, S.size(), proof));
+
+    // Stream the set from the file in small chunks instead
+    CoverSetFileReader reader(path);
+    GrootleProof streamed_proof;
+    grootle.prove(l, s, reader, S1, v, V1, root, streamed_proof, 4096);
+    BOOST_CHECK(grootle.verify(S, S1, V, V1, root, S.size(), streamed_proof));
+}
+
+BOOST_AUTO_TEST_CASE(file_reader)
+{
+    CoverSet set = random_cover_set(7);
+    CoverSetFile::write(path, set, {4, 5}, 9);
+
+    CoverSetFileReader reader(path);
+    BOOST_CHECK_EQUAL(reader.size(), set.size());
+    BOOST_CHECK(reader.get_cover_set_representation() == std::vector<unsigned char>({4, 5}));
+
+    std::vector<unsigned char> S(3*GroupElement::affine_size), C(3*GroupElement::affine_size);
+    reader.read(4, 3, S.data(), C.data());
+    BOOST_CHECK(memcmp(S.data(), set.S_data() + 4*GroupElement::affine_size, S.size()) == 0);
+    BOOST_CHECK(memcmp(C.data(), set.C_data() + 4*GroupElement::affine_size, C.size()) == 0);
+    BOOST_CHECK_THROW(reader.read(5, 3, S.data(), C.data()), std::out_of_range);
+
+    // The checksum is verified on opening
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(CoverSetFile::HEADER_SIZE);
+        file.put(set.S_data()[0] ^ 1);
+    }
+    BOOST_CHECK_THROW(CoverSetFileReader corrupted(path), std::runtime_error);
+    BOOST_CHECK_NO_THROW(CoverSetFileReader unverified(path, false));
+}
+
+BOOST_AUTO_TEST_CASE(index)
+{
+    CoverSet set = random_cover_set(20);
+    CoverSetIndex index(set);
+    BOOST_CHECK_EQUAL(index.size(), 20);
+    for (std::size_t i = 0; i < set.size(); i++) {
+        std::size_t position;
+        BOOST_CHECK(index.find(set.get_S(i), position));
+        BOOST_CHECK_EQUAL(position, i);
+    }
+    std::size_t position;
+    BOOST_CHECK(!index.find(set.get_C(0), position));
+
+    // Coins appended later take the following positions
+    const Params* params = Params::get_default();
+    SpendKey spend_key(params);
+    FullViewKey full_view_key(spend_key);
+    IncomingViewKey incoming_view_key(full_view_key);
+    Address address(incoming_view_key, 1);
+    std::vector<Coin> coins;
+    for (std::size_t i = 0; i < 3; i++) {
+        Scalar k;
+        k.randomize();
+        coins.emplace_back(params, COIN_TYPE_MINT, k, address, 10 + i, "", std::vector<unsigned char>{1, 2, 3});
+    }
+    index.append(coins);
+    BOOST_CHECK_EQUAL(index.size(), 23);
+    BOOST_CHECK(index.find(coins[2].S, position));
+    BOOST_CHECK_EQUAL(position, 22);
+
+    // Indexing coins directly gives the same positions
+    CoverSetIndex coin_index(coins);
+    BOOST_CHECK(coin_index.find(coins[1].S, position));
+    BOOST_CHECK_EQUAL(position, 1);
+}
+
+BOOST_AUTO_TEST_CASE(store)
+{
+    const Params* params = Params::get_default();
+    SpendKey spend_key(params);
+    FullViewKey full_view_key(spend_key);
+    IncomingViewKey incoming_view_key(full_view_key);
+    Address address(incoming_view_key, 1);
+
+    CoverSetStore store;
+    for (uint64_t id = 1; id <= 3; id++) {
+        CoverSetData data;
+        for (std::size_t i = 0; i < 2; i++) {
+            Scalar k;
+            k.randomize();
+            data.cover_set.emplace_back(params, COIN_TYPE_MINT, k, address, i, "", std::vector<unsigned char>{1});
+        }
+        data.cover_set_representation = {(unsigned char) id};
+        store.add(id, std::move(data));
+    }
+    BOOST_CHECK_EQUAL(store.size(), 3);
+
+    // Selection shares the sets
+    CoverSetStore selected = store.select({1, 3});
+    BOOST_CHECK_EQUAL(selected.size(), 2);
+    BOOST_CHECK_EQUAL(selected.count(2), 0);
+    BOOST_CHECK(selected.get(3) == store.get(3));
+    BOOST_CHECK_THROW(store.select({4}), std::invalid_argument);
+    BOOST_CHECK_THROW(store.at(4), std::invalid_argument);
+
+    // So do their indexes
+    const CoverSetIndex& index = selected.get_index(3);
+    BOOST_CHECK(&index == &store.get_index(3));
+    std::size_t position;
+    BOOST_CHECK(index.find(store.at(3).cover_set[1].S, position));
+    BOOST_CHECK_EQUAL(position, 1);
+
+    // Sets outlive the store that added them
+    std::shared_ptr<const CoverSetData> set = store.get(1);
+    store = CoverSetStore();
+    BOOST_CHECK_EQUAL(set->cover_set.size(), 2);
+    BOOST_CHECK_EQUAL(selected.at(1).cover_set_representation[0], 1);
+
+    // A caller's index must match its set
+    BOOST_CHECK_THROW(store.add(1, set, std::make_shared<const CoverSetIndex>()), std::invalid_argument);
+    store.add(1, set, std::make_shared<const CoverSetIndex>(set->cover_set));
+    BOOST_CHECK_EQUAL(store.get_index(1).size(), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
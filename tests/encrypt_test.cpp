@@ -1,5 +1,6 @@
 #include "../src/util.h"
 #include <stdio.h>
+#include <string.h>
 
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MAIN
@@ -51,6 +52,106 @@ BOOST_AUTO_TEST_CASE(bad_key)
     BOOST_CHECK_NE(i_, i);
 }
 
+BOOST_AUTO_TEST_CASE(expanded_key)
+{
+    // Key
+    std::string key_string = "Key prefix";
+    std::vector<unsigned char> key(key_string.begin(), key_string.end());
+    key.resize(AES256_KEYSIZE);
+
+    AES256Encrypt encryptor(key.data());
+    AES256Decrypt decryptor(key.data());
+
+    for (uint64_t i : { uint64_t(0), uint64_t(12345), uint64_t(0xFFFFFFFFFFFFFFFF) }) {
+        // Encryption must match the padded CBC construction
+        std::vector<unsigned char> d = SparkUtils::diversifier_encrypt(encryptor, i);
+        BOOST_CHECK(d == SparkUtils::diversifier_encrypt(key, i));
+
+        // Decrypt
+        BOOST_CHECK_EQUAL(SparkUtils::diversifier_decrypt(decryptor, d), i);
+        BOOST_CHECK_EQUAL(SparkUtils::diversifier_decrypt(key, d), i);
+    }
+
+    // Bad ciphertext size
+    std::vector<unsigned char> d(AES_BLOCKSIZE + 1);
+    BOOST_CHECK_THROW(SparkUtils::diversifier_decrypt(decryptor, d), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(aes_implementation)
+{
+    // FIPS-197 appendix C.3
+    unsigned char key[AES256_KEYSIZE];
+    unsigned char plaintext[AES_BLOCKSIZE];
+    for (int i = 0; i < AES256_KEYSIZE; i++) {
+        key[i] = i;
+    }
+    for (int i = 0; i < AES_BLOCKSIZE; i++) {
+        plaintext[i] = 0x11 * i;
+    }
+    const unsigned char expected[AES_BLOCKSIZE] = {
+        0x8e, 0xa2, 0xb7, 0xca, 0x51, 0x67, 0x45, 0xbf, 0xea, 0xfc, 0x49, 0x90, 0x4b, 0x49, 0x60, 0x89
+    };
+
+    unsigned char ciphertext[AES_BLOCKSIZE];
+    unsigned char decrypted[AES_BLOCKSIZE];
+    AES256Encrypt(key).Encrypt(ciphertext, plaintext);
+    AES256Decrypt(key).Decrypt(decrypted, ciphertext);
+    BOOST_CHECK(memcmp(ciphertext, expected, AES_BLOCKSIZE) == 0);
+    BOOST_CHECK(memcmp(decrypted, plaintext, AES_BLOCKSIZE) == 0);
+
+    // Whichever implementation is active must agree with ctaes on every batch size
+    for (std::size_t blocks = 0; blocks <= 9; blocks++) {
+        std::vector<unsigned char> data(blocks * AES_BLOCKSIZE);
+        for (std::size_t i = 0; i < data.size(); i++) {
+            data[i] = (unsigned char)(i * 7 + blocks);
+        }
+        key[0] = (unsigned char)blocks;
+
+        AES256_ctx ctx;
+        AES256_init(&ctx, key);
+        std::vector<unsigned char> expected_blocks(data.size());
+        AES256_encrypt(&ctx, blocks, expected_blocks.data(), data.data());
+
+        std::vector<unsigned char> encrypted(data.size());
+        std::vector<unsigned char> roundtrip(data.size());
+        AES256Encrypt(key).Encrypt(encrypted.data(), data.data(), blocks);
+        AES256Decrypt(key).Decrypt(roundtrip.data(), encrypted.data(), blocks);
+        BOOST_CHECK(encrypted == expected_blocks);
+        BOOST_CHECK(roundtrip == data);
+    }
+
+    BOOST_TEST_MESSAGE("AES-256 implementation: " << AES256Implementation());
+}
+
+BOOST_AUTO_TEST_CASE(batch)
+{
+    // Key
+    std::string key_string = "Key prefix";
+    std::vector<unsigned char> key(key_string.begin(), key_string.end());
+    key.resize(AES256_KEYSIZE);
+
+    AES256Encrypt encryptor(key.data());
+    AES256Decrypt decryptor(key.data());
+
+    const uint64_t i = 0xFFFFFFFFFFFFFFF0;
+    const std::size_t count = 11;
+    std::vector<std::vector<unsigned char>> d = SparkUtils::diversifier_encrypt(encryptor, i, count);
+    BOOST_CHECK_EQUAL(d.size(), count);
+    for (std::size_t j = 0; j < count; j++) {
+        BOOST_CHECK(d[j] == SparkUtils::diversifier_encrypt(key, i + j));
+    }
+
+    std::vector<uint64_t> decrypted = SparkUtils::diversifier_decrypt(decryptor, d);
+    BOOST_CHECK_EQUAL(decrypted.size(), count);
+    for (std::size_t j = 0; j < count; j++) {
+        BOOST_CHECK_EQUAL(decrypted[j], i + j);
+    }
+
+    // Bad ciphertext size anywhere in the batch
+    d[count - 1].pop_back();
+    BOOST_CHECK_THROW(SparkUtils::diversifier_decrypt(decryptor, d), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
@@ -91,6 +91,14 @@ BOOST_AUTO_TEST_CASE(batch)
     }
 
     BOOST_CHECK(grootle.verify(S, S1, V, V1, roots, sizes, proofs));
+
+    // A deserialized proof has its points decompressed together
+    CDataStream serialized(SER_NETWORK, PROTOCOL_VERSION);
+    serialized << proofs[0];
+    GrootleProof deserialized;
+    serialized >> deserialized;
+    BOOST_CHECK(deserialized.X[0].isDecompressed());
+    BOOST_CHECK(grootle.verify(S, S1[0], V, V1[0], roots[0], sizes[0], deserialized));
 }
 
 BOOST_AUTO_TEST_CASE(invalid_batch)
@@ -172,6 +180,208 @@ BOOST_AUTO_TEST_CASE(invalid_batch)
     BOOST_CHECK(!grootle.verify(S, S1, V, V1, roots, sizes, proofs));
 }
 
+BOOST_AUTO_TEST_CASE(compact_cover_set)
+{
+    // Parameters
+    const std::size_t n = 4;
+    const std::size_t m = 3;
+
+    // Generators
+    GroupElement H;
+    H.randomize();
+    std::vector<GroupElement> Gi = random_group_vector(n*m);
+    std::vector<GroupElement> Hi = random_group_vector(n*m);
+
+    // Commitments
+    std::size_t commit_size = 60; // require padding
+    std::vector<GroupElement> S = random_group_vector(commit_size);
+    std::vector<GroupElement> V = random_group_vector(commit_size);
+
+    // Generate valid commitments to zero
+    std::vector<std::size_t> indexes = { 0, 1, 3, 59 };
+    std::vector<std::size_t> sizes = { 60, 60, 59, 16 };
+    std::vector<GroupElement> S1, V1;
+    std::vector<std::vector<unsigned char>> roots;
+    std::vector<Scalar> s, v;
+    for (std::size_t index : indexes) {
+        Scalar s_, v_;
+        s_.randomize();
+        v_.randomize();
+        s.emplace_back(s_);
+        v.emplace_back(v_);
+
+        S1.emplace_back(S[index]);
+        V1.emplace_back(V[index]);
+
+        S[index] += H*s_;
+        V[index] += H*v_;
+
+        roots.emplace_back(random_group_vector(1)[0].getvch());
+    }
+
+    // The compact set holds the same points in affine form
+    CoverSet set;
+    set.reserve(commit_size);
+    for (std::size_t i = 0; i < commit_size; i++) {
+        set.append(S[i], V[i]);
+    }
+    BOOST_CHECK_EQUAL(set.size(), commit_size);
+    BOOST_CHECK_EQUAL(set.memoryRequired(), 2*commit_size*GroupElement::affine_size);
+    for (std::size_t i = 0; i < commit_size; i++) {
+        BOOST_CHECK(set.get_S(i) == S[i]);
+        BOOST_CHECK(set.get_C(i) == V[i]);
+    }
+    BOOST_CHECK_THROW(set.get_S(commit_size), std::out_of_range);
+
+    // Proofs made from either representation verify against both
+    Grootle grootle(H, Gi, Hi, n, m);
+    std::vector<GrootleProof> proofs;
+    for (std::size_t i = 0; i < indexes.size(); i++) {
+        CoverSet partial_set;
+        for (std::size_t j = commit_size - sizes[i]; j < commit_size; j++) {
+            partial_set.append(S[j], V[j]);
+        }
+
+        proofs.emplace_back();
+        grootle.prove(
+            indexes[i] - (commit_size - sizes[i]),
+            s[i],
+            partial_set,
+            S1[i],
+            v[i],
+            V1[i],
+            roots[i],
+            proofs.back()
+        );
+
+        BOOST_CHECK(grootle.verify(set, S1[i], V1[i], roots[i], sizes[i], proofs.back()));
+        BOOST_CHECK(grootle.verify(S, S1[i], V, V1[i], roots[i], sizes[i], proofs.back()));
+    }
+    BOOST_CHECK(grootle.verify(set, S1, V1, roots, sizes, proofs));
+
+    // A bad statement is rejected
+    BOOST_CHECK_THROW(grootle.prove(0, s[1], set, S1[0], v[0], V1[0], roots[0], proofs[0]), std::invalid_argument);
+
+    // So is a bad offset
+    S1.back().randomize();
+    BOOST_CHECK(!grootle.verify(set, S1, V1, roots, sizes, proofs));
+}
+
+BOOST_AUTO_TEST_CASE(affine_encoding)
+{
+    std::vector<GroupElement> points = random_group_vector(5);
+    points.emplace_back(); // infinity
+
+    std::vector<unsigned char> batch(points.size()*GroupElement::affine_size);
+    GroupElement::serialize_affine(points, batch.data());
+
+    for (std::size_t i = 0; i < points.size(); i++) {
+        unsigned char single[GroupElement::affine_size];
+        BOOST_CHECK(points[i].serialize_affine(single) == single + GroupElement::affine_size);
+        BOOST_CHECK(memcmp(single, batch.data() + i*GroupElement::affine_size, GroupElement::affine_size) == 0);
+
+        GroupElement decoded;
+        decoded.deserialize_affine(single);
+        BOOST_CHECK(decoded == points[i]);
+    }
+
+    // Off-curve points are rejected
+    unsigned char bad[GroupElement::affine_size];
+    points[0].serialize_affine(bad);
+    bad[GroupElement::affine_size - 1] ^= 1;
+    GroupElement decoded;
+    BOOST_CHECK_THROW(decoded.deserialize_affine(bad), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(streaming)
+{
+    // Parameters
+    const std::size_t n = 4;
+    const std::size_t m = 3;
+
+    // Generators
+    GroupElement H;
+    H.randomize();
+    std::vector<GroupElement> Gi = random_group_vector(n*m);
+    std::vector<GroupElement> Hi = random_group_vector(n*m);
+
+    // Commitments, with one opening to zero against the offsets
+    std::size_t commit_size = 50; // require padding
+    std::vector<GroupElement> S = random_group_vector(commit_size);
+    std::vector<GroupElement> V = random_group_vector(commit_size);
+    const std::size_t l = 49;
+    Scalar s, v;
+    s.randomize();
+    v.randomize();
+    GroupElement S1 = S[l];
+    GroupElement V1 = V[l];
+    S[l] += H*s;
+    V[l] += H*v;
+    std::vector<unsigned char> root = random_group_vector(1)[0].getvch();
+
+    CoverSet set;
+    for (std::size_t i = 0; i < commit_size; i++) {
+        set.append(S[i], V[i]);
+    }
+    CoverSetMemoryReader reader(set);
+
+    // Chunks of a single commitment, several commitments, and the whole set
+    Grootle grootle(H, Gi, Hi, n, m);
+    for (std::size_t memory_limit : { std::size_t(1), std::size_t(8*1024), Grootle::DEFAULT_STREAMING_MEMORY_LIMIT }) {
+        GrootleProof proof;
+        grootle.prove(l, s, reader, S1, v, V1, root, proof, memory_limit);
+        BOOST_CHECK(grootle.verify(S, S1, V, V1, root, commit_size, proof));
+        BOOST_CHECK(grootle.verify(set, S1, V1, root, commit_size, proof));
+    }
+
+    // A bad statement is still rejected
+    GrootleProof proof;
+    BOOST_CHECK_THROW(grootle.prove(l - 1, s, reader, S1, v, V1, root, proof), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(executor)
+{
+    ThreadPool pool(4);
+    BOOST_CHECK_EQUAL(pool.concurrency(), 4);
+
+    // Nested batches all run, and the earliest failure is the one reported
+    std::atomic<std::size_t> count(0);
+    std::vector<std::function<void()>> tasks;
+    for (std::size_t i = 0; i < 8; i++) {
+        tasks.emplace_back([&pool, &count] {
+            std::vector<std::function<void()>> inner(8, [&count] { count++; });
+            pool.run(inner);
+        });
+    }
+    pool.run(tasks);
+    BOOST_CHECK_EQUAL(count.load(), 64);
+
+    tasks.clear();
+    for (std::size_t i = 0; i < 8; i++) {
+        tasks.emplace_back([i] {
+            if (i >= 3) {
+                throw std::runtime_error(std::to_string(i));
+            }
+        });
+    }
+    try {
+        pool.run(tasks);
+        BOOST_FAIL("No failure reported");
+    } catch (const std::runtime_error& e) {
+        BOOST_CHECK_EQUAL(std::string(e.what()), "3");
+    }
+
+    // Split multiexponentiation agrees with the serial one
+    const std::size_t size = 3*MultiExponent::min_part_size + 5;
+    std::vector<GroupElement> points = random_group_vector(size);
+    std::vector<Scalar> scalars(size);
+    for (Scalar& scalar : scalars) {
+        scalar.randomize();
+    }
+    MultiExponent mult(points, scalars);
+    BOOST_CHECK(mult.get_multiple(pool) == mult.get_multiple());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
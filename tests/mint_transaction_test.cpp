@@ -1,4 +1,5 @@
 #include "../src/mint_transaction.h"
+#include "test_points.h"
 
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MAIN
@@ -59,6 +60,59 @@ BOOST_AUTO_TEST_CASE(generate_verify)
     BOOST_CHECK(mint.verify());
 }
 
+BOOST_AUTO_TEST_CASE(serialize_deserialize)
+{
+    // Parameters
+    const Params* params;
+    params = Params::get_default();
+    const std::size_t t = 3; // number of coins to generate
+
+    // Generate keys
+    SpendKey spend_key(params);
+    FullViewKey full_view_key(spend_key);
+    IncomingViewKey incoming_view_key(full_view_key);
+
+    std::vector<MintedCoinData> outputs;
+    for (std::size_t j = 0; j < t; j++) {
+        MintedCoinData output;
+        output.address = Address(incoming_view_key, 12345 + j);
+        output.v = 678 + j;
+        output.memo = "Spam and eggs";
+
+        outputs.emplace_back(output);
+    }
+
+    MintTransaction mint(
+        params,
+        outputs,
+        random_char_vector()
+    );
+
+    // Round trip through the deferred decompression path
+    std::vector<CDataStream> serialized = mint.getMintedCoinsSerialized();
+    MintTransaction deserialized(params);
+    deserialized.setMintTransaction(serialized);
+    BOOST_CHECK(deserialized.verify());
+
+    std::vector<Coin> coins, deserialized_coins;
+    mint.getCoins(coins);
+    deserialized.getCoins(deserialized_coins);
+    BOOST_CHECK(coins == deserialized_coins);
+    for (const Coin& coin : deserialized_coins) {
+        BOOST_CHECK(coin.S.isDecompressed() && coin.K.isDecompressed() && coin.C.isDecompressed());
+    }
+
+    unsigned char bad_point[GroupElement::serialize_size];
+    off_curve_point(bad_point);
+
+    // An invalid recovery key in the last coin must still be rejected
+    serialized = mint.getMintedCoinsSerialized();
+    const std::size_t K_offset = 1 + GroupElement::serialize_size;
+    std::copy(bad_point, bad_point + GroupElement::serialize_size, serialized.back().begin() + K_offset);
+    MintTransaction evil(params);
+    BOOST_CHECK_THROW(evil.setMintTransaction(serialized), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
@@ -0,0 +1,125 @@
+#include "../src/params.h"
+#include "../src/generator_tables.h"
+#include "../src/params_cache.h"
+
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+namespace spark {
+
+class SparkTest {};
+
+BOOST_FIXTURE_TEST_SUITE(spark_params_tests, SparkTest)
+
+BOOST_AUTO_TEST_CASE(generator_tables)
+{
+    // The embedded generators are the ones their labels derive
+    BOOST_CHECK(GeneratorTables::check());
+
+    const Params* params = Params::get_default();
+    BOOST_CHECK(params->get_F() == SparkUtils::hash_generator(LABEL_GENERATOR_F));
+    BOOST_CHECK(params->get_H() == SparkUtils::hash_generator(LABEL_GENERATOR_H));
+    BOOST_CHECK(params->get_U() == SparkUtils::hash_generator(LABEL_GENERATOR_U));
+    BOOST_CHECK(params->get_G_range().back() == SparkUtils::hash_generator(LABEL_GENERATOR_G_RANGE + " " + std::to_string(params->get_G_range().size() - 1)));
+    BOOST_CHECK(params->get_H_grootle().back() == SparkUtils::hash_generator(LABEL_GENERATOR_H_GROOTLE + " " + std::to_string(params->get_H_grootle().size() - 1)));
+
+    // Generators past the end of a table are derived
+    const std::size_t index = GeneratorTables::grootle_size;
+    BOOST_CHECK(GeneratorTables::get(LABEL_GENERATOR_G_GROOTLE, index) == SparkUtils::hash_generator(LABEL_GENERATOR_G_GROOTLE + " " + std::to_string(index)));
+    BOOST_CHECK(GeneratorTables::get(LABEL_GENERATOR_G_GROOTLE, index - 1) == SparkUtils::hash_generator(LABEL_GENERATOR_G_GROOTLE + " " + std::to_string(index - 1)));
+}
+
+BOOST_AUTO_TEST_CASE(cache)
+{
+    const std::string path = "params_cache_test.bin";
+    std::remove(path.c_str());
+    BOOST_CHECK(!ParamsCache::load(path, 32, 2, 2, 4, 4));
+
+    // Built and saved on the first request, and loaded afterwards
+    std::unique_ptr<Params> built = ParamsCache::load_or_build(path, 32, 2, 2, 4, 4);
+    std::unique_ptr<Params> loaded = ParamsCache::load(path, 32, 2, 2, 4, 4);
+    BOOST_REQUIRE(loaded);
+    BOOST_CHECK(loaded->get_F() == built->get_F());
+    BOOST_CHECK(loaded->get_H() == built->get_H());
+    BOOST_CHECK(loaded->get_U() == built->get_U());
+    BOOST_CHECK(loaded->get_G_range() == built->get_G_range());
+    BOOST_CHECK(loaded->get_H_range() == built->get_H_range());
+    BOOST_CHECK(loaded->get_G_grootle() == built->get_G_grootle());
+    BOOST_CHECK(loaded->get_H_grootle() == built->get_H_grootle());
+
+    Scalar scalar;
+    scalar.randomize();
+    BOOST_CHECK(loaded->get_F_table().multiply(scalar) == built->get_F()*scalar);
+    BOOST_CHECK(loaded->get_G_table().multiply(scalar) == built->get_G()*scalar);
+    BOOST_CHECK(loaded->get_H_table().multiply(scalar) == built->get_H()*scalar);
+
+    // A file for other parameters or another table size is stale
+    BOOST_CHECK(!ParamsCache::load(path, 32, 2, 2, 5, 4));
+    BOOST_CHECK(!ParamsCache::load(path, 32, 2, 2, 4, 6));
+
+    // A file whose fingerprint differs, e.g. one built with another table layout, is stale
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(64);
+        char first = file.get();
+        file.seekp(64);
+        file.put(first ^ 1);
+    }
+    BOOST_CHECK(!ParamsCache::load(path, 32, 2, 2, 4, 4));
+    BOOST_REQUIRE(ParamsCache::load_or_build(path, 32, 2, 2, 4, 4));
+    BOOST_CHECK(ParamsCache::load(path, 32, 2, 2, 4, 4));
+
+    // A damaged file is rejected and rebuilt
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(-1, std::ios::end);
+        char last = file.get();
+        file.seekp(-1, std::ios::end);
+        file.put(last ^ 1);
+    }
+    BOOST_CHECK(!ParamsCache::load(path, 32, 2, 2, 4, 4));
+    BOOST_CHECK(ParamsCache::load_or_build(path, 32, 2, 2, 4, 4)->get_H_table().multiply(scalar) == built->get_H()*scalar);
+    BOOST_CHECK(ParamsCache::load(path, 32, 2, 2, 4, 4));
+
+    std::remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(registry)
+{
+    // Deployment and test parameters coexist
+    const Params* deployment = Params::get_default();
+    const Params* test = Params::get_test();
+    BOOST_CHECK(deployment != test);
+    BOOST_CHECK_EQUAL(deployment->get_n_grootle(), 8);
+    BOOST_CHECK_EQUAL(test->get_n_grootle(), 2);
+    BOOST_CHECK_EQUAL(Params::get_instance(32, 16, 8, 5), deployment);
+
+    // Every thread asking for a new parameter set gets the same instance
+    std::vector<const Params*> results(4);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < results.size(); i++) {
+        threads.emplace_back([&results, i] {
+            results[i] = Params::get_instance(32, 4, 4, 3);
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (const Params* params : results) {
+        BOOST_CHECK_EQUAL(params, results[0]);
+    }
+    BOOST_CHECK_EQUAL(results[0]->get_G_range().size(), 4*64);
+    BOOST_CHECK_EQUAL(results[0]->get_G_grootle().size(), 4*3);
+
+    BOOST_CHECK_THROW(Params::get_instance(32, 4, 1, 3), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
@@ -0,0 +1,305 @@
+#include "../src/util.h"
+#include "../secp256k1/include/FixedBaseTable.h"
+#include "../secp256k1/include/MultiExponent.h"
+#include "test_points.h"
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+namespace spark {
+
+using namespace secp_primitives;
+
+class SparkTest {};
+
+// Plain double-and-add, which does not split the scalar
+static GroupElement reference_multiply(const GroupElement& point, const Scalar& scalar) {
+    std::vector<bool> bits;
+    scalar.get_bits(bits);
+    GroupElement result;
+    for (bool bit : bits) {
+        result.square();
+        if (bit) {
+            result += point;
+        }
+    }
+    return result;
+}
+
+// Scalars around the endomorphism split: small and large values, the cube root of unity and values near 2^128
+static std::vector<Scalar> edge_scalars() {
+    std::vector<Scalar> result;
+    result.emplace_back(uint64_t(1));
+    result.emplace_back(uint64_t(2));
+    result.emplace_back(Scalar(uint64_t(0)) - Scalar(uint64_t(1)));
+
+    Scalar lambda;
+    lambda.SetHex("5363ad4cc05c30e0a5261c028812645a122e22ea20816678df02967c1b23bd72");
+    result.emplace_back(lambda);
+    result.emplace_back(lambda.negate());
+    result.emplace_back(lambda + Scalar(uint64_t(1)));
+
+    Scalar two_128;
+    two_128.SetHex("0000000000000000000000000000000100000000000000000000000000000000");
+    result.emplace_back(two_128);
+    result.emplace_back(two_128 - Scalar(uint64_t(1)));
+    result.emplace_back(two_128.negate());
+
+    for (std::size_t i = 0; i < 8; i++) {
+        result.emplace_back();
+        result.back().randomize();
+    }
+    return result;
+}
+
+BOOST_FIXTURE_TEST_SUITE(spark_primitives_tests, SparkTest)
+
+BOOST_AUTO_TEST_CASE(endomorphism)
+{
+    GroupElement point;
+    point.randomize();
+    FixedBaseTable table(point);
+
+    // Variable-base multiplication agrees with double-and-add and with the fixed-base table, neither of which use the split
+    for (const Scalar& scalar : edge_scalars()) {
+        GroupElement expected = reference_multiply(point, scalar);
+        BOOST_CHECK_EQUAL(point*scalar, expected);
+        BOOST_CHECK_EQUAL(table.multiply(scalar), expected);
+
+        GroupElement in_place = point;
+        in_place *= scalar;
+        BOOST_CHECK_EQUAL(in_place, expected);
+    }
+    BOOST_CHECK((point*Scalar(uint64_t(0))).isInfinity());
+
+    // Multiexponentiation on both sides of the Strauss and Pippenger threshold
+    for (std::size_t size : {1, 2, 17, 200}) {
+        std::vector<GroupElement> points(size);
+        std::vector<Scalar> scalars = edge_scalars();
+        scalars.resize(size);
+        GroupElement expected;
+        for (std::size_t i = 0; i < size; i++) {
+            points[i].randomize();
+            if (scalars[i].isZero()) {
+                scalars[i].randomize();
+            }
+            expected += reference_multiply(points[i], scalars[i]);
+        }
+        MultiExponent multiexponent(points, scalars);
+        BOOST_CHECK_EQUAL(multiexponent.get_multiple(), expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(inversion)
+{
+    std::vector<Scalar> scalars = edge_scalars();
+    Scalar half;
+    half.SetHex("7fffffffffffffffffffffffffffffff5d576e7357a4501ddfe92f46681b20a0");
+    scalars.push_back(half);
+    scalars.push_back(half + Scalar(uint64_t(1)));
+
+    // Constant and variable time inversion agree, and both invert
+    for (const Scalar& scalar : scalars) {
+        Scalar inverse = scalar.inverse();
+        BOOST_CHECK_EQUAL(inverse, scalar.inverse_var());
+        BOOST_CHECK_EQUAL(inverse*scalar, Scalar(uint64_t(1)));
+        BOOST_CHECK_EQUAL(inverse.inverse(), scalar);
+    }
+
+    // Zero has no inverse and maps to zero
+    BOOST_CHECK(Scalar(uint64_t(0)).inverse().isZero());
+    BOOST_CHECK(Scalar(uint64_t(0)).inverse_var().isZero());
+
+    // Field inversion is exercised by the conversion to affine coordinates that serialization performs
+    for (std::size_t i = 0; i < 8; i++) {
+        GroupElement point;
+        point.randomize();
+        GroupElement projective = point*scalars[i] + point;
+        std::vector<unsigned char> buffer(GroupElement::serialize_size);
+        projective.serialize(buffer.data());
+        GroupElement parsed;
+        parsed.deserialize(buffer.data());
+        BOOST_CHECK_EQUAL(parsed, projective);
+        BOOST_CHECK_EQUAL(parsed, reference_multiply(point, scalars[i] + Scalar(uint64_t(1))));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(affine_cache)
+{
+    GroupElement a, b;
+    a.randomize();
+    b.randomize();
+
+    // The same point reached with different z coordinates
+    GroupElement sum = a + b;
+    GroupElement other_sum = b;
+    other_sum.square();
+    other_sum += a;
+    other_sum += b.inverse();
+    BOOST_CHECK_EQUAL(sum, other_sum);
+    BOOST_CHECK_NE(sum, sum + a);
+    BOOST_CHECK_EQUAL(sum.get_hash(), other_sum.get_hash());
+    BOOST_CHECK_EQUAL(sum.hash(), other_sum.hash());
+
+    // Comparing with a side whose affine form is cached, then both
+    std::vector<unsigned char> buffer(GroupElement::serialize_size);
+    sum.serialize(buffer.data());
+    BOOST_CHECK_EQUAL(sum, other_sum);
+    BOOST_CHECK_EQUAL(other_sum, sum);
+    BOOST_CHECK_NE(sum, a);
+    other_sum.serialize(buffer.data());
+    BOOST_CHECK_EQUAL(sum, other_sum);
+    BOOST_CHECK_NE(sum, b);
+
+    // Mutation drops the cached form, and copies keep it only until they change
+    GroupElement copy = sum;
+    copy += a;
+    BOOST_CHECK_EQUAL(copy, a + b + a);
+    BOOST_CHECK(copy.getvch() != sum.getvch());
+    GroupElement parsed;
+    parsed.deserialize(copy.getvch().data());
+    BOOST_CHECK_EQUAL(parsed, copy);
+    parsed *= Scalar(uint64_t(2));
+    copy.square();
+    BOOST_CHECK_EQUAL(parsed, copy);
+    BOOST_CHECK(parsed.getvch() == copy.getvch());
+    BOOST_CHECK_EQUAL(parsed.GetHex(), copy.GetHex());
+
+    // Infinity
+    GroupElement infinity = a + a.inverse();
+    BOOST_CHECK_EQUAL(infinity, GroupElement());
+    BOOST_CHECK_NE(infinity, a);
+    BOOST_CHECK(infinity.isMember());
+    parsed.deserialize(infinity.getvch().data());
+    BOOST_CHECK(parsed.isInfinity());
+    BOOST_CHECK_EQUAL(parsed, infinity);
+
+    // Batch affine encoding agrees with single points, cached or not
+    std::vector<GroupElement> points = { sum, a + b + a, infinity, other_sum };
+    std::vector<unsigned char> batch(points.size() * GroupElement::affine_size);
+    GroupElement::serialize_affine(points, batch.data());
+    for (std::size_t i = 0; i < points.size(); i++) {
+        std::vector<unsigned char> single(GroupElement::affine_size);
+        points[i].serialize_affine(single.data());
+        BOOST_CHECK(std::equal(single.begin(), single.end(), batch.begin() + i * GroupElement::affine_size));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(mixed_addition)
+{
+    // Points with and without a known affine form, reached in two ways each
+    GroupElement a, b;
+    a.randomize();
+    b.randomize();
+    GroupElement a_jacobian = a*Scalar(uint64_t(3)) + a.inverse()*Scalar(uint64_t(2));
+    GroupElement b_jacobian = b*Scalar(uint64_t(3)) + b.inverse()*Scalar(uint64_t(2));
+    GroupElement expected = reference_multiply(a, Scalar(uint64_t(1))) + reference_multiply(b, Scalar(uint64_t(1)));
+
+    for (const GroupElement& left : { a, a_jacobian }) {
+        for (const GroupElement& right : { b, b_jacobian }) {
+            BOOST_CHECK_EQUAL(left + right, expected);
+            GroupElement sum = left;
+            sum += right;
+            BOOST_CHECK_EQUAL(sum, expected);
+        }
+
+        // Doubling, cancellation and infinity on either side
+        GroupElement doubled = left;
+        doubled += a;
+        BOOST_CHECK_EQUAL(doubled, a*Scalar(uint64_t(2)));
+        BOOST_CHECK((left + a.inverse()).isInfinity());
+        BOOST_CHECK((left.inverse() + a).isInfinity());
+        BOOST_CHECK_EQUAL(left + GroupElement(), a);
+        BOOST_CHECK_EQUAL(GroupElement() + left, a);
+    }
+
+    // Multiexponentiation ingests both kinds, and affine encodings, alike
+    for (std::size_t size : {1, 2, 17, 200}) {
+        std::vector<GroupElement> points(size);
+        std::vector<Scalar> scalars(size);
+        GroupElement expected_multiple;
+        for (std::size_t i = 0; i < size; i++) {
+            points[i].randomize();
+            if (i % 2 == 1) {
+                points[i] = points[i] + points[i - 1];
+            }
+            if (i % 7 == 3) {
+                points[i] = GroupElement();
+            }
+            scalars[i].randomize();
+            expected_multiple += reference_multiply(points[i], scalars[i]);
+        }
+        MultiExponent multiexponent(points, scalars);
+        BOOST_CHECK_EQUAL(multiexponent.get_multiple(), expected_multiple);
+
+        std::vector<unsigned char> encodings(size * GroupElement::affine_size);
+        GroupElement::serialize_affine(points, encodings.data());
+        MultiExponent from_encodings(encodings.data(), scalars);
+        BOOST_CHECK_EQUAL(from_encodings.get_multiple(), expected_multiple);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(lazy_decompression)
+{
+    const std::size_t n = 300;
+
+    std::vector<GroupElement> points(n);
+    CDataStream serialized(SER_NETWORK, PROTOCOL_VERSION);
+    for (std::size_t i = 0; i < n; i++) {
+        points[i].randomize();
+    }
+    serialized << points;
+
+    // Deserialize without decompressing anything
+    std::vector<GroupElement> deserialized;
+    {
+        GroupElement::LazyDeserialization lazy;
+        serialized >> deserialized;
+    }
+    BOOST_CHECK_EQUAL(deserialized.size(), n);
+    BOOST_CHECK(!deserialized[0].isDecompressed());
+
+    // Copies stay compressed, and first use decompresses
+    GroupElement copy = deserialized[0];
+    BOOST_CHECK(!copy.isDecompressed());
+    BOOST_CHECK(copy == points[0]);
+    BOOST_CHECK(copy.isDecompressed());
+
+    // Decompress the rest in parallel
+    std::vector<GroupElement*> pointers;
+    for (GroupElement& point : deserialized) {
+        pointers.emplace_back(&point);
+    }
+    ThreadPool pool(4);
+    GroupElement::decompress_all(pointers, pool);
+    for (std::size_t i = 0; i < n; i++) {
+        BOOST_CHECK(deserialized[i].isDecompressed());
+        BOOST_CHECK(deserialized[i] == points[i]);
+    }
+
+    unsigned char bad_point[GroupElement::serialize_size];
+    off_curve_point(bad_point);
+
+    // The lowest invalid index is reported no matter how the work is split
+    unsigned char good_point[GroupElement::serialize_size];
+    points[0].serialize(good_point);
+    for (std::size_t threads : { 1, 2, 5 }) {
+        for (std::size_t i = 0; i < n; i++) {
+            deserialized[i].deserialize_lazy(i == 77 || i == 250 ? bad_point : good_point);
+        }
+        ThreadPool executor(threads);
+        try {
+            GroupElement::decompress_all(pointers, executor);
+            BOOST_FAIL("Invalid point was not detected");
+        } catch (const std::invalid_argument& e) {
+            BOOST_CHECK_EQUAL(std::string(e.what()), "GroupElement: deserialize failed at index 77");
+        }
+        BOOST_CHECK_THROW(deserialized[250].isMember(), std::invalid_argument);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
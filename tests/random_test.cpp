@@ -0,0 +1,135 @@
+#include "../src/util.h"
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace spark {
+
+using namespace secp_primitives;
+
+class SparkTest {};
+
+BOOST_FIXTURE_TEST_SUITE(spark_random_tests, SparkTest)
+
+BOOST_AUTO_TEST_CASE(keystream)
+{
+    // With an all-zero key, output starts after the 32 bytes of the first ChaCha20 block (RFC 8439 A.1) kept as the next key
+    const unsigned char key[32] = { 0 };
+    const unsigned char expected[32] = {
+        0xda, 0x41, 0x59, 0x7c, 0x51, 0x57, 0x48, 0x8d, 0x77, 0x24, 0xe0, 0x3f, 0xb8, 0xd8, 0x4a, 0x37,
+        0x6a, 0x43, 0xb8, 0xf4, 0x15, 0x18, 0xa1, 0x1c, 0xc3, 0x87, 0xb6, 0x69, 0xb2, 0xee, 0x65, 0x86
+    };
+    RandomGenerator generator(key);
+    unsigned char output[32];
+    generator.fill(output, sizeof(output));
+    BOOST_CHECK(std::equal(output, output + sizeof(output), expected));
+
+    // Output does not depend on how requests are split, including across blocks
+    RandomGenerator whole(key), pieces(key);
+    std::vector<unsigned char> expected_stream(2000), stream(2000);
+    whole.fill(expected_stream.data(), expected_stream.size());
+    std::size_t offset = 0;
+    for (std::size_t size = 1; offset < stream.size(); size = size * 3 + 1) {
+        std::size_t count = std::min(size, stream.size() - offset);
+        pieces.fill(stream.data() + offset, count);
+        offset += count;
+    }
+    BOOST_CHECK(stream == expected_stream);
+}
+
+BOOST_AUTO_TEST_CASE(scalars)
+{
+    const unsigned char key[32] = { 1 };
+    RandomGenerator generator(key), other(key);
+
+    std::vector<Scalar> scalars(100);
+    generator.randomize(scalars);
+    for (std::size_t i = 0; i < scalars.size(); i++) {
+        BOOST_CHECK(scalars[i].isMember());
+        BOOST_CHECK(!scalars[i].isZero());
+        for (std::size_t j = 0; j < i; j++) {
+            BOOST_CHECK_NE(scalars[i], scalars[j]);
+        }
+    }
+
+    // Bulk and single draws agree
+    for (std::size_t i = 0; i < scalars.size(); i++) {
+        Scalar single;
+        other.randomize(&single, 1);
+        BOOST_CHECK_EQUAL(single, scalars[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(threads)
+{
+    // Every thread is seeded separately
+    Scalar first, second;
+    std::thread([&] { first.randomize(); }).join();
+    std::thread([&] { second.randomize(); }).join();
+    BOOST_CHECK_NE(first, second);
+
+    // Reseeding keeps the output going past the interval
+    std::vector<unsigned char> bytes(RandomGenerator::reseed_interval + 1000);
+    RandomGenerator::get().fill(bytes.data(), bytes.size());
+    Scalar after;
+    after.randomize();
+    BOOST_CHECK(after.isMember());
+}
+
+BOOST_AUTO_TEST_CASE(fork)
+{
+    // Leave most of a block buffered, which the child must not hand out as well
+    RandomGenerator& generator = RandomGenerator::get();
+    unsigned char first[16];
+    generator.fill(first, sizeof(first));
+
+    int fds[2];
+    BOOST_REQUIRE_EQUAL(pipe(fds), 0);
+    pid_t pid = ::fork();
+    BOOST_REQUIRE(pid >= 0);
+    if (pid == 0) {
+        unsigned char child[64];
+        RandomGenerator::get().fill(child, sizeof(child));
+        ssize_t written = write(fds[1], child, sizeof(child));
+        _exit(written == static_cast<ssize_t>(sizeof(child)) ? 0 : 1);
+    }
+
+    unsigned char parent[64], child[64];
+    generator.fill(parent, sizeof(parent));
+    close(fds[1]);
+    std::size_t received = 0;
+    while (received < sizeof(child)) {
+        ssize_t count = read(fds[0], child + received, sizeof(child) - received);
+        if (count <= 0) {
+            break;
+        }
+        received += count;
+    }
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    BOOST_REQUIRE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    BOOST_REQUIRE_EQUAL(received, sizeof(child));
+    BOOST_CHECK(!std::equal(parent, parent + sizeof(parent), child));
+    BOOST_CHECK(!std::equal(parent, parent + 32, child + 32));
+}
+
+BOOST_AUTO_TEST_CASE(system_randomness)
+{
+    Scalar first, second;
+    RandomGenerator::randomize_from_system(first);
+    RandomGenerator::randomize_from_system(second);
+    BOOST_CHECK(first.isMember());
+    BOOST_CHECK_NE(first, second);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
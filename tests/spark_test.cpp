@@ -18,6 +18,40 @@ namespace spark {
 
 class SparkTest {};
 
+// The selection made by sorting a copy of the coins and scanning it, which the coin index must reproduce
+static std::vector<CSparkMintMeta> reference_selection(CAmount required, std::list<CSparkMintMeta> coins)
+{
+    coins.sort([](const CSparkMintMeta& a, const CSparkMintMeta& b) -> bool {
+        return a.v != b.v ? a.v > b.v : a.nHeight < b.nHeight;
+    });
+
+    CAmount spend_val(0);
+    std::vector<CSparkMintMeta> result;
+    while (spend_val < required && !coins.empty()) {
+        CAmount need = required - spend_val;
+        auto choosen = coins.begin();
+        if ((uint64_t)need < choosen->v) {
+            for (auto it = coins.begin(); it != coins.end(); it++) {
+                if (it->v >= (uint64_t)need)
+                    choosen = it;
+                else
+                    break;
+            }
+            // Oldest coin of the chosen value
+            while (choosen != coins.begin() && std::prev(choosen)->v == choosen->v)
+                choosen--;
+        }
+        spend_val += choosen->v;
+        result.emplace_back(*choosen);
+        coins.erase(choosen);
+    }
+
+    std::stable_sort(result.begin(), result.end(), [](const CSparkMintMeta& a, const CSparkMintMeta& b) -> bool {
+        return a.nId < b.nId;
+    });
+    return result;
+}
+
 BOOST_FIXTURE_TEST_SUITE(spark_test, SparkTest)
 
 BOOST_AUTO_TEST_CASE(mintCoinTest)
@@ -37,9 +71,23 @@ BOOST_AUTO_TEST_CASE(mintCoinTest)
         outputs.push_back(output);
     }
 
-    std::vector<CRecipient>  recipients = createSparkMintRecipients(outputs, random_char_vector(), true);
+    const std::vector<unsigned char> serial_context = random_char_vector();
+    std::vector<CRecipient>  recipients = createSparkMintRecipients(outputs, serial_context, true);
     BOOST_CHECK_EQUAL(recipients.size(), 3);
 
+    // Parsing in place must agree with full deserialization
+    for (const auto& recipient : recipients) {
+        spark::Coin parsed(params);
+        ParseSparkMintCoin(recipient.pubKey, parsed);
+        spark::CoinView view = ParseSparkMintCoinView(recipient.pubKey, params);
+        BOOST_CHECK(view.to_coin(serial_context) == parsed);
+        BOOST_CHECK_EQUAL(view.get_v(), parsed.v);
+
+        spark::IdentifiedCoinData data;
+        BOOST_CHECK(view.identify(incoming_view_key, serial_context, data));
+        BOOST_CHECK_EQUAL(data.i, i);
+    }
+
     const uint64_t v = 1;
     std::list<CSparkMintMeta> coins;
     spark::Coin coin(params, 0, (Scalar().randomize()), address, v, "Test memo", random_char_vector());
@@ -53,6 +101,60 @@ BOOST_AUTO_TEST_CASE(mintCoinTest)
     BOOST_CHECK_EQUAL(r.second.size(), 1);
 }
 
+BOOST_AUTO_TEST_CASE(coin_selection)
+{
+    // Few distinct values and heights, so that ties are common
+    std::list<CSparkMintMeta> coins;
+    for (std::size_t i = 0; i < 200; i++) {
+        CSparkMintMeta mint;
+        mint.v = 10000 * (1 + std::rand() % 20);
+        mint.nHeight = std::rand() % 5;
+        mint.nId = std::rand() % 3;
+        mint.isUsed = false;
+        mint.k.randomize();
+        coins.push_back(mint);
+    }
+
+    SparkCoinSelector selector(coins);
+    BOOST_CHECK_EQUAL(selector.size(), coins.size());
+
+    for (CAmount required = 1; required <= (CAmount)selector.balance(); required += 1 + std::rand() % 50000) {
+        std::vector<CSparkMintMeta> expected = reference_selection(required, coins);
+
+        std::vector<CSparkMintMeta> selected;
+        int64_t changeToMint;
+        BOOST_CHECK(selector.get_coins_to_spend(required, selected, changeToMint));
+        BOOST_REQUIRE_EQUAL(selected.size(), expected.size());
+
+        CAmount spend_val = 0;
+        for (std::size_t j = 0; j < selected.size(); j++) {
+            BOOST_CHECK(selected[j] == expected[j]);
+            spend_val += selected[j].v;
+        }
+        BOOST_CHECK_EQUAL(changeToMint, spend_val - required);
+    }
+    BOOST_CHECK_THROW(SelectSparkCoins(selector.balance() + 1, true, selector, 1), std::runtime_error);
+
+    // The index follows coins being spent
+    std::vector<CSparkMintMeta> selected;
+    int64_t changeToMint;
+    selector.get_coins_to_spend(100000, selected, changeToMint);
+    for (const CSparkMintMeta& coin : selected) {
+        BOOST_CHECK(selector.remove(coin));
+        BOOST_CHECK(!selector.remove(coin));
+        coins.remove(coin);
+    }
+    BOOST_CHECK_EQUAL(selector.size(), coins.size());
+
+    std::pair<CAmount, std::vector<CSparkMintMeta>> indexed = SelectSparkCoins(1000000, false, selector, 2);
+    std::pair<CAmount, std::vector<CSparkMintMeta>> listed = SelectSparkCoins(1000000, false, coins, 2);
+    BOOST_CHECK_EQUAL(indexed.first, listed.first);
+    BOOST_REQUIRE_EQUAL(indexed.second.size(), listed.second.size());
+    for (std::size_t j = 0; j < indexed.second.size(); j++) {
+        BOOST_CHECK(indexed.second[j] == listed.second[j]);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
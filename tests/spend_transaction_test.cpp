@@ -1,4 +1,7 @@
 #include "../src/spend_transaction.h"
+#include "../src/input_proof_cache.h"
+#include "../src/coin_selector.h"
+#include "test_points.h"
 
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MAIN
@@ -20,88 +23,117 @@ static std::vector<unsigned char> random_char_vector() {
     return result;
 }
 
-class SparkTest {};
+// Keys, coins and outputs for a balanced spend of three coins from `sets` cover sets into `t` outputs
+class SpendFixture {
+public:
+    SpendFixture(const std::size_t sets = 1, const std::size_t t_ = 3)
+            : params(Params::get_test())
+            , spend_key(params)
+            , full_view_key(spend_key)
+            , incoming_view_key(full_view_key)
+            , address(incoming_view_key, 12345)
+            , t(t_)
+            , f(0)
+    {
+        const std::string memo = "Spam and eggs"; // arbitrary memo
 
-BOOST_FIXTURE_TEST_SUITE(spark_spend_transaction_tests, SparkTest)
+        // Mint some coins to the address
+        std::size_t N = (std::size_t) pow(params->get_n_grootle(), params->get_m_grootle());
+        for (std::size_t i = 0; i < N; i++) {
+            Scalar k;
+            k.randomize();
 
-BOOST_AUTO_TEST_CASE(generate_verify)
-{
-    // Parameters
-    const Params* params;
-    params = Params::get_test();
+            uint64_t v = 123 + i; // arbitrary value
 
-    const std::string memo = "Spam and eggs"; // arbitrary memo
+            in_coins.emplace_back(Coin(
+                params,
+                COIN_TYPE_MINT,
+                k,
+                address,
+                v,
+                memo,
+                random_char_vector()
+            ));
+        }
 
-    // Generate keys
-    SpendKey spend_key(params);
-    FullViewKey full_view_key(spend_key);
-    IncomingViewKey incoming_view_key(full_view_key);
+        // Every set holds the same coins under its own representation
+        for (std::size_t j = 0; j < sets; j++) {
+            CoverSetData setData;
+            setData.cover_set = in_coins;
+            setData.cover_set_representation = random_char_vector();
+            cover_set_data[31415 + j] = setData;
+            cover_sets[31415 + j] = in_coins;
+        }
 
-    // Generate address
-    const uint64_t i = 12345;
-    Address address(incoming_view_key, i);
+        // Choose coins to spend, recover them, and prepare them for spending
+        std::vector<std::size_t> spend_indices = { 1, 3, 5 };
+        w = spend_indices.size();
+        for (std::size_t u = 0; u < w; u++) {
+            IdentifiedCoinData identified_coin_data = in_coins[spend_indices[u]].identify(incoming_view_key);
+            RecoveredCoinData recovered_coin_data = in_coins[spend_indices[u]].recover(full_view_key, identified_coin_data);
 
-    // Mint some coins to the address
-    std::size_t N = (std::size_t) pow(params->get_n_grootle(), params->get_m_grootle());
-    std::vector<Coin> in_coins;
-    for (std::size_t i = 0; i < N; i++) {
-        Scalar k;
-        k.randomize();
+            spend_coin_data.emplace_back();
+            spend_coin_data.back().cover_set_id = 31415 + u % sets;
+            spend_coin_data.back().index = spend_indices[u];
+            spend_coin_data.back().k = identified_coin_data.k;
+            spend_coin_data.back().s = recovered_coin_data.s;
+            spend_coin_data.back().T = recovered_coin_data.T;
+            spend_coin_data.back().v = identified_coin_data.v;
 
-        uint64_t v = 123 + i; // arbitrary value
+            f += identified_coin_data.v;
+        }
 
-        in_coins.emplace_back(Coin(
-            params,
-            COIN_TYPE_MINT,
-            k,
-            address,
-            v,
-            memo,
-            random_char_vector()
-        ));
-    }
+        // Generate new output coins and compute the fee
+        for (std::size_t j = 0; j < t; j++) {
+            out_coin_data.emplace_back();
+            out_coin_data.back().address = address;
+            out_coin_data.back().v = 12 + j; // arbitrary value
+            out_coin_data.back().memo = memo;
 
-    // Track values so we can set the fee to make the transaction balance
-    uint64_t f = 0;
+            f -= out_coin_data.back().v;
+        }
+    }
 
-    // Choose coins to spend, recover them, and prepare them for spending
-    std::vector<std::size_t> spend_indices = { 1, 3, 5 };
-    std::vector<InputCoinData> spend_coin_data;
-    std::unordered_map<uint64_t, CoverSetData> cover_set_data;
-    const std::size_t w = spend_indices.size();
-    for (std::size_t u = 0; u < w; u++) {
-        IdentifiedCoinData identified_coin_data = in_coins[spend_indices[u]].identify(incoming_view_key);
-        RecoveredCoinData recovered_coin_data = in_coins[spend_indices[u]].recover(full_view_key, identified_coin_data);
-
-        spend_coin_data.emplace_back();
-        uint64_t cover_set_id = 31415;
-        spend_coin_data.back().cover_set_id = cover_set_id;
-
-        CoverSetData setData;
-        setData.cover_set = in_coins;
-        setData.cover_set_representation = random_char_vector();
-        cover_set_data[cover_set_id] = setData;
-        spend_coin_data.back().index = spend_indices[u];
-        spend_coin_data.back().k = identified_coin_data.k;
-        spend_coin_data.back().s = recovered_coin_data.s;
-        spend_coin_data.back().T = recovered_coin_data.T;
-        spend_coin_data.back().v = identified_coin_data.v;
-
-        f += identified_coin_data.v;
+    SpendTransaction generate() const {
+        SpendTransaction transaction(
+            params,
+            full_view_key,
+            spend_key,
+            spend_coin_data,
+            cover_set_data,
+            f,
+            0,
+            out_coin_data
+        );
+        transaction.setCoverSets(cover_set_data);
+        return transaction;
     }
 
-    // Generate new output coins and compute the fee
-    const std::size_t t = 3;
+    const Params* params;
+    SpendKey spend_key;
+    FullViewKey full_view_key;
+    IncomingViewKey incoming_view_key;
+    Address address;
+    std::vector<Coin> in_coins;
+    std::unordered_map<uint64_t, CoverSetData> cover_set_data;
+    std::unordered_map<uint64_t, std::vector<Coin>> cover_sets;
+    std::vector<InputCoinData> spend_coin_data;
     std::vector<OutputCoinData> out_coin_data;
-    for (std::size_t j = 0; j < t; j++) {
-        out_coin_data.emplace_back();
-        out_coin_data.back().address = address;
-        out_coin_data.back().v = 12 + j; // arbitrary value
-        out_coin_data.back().memo = memo;
+    std::size_t w; // number of consumed coins
+    std::size_t t; // number of generated coins
+    uint64_t f; // fee
+};
 
-        f -= out_coin_data.back().v;
-    }
+// Distinct numbers of sets and outputs, so that sizes depending on one cannot pass for the other
+class TwoSetSpendFixture : public SpendFixture {
+public:
+    TwoSetSpendFixture() : SpendFixture(2, 4) {}
+};
 
+BOOST_FIXTURE_TEST_SUITE(spark_spend_transaction_tests, SpendFixture)
+
+BOOST_AUTO_TEST_CASE(generate_verify)
+{
     // Assert the fee is correct
     uint64_t fee_test = f;
     for (std::size_t j = 0; j < t; j++) {
@@ -129,12 +161,245 @@ BOOST_AUTO_TEST_CASE(generate_verify)
 
     // Verify
     transaction.setCoverSets(cover_set_data);
-    std::unordered_map<uint64_t, std::vector<Coin>> cover_sets;
-    for (const auto set_data : cover_set_data)
-        cover_sets[set_data.first] = set_data.second.cover_set;
     BOOST_CHECK(SpendTransaction::verify(transaction, cover_sets));
 }
 
+BOOST_AUTO_TEST_CASE(verify_instrumentation)
+{
+    SpendTransaction transaction = generate();
+    instrumentation::reset();
+    BOOST_CHECK(SpendTransaction::verify(transaction, cover_sets));
+
+    // Instrumented builds see every verification stage; otherwise nothing is counted.
+    // ./build also builds this suite instrumented, and run_all_tests runs this case from it
+    instrumentation::Snapshot snapshot = instrumentation::snapshot();
+    if (instrumentation::enabled()) {
+        BOOST_CHECK_EQUAL(snapshot.stages[instrumentation::SPEND_VERIFY].calls, 1);
+        BOOST_CHECK_EQUAL(snapshot.stages[instrumentation::SPEND_VERIFY_CHAUM].calls, 1);
+        BOOST_CHECK_EQUAL(snapshot.stages[instrumentation::SPEND_VERIFY_BALANCE].calls, 1);
+        BOOST_CHECK_EQUAL(snapshot.stages[instrumentation::SPEND_VERIFY_RANGE].calls, 1);
+        BOOST_CHECK_EQUAL(snapshot.stages[instrumentation::SPEND_VERIFY_MEMBERSHIP].calls, 1);
+        BOOST_CHECK(snapshot.stages[instrumentation::GROOTLE_VERIFY].calls >= 1);
+        BOOST_CHECK(snapshot.counters[instrumentation::HASH_BYTES] > 0);
+        BOOST_CHECK(snapshot.estimated_hash_compressions() > snapshot.counters[instrumentation::HASH_FINALIZATIONS]);
+    } else {
+        for (std::size_t i = 0; i < instrumentation::STAGE_COUNT; i++) {
+            BOOST_CHECK_EQUAL(snapshot.stages[i].calls, 0);
+        }
+        BOOST_CHECK_EQUAL(snapshot.counters[instrumentation::HASH_BYTES], 0);
+    }
+    BOOST_CHECK_EQUAL(std::string(instrumentation::name(instrumentation::SPEND_VERIFY_MEMBERSHIP)), "spend_verify_membership");
+}
+
+BOOST_AUTO_TEST_CASE(serialized_size)
+{
+    SpendTransaction transaction = generate();
+
+    // The serialized size is known in advance
+    CDataStream serialized(SER_NETWORK, PROTOCOL_VERSION);
+    serialized << transaction;
+    BOOST_CHECK_EQUAL(serialized.size(), SpendTransaction::estimate_serialized_size(params, w, t, 0));
+
+    std::map<uint64_t, uint256> block_hashes;
+    block_hashes[31415] = uint256();
+    transaction.setBlockHashes(block_hashes);
+    serialized.clear();
+    serialized << transaction;
+    BOOST_CHECK_EQUAL(serialized.size(), SpendTransaction::estimate_serialized_size(params, w, t, 1));
+
+    for (const Coin& coin : transaction.getOutCoins()) {
+        serialized.clear();
+        serialized << coin;
+        BOOST_CHECK_EQUAL(serialized.size(), Coin::serializedSize(params, COIN_TYPE_SPEND));
+    }
+    serialized.clear();
+    serialized << in_coins[0];
+    BOOST_CHECK_EQUAL(serialized.size(), Coin::serializedSize(params, COIN_TYPE_MINT));
+}
+
+BOOST_FIXTURE_TEST_CASE(transaction_size, TwoSetSpendFixture)
+{
+    SpendTransaction transaction = generate();
+    std::map<uint64_t, uint256> block_hashes;
+    for (const auto& set_data : cover_set_data) {
+        block_hashes[set_data.first] = uint256();
+    }
+    transaction.setBlockHashes(block_hashes);
+
+    CDataStream serialized(SER_NETWORK, PROTOCOL_VERSION);
+    serialized << transaction;
+    BOOST_CHECK_EQUAL(serialized.size(), SpendTransaction::estimate_serialized_size(params, w, t, cover_set_data.size()));
+
+    // The spend, and each output as a value and an OP_SPARKSMINT script holding the coin
+    std::size_t size = 144 + GetSizeOfCompactSize(serialized.size()) + serialized.size();
+    for (const Coin& coin : transaction.getOutCoins()) {
+        serialized.clear();
+        serialized << coin;
+        std::size_t script = 1 + serialized.size();
+        size += sizeof(CAmount) + GetSizeOfCompactSize(script) + script;
+    }
+    BOOST_CHECK_EQUAL(SparkCoinSelector::estimate_transaction_size(params, w, cover_set_data.size(), t), size);
+}
+
+BOOST_AUTO_TEST_CASE(deserialize)
+{
+    SpendTransaction transaction = generate();
+
+    // A deserialized spend has its points decompressed together
+    CDataStream serialized(SER_NETWORK, PROTOCOL_VERSION);
+    serialized << transaction;
+    std::vector<unsigned char> serialized_bytes(serialized.begin(), serialized.end());
+    SpendTransaction deserialized(params);
+    serialized >> deserialized;
+    deserialized.setCoverSets(cover_set_data);
+    deserialized.setOutCoins(transaction.getOutCoins());
+    deserialized.setVout(0);
+    BOOST_CHECK(deserialized.getUsedLTags()[0].isDecompressed());
+    BOOST_CHECK(SpendTransaction::verify(deserialized, cover_sets));
+
+    // An invalid tag is still rejected while reading
+    unsigned char tag[GroupElement::serialize_size];
+    transaction.getUsedLTags()[0].serialize(tag);
+    auto tag_position = std::search(serialized_bytes.begin(), serialized_bytes.end(), tag, tag + GroupElement::serialize_size);
+    BOOST_REQUIRE(tag_position != serialized_bytes.end());
+    off_curve_point(&*tag_position);
+    CDataStream evil_serialized(serialized_bytes, SER_NETWORK, PROTOCOL_VERSION);
+    SpendTransaction evil_transaction(params);
+    BOOST_CHECK_THROW(evil_serialized >> evil_transaction, std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(cover_set_types)
+{
+    // The same spend can be generated and verified using compact cover sets
+    std::unordered_map<uint64_t, CompactCoverSetData> compact_cover_set_data;
+    std::unordered_map<uint64_t, CoverSet> compact_cover_sets;
+    for (const auto& set_data : cover_set_data) {
+        CompactCoverSetData& compact_data = compact_cover_set_data[set_data.first];
+        compact_data.cover_set = CoverSet(set_data.second.cover_set);
+        compact_data.cover_set_representation = set_data.second.cover_set_representation;
+        compact_cover_sets[set_data.first] = compact_data.cover_set;
+    }
+    SpendTransaction compact_transaction(
+        params,
+        full_view_key,
+        spend_key,
+        spend_coin_data,
+        compact_cover_set_data,
+        f,
+        0,
+        out_coin_data
+    );
+    compact_transaction.setCoverSets(compact_cover_set_data);
+    BOOST_CHECK(SpendTransaction::verify(compact_transaction, compact_cover_sets));
+    BOOST_CHECK(SpendTransaction::verify(compact_transaction, cover_sets));
+    BOOST_CHECK(SpendTransaction::verify(generate(), compact_cover_sets));
+
+    // And using a shared store
+    CoverSetStore store;
+    for (const auto& set_data : cover_set_data) {
+        CoverSetData data = set_data.second;
+        store.add(set_data.first, std::move(data));
+    }
+    SpendTransaction store_transaction(
+        params,
+        full_view_key,
+        spend_key,
+        spend_coin_data,
+        store,
+        f,
+        0,
+        out_coin_data
+    );
+    store_transaction.setCoverSets(store);
+    BOOST_CHECK(SpendTransaction::verify(store_transaction, store));
+    BOOST_CHECK(SpendTransaction::verify(store_transaction, cover_sets));
+
+    // And reading the cover sets in small chunks, with inputs sharing a reader proven concurrently
+    ThreadPool pool(4);
+    std::unordered_map<uint64_t, StreamingCoverSetData> streaming_cover_set_data;
+    for (const auto& set_data : compact_cover_set_data) {
+        StreamingCoverSetData& streaming_data = streaming_cover_set_data[set_data.first];
+        streaming_data.reader = std::make_shared<CoverSetMemoryReader>(compact_cover_sets.at(set_data.first));
+        streaming_data.cover_set_representation = set_data.second.cover_set_representation;
+        streaming_data.memory_limit = 1 << 12;
+    }
+    SpendTransaction streaming_transaction(
+        params,
+        full_view_key,
+        spend_key,
+        spend_coin_data,
+        streaming_cover_set_data,
+        f,
+        0,
+        out_coin_data,
+        pool
+    );
+    streaming_transaction.setCoverSets(streaming_cover_set_data);
+    BOOST_CHECK(SpendTransaction::verify(streaming_transaction, cover_sets));
+    BOOST_CHECK(SpendTransaction::verify(streaming_transaction, compact_cover_sets));
+}
+
+BOOST_AUTO_TEST_CASE(executor)
+{
+    // The inputs and range proof are generated concurrently
+    ThreadPool pool(4);
+    SpendTransaction parallel_transaction(
+        params,
+        full_view_key,
+        spend_key,
+        spend_coin_data,
+        cover_set_data,
+        f,
+        0,
+        out_coin_data,
+        pool
+    );
+    parallel_transaction.setCoverSets(cover_set_data);
+    BOOST_CHECK(SpendTransaction::verify(parallel_transaction, cover_sets));
+    BOOST_CHECK(SpendTransaction::verify(params, {parallel_transaction}, cover_sets, pool));
+}
+
+BOOST_AUTO_TEST_CASE(staged)
+{
+    // Build the spend from input proofs generated in advance
+    InputProofCache cache(params);
+    std::vector<InputProof> input_proofs;
+    for (const InputCoinData& input : spend_coin_data) {
+        input_proofs.emplace_back(cache.get(full_view_key, input, cover_set_data.at(input.cover_set_id)));
+    }
+    BOOST_CHECK_EQUAL(cache.size(), w);
+    SpendTransaction staged_transaction(
+        params,
+        full_view_key,
+        spend_key,
+        spend_coin_data,
+        input_proofs,
+        f,
+        0,
+        out_coin_data
+    );
+    staged_transaction.setCoverSets(cover_set_data);
+    BOOST_CHECK(SpendTransaction::verify(staged_transaction, cover_sets));
+
+    // Cached proofs are reused until the representation of their set changes
+    InputProof cached = cache.get(full_view_key, spend_coin_data[0], cover_set_data.at(spend_coin_data[0].cover_set_id));
+    BOOST_CHECK(cached.proof.A == input_proofs[0].proof.A);
+
+    CoverSetData changed_data = cover_set_data.at(spend_coin_data[0].cover_set_id);
+    changed_data.cover_set_representation = random_char_vector();
+    InputProof proof;
+    BOOST_CHECK(!cache.find(spend_coin_data[0], changed_data.cover_set_representation, proof));
+    BOOST_CHECK_EQUAL(cache.size(), w - 1);
+    BOOST_CHECK(!(cache.get(full_view_key, spend_coin_data[0], changed_data).proof.A == input_proofs[0].proof.A));
+
+    cache.invalidate(spend_coin_data[0].cover_set_id);
+    BOOST_CHECK_EQUAL(cache.size(), 0);
+
+    // Proofs must match their inputs
+    std::swap(input_proofs[0], input_proofs[1]);
+    BOOST_CHECK_THROW(SpendTransaction(params, full_view_key, spend_key, spend_coin_data, input_proofs, f, 0, out_coin_data), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
@@ -0,0 +1,26 @@
+#ifndef FIRO_SPARK_TEST_POINTS_H
+#define FIRO_SPARK_TEST_POINTS_H
+#include "../secp256k1/include/GroupElement.h"
+
+#include <stdexcept>
+
+namespace spark {
+
+using namespace secp_primitives;
+
+// Write the encoding of an x-coordinate that is not on the curve
+inline void off_curve_point(unsigned char* buffer) {
+    std::fill(buffer, buffer + GroupElement::serialize_size, 0);
+    for (unsigned char x = 1; ; x++) {
+        buffer[31] = x;
+        try {
+            GroupElement().deserialize(buffer);
+        } catch (const std::invalid_argument&) {
+            return;
+        }
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,54 @@
+// Writes src/generator_tables_data.cpp, the embedded generators read by GeneratorTables, to standard output.
+// It only needs the hash-to-curve from util.cpp and is linked without the tables it writes, so a stale or broken
+// data file cannot stop it from building; ./build compares its output with the tracked file.
+
+#include "../src/generator_tables.h"
+
+#include <cstdio>
+
+using namespace spark;
+
+static void write_entries(const char* name, const char* dimension, const std::vector<GroupElement>& generators) {
+    std::vector<unsigned char> encodings(generators.size()*GroupElement::affine_size);
+    GroupElement::serialize_affine(generators, encodings.data());
+
+    std::printf("\nconst unsigned char GeneratorTables::%s%s[GroupElement::affine_size] = {\n", name, dimension);
+    for (std::size_t i = 0; i < generators.size(); i++) {
+        const unsigned char* encoding = encodings.data() + i*GroupElement::affine_size;
+        if (dimension[0]) {
+            std::printf("    { // %zu\n", i);
+        }
+        for (std::size_t j = 0; j < GroupElement::affine_size; j++) {
+            std::printf("%s0x%02x%s", j % 16 == 0 ? (dimension[0] ? "        " : "    ") : " ", encoding[j], j % 16 == 15 ? ",\n" : ",");
+        }
+        if (dimension[0]) {
+            std::printf("    },\n");
+        }
+    }
+    std::printf("};\n");
+}
+
+static void write_vector(const char* name, const char* dimension, const std::string& label, const std::size_t size) {
+    std::vector<GroupElement> generators;
+    for (std::size_t i = 0; i < size; i++) {
+        generators.emplace_back(SparkUtils::hash_generator(label + " " + std::to_string(i)));
+    }
+    write_entries(name, dimension, generators);
+}
+
+int main() {
+    std::printf("// Generated by tools/generator_tables.cpp from the generator labels in util.h; do not edit\n");
+    std::printf("\n#include \"generator_tables.h\"\n");
+    std::printf("\nnamespace spark {\n");
+
+    write_entries("F", "", { SparkUtils::hash_generator(LABEL_GENERATOR_F) });
+    write_entries("H", "", { SparkUtils::hash_generator(LABEL_GENERATOR_H) });
+    write_entries("U", "", { SparkUtils::hash_generator(LABEL_GENERATOR_U) });
+    write_vector("G_range", "[GeneratorTables::range_size]", LABEL_GENERATOR_G_RANGE, GeneratorTables::range_size);
+    write_vector("H_range", "[GeneratorTables::range_size]", LABEL_GENERATOR_H_RANGE, GeneratorTables::range_size);
+    write_vector("G_grootle", "[GeneratorTables::grootle_size]", LABEL_GENERATOR_G_GROOTLE, GeneratorTables::grootle_size);
+    write_vector("H_grootle", "[GeneratorTables::grootle_size]", LABEL_GENERATOR_H_GROOTLE, GeneratorTables::grootle_size);
+
+    std::printf("\n}\n");
+    return 0;
+}